@@ -15,6 +15,9 @@
 #include "core_workload.h"
 #include "countdown_latch.h"
 #include "db.h"
+#include "fiber.h"
+#include "offload_pool.h"
+#include "rate_profile.h"
 #include "terminator_thread.h"
 #include "utils.h"
 #include <condition_variable>
@@ -24,10 +27,30 @@ using namespace std::chrono_literals;
 
 namespace ycsbc {
 
+// Runs a client loop on the calling thread, or on as many fibers as it keeps
+// operations outstanding; the fibers share the workload, the DB and the
+// schedule, each taking the next operation as soon as its previous one is
+// done or awaits the backend
+template <typename F>
+void RunTransactions(int outstanding, utils::OffloadPool *offload_pool,
+                     F loop) {
+  if (outstanding <= 1) {
+    loop();
+    return;
+  }
+  utils::FiberScheduler scheduler(offload_pool);
+  for (int i = 0; i < outstanding; i++) {
+    scheduler.Spawn(loop);
+  }
+  scheduler.Run();
+}
+
 void ClientThread(std::chrono::seconds sleepafterload,
                   std::chrono::seconds maxexecutiontime, int threadId,
                   ycsbc::DB *db, ycsbc::CoreWorkload *wl, const long num_ops,
-                  bool load, bool cleanup_db) {
+                  bool load, bool cleanup_db,
+                  const ycsbc::utils::RateProfile *rate_profile,
+                  int outstanding, ycsbc::utils::OffloadPool *offload_pool) {
   try {
     if (sleepafterload > 0s) {
       std::this_thread::sleep_for(sleepafterload);
@@ -48,10 +71,25 @@ void ClientThread(std::chrono::seconds sleepafterload,
       while (!wl->inserts_done()) {
         wl->DoInsert(*db);
       }
+    } else if (rate_profile != nullptr) {
+      // open loop: operations start on schedule and their latency is
+      // measured from then, however long the previous ones took
+      ycsbc::utils::OpenLoopSchedule schedule(*rate_profile);
+      RunTransactions(outstanding, offload_pool, [&] {
+        while (!wl->operations_done()) {
+          auto intended = schedule.Await();
+          if (intended) {
+            db->SetIntendedStart(*intended);
+            wl->DoTransaction(*db);
+          }
+        }
+      });
     } else {
-      while (!wl->operations_done()) {
-        wl->DoTransaction(*db);
-      }
+      RunTransactions(outstanding, offload_pool, [&] {
+        while (!wl->operations_done()) {
+          wl->DoTransaction(*db);
+        }
+      });
     }
 
     if (cleanup_db) {
@@ -15,7 +15,6 @@
 #include <string>
 
 #include "const_generator.h"
-#include "random_byte_generator.h"
 #include "scrambled_zipfian_generator.h"
 #include "skewed_latest_generator.h"
 #include "uniform_generator.h"
@@ -321,31 +320,21 @@ void CoreWorkload::BuildValues(std::vector<ycsbc::DB::Field> &values) {
     values.push_back(DB::Field());
     ycsbc::DB::Field &field = values.back();
     field.name.append(field_prefix_).append(std::to_string(i));
-    uint64_t len = field_len_generator_->Next();
-    field.value.reserve(len);
-    RandomByteGenerator byte_generator;
-    std::generate_n(std::back_inserter(field.value), len,
-                    [&]() { return byte_generator.Next(); });
+    field.value.assign(
+        ValueArena::ForThread().Next(field_len_generator_->Next()));
   }
 }
 
-std::string CoreWorkload::BuildValue(size_t size) {
-  std::string result;
-  RandomByteGenerator byteGenerator;
-  std::generate_n(std::back_inserter(result), size,
-                  [&]() { return byteGenerator.Next(); });
-  return result;
+std::string_view CoreWorkload::BuildValue(size_t size) {
+  return ValueArena::ForThread().Next(size);
 }
 
 void CoreWorkload::BuildSingleValue(std::vector<ycsbc::DB::Field> &values) {
   values.push_back(DB::Field());
   ycsbc::DB::Field &field = values.back();
   field.name.append(NextFieldName());
-  uint64_t len = field_len_generator_->Next();
-  field.value.reserve(len);
-  RandomByteGenerator byte_generator;
-  std::generate_n(std::back_inserter(field.value), len,
-                  [&]() { return byte_generator.Next(); });
+  field.value.assign(
+      ValueArena::ForThread().Next(field_len_generator_->Next()));
 }
 
 uint64_t CoreWorkload::NextTransactionKeyNum() {
@@ -362,12 +351,17 @@ std::string CoreWorkload::NextFieldName() {
 }
 
 bool CoreWorkload::DoInsert(DB &db) {
+  // threads sharing the workload claim inserts, so none goes past the count
+  const size_t insert = inserts_++;
+  if (insert + 1 >= record_count_) {
+    stop_inserts();
+  }
+  if (insert >= record_count_) {
+    return true;
+  }
   const std::string key = BuildKeyName(insert_key_sequence_->Next());
   std::vector<DB::Field> fields;
   BuildSingleValue(fields);
-  if (++inserts_ >= record_count_) {
-    stop_inserts();
-  }
   return db.Insert(table_name_, key, fields) == DB::kOK;
 }
 
@@ -444,11 +438,7 @@ DB::Status CoreWorkload::TransactionReadModifyWrite(DB &db,
                                                     size_t objectSize) {
   std::vector<DB::Field> result;
   db.Read(table_name_, key, NULL, result);
-  std::vector<DB::Field> values;
-  DB::Field field;
-  field.value = BuildValue(objectSize);
-  values.push_back(field);
-  return db.Update(table_name_, key, values);
+  return db.Update(table_name_, key, BuildValue(objectSize));
 }
 
 DB::Status CoreWorkload::TransactionScan(DB &db) {
@@ -479,10 +469,7 @@ DB::Status CoreWorkload::TransactionUpdate(DB &db) {
 
 DB::Status CoreWorkload::TransactionUpdate(DB &db, std::string const &key,
                                            size_t objectSize) {
-  std::vector<DB::Field> values;
-  DB::Field field;
-  field.value = BuildValue(objectSize);
-  return db.Update(table_name_, key, values);
+  return db.Update(table_name_, key, BuildValue(objectSize));
 }
 
 DB::Status CoreWorkload::TransactionInsert(DB &db) {
@@ -497,10 +484,7 @@ DB::Status CoreWorkload::TransactionInsert(DB &db) {
 
 DB::Status CoreWorkload::TransactionInsert(DB &db, std::string const &key,
                                            size_t objectSize) {
-  std::vector<DB::Field> values;
-  DB::Field field;
-  field.value = BuildValue(objectSize);
-  return db.Insert(table_name_, key, values);
+  return db.Insert(table_name_, key, BuildValue(objectSize));
 }
 
 } // namespace ycsbc
@@ -12,6 +12,7 @@
 
 #include <atomic>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <unordered_map>
 #include <vector>
@@ -23,6 +24,7 @@
 #include "generator.h"
 #include "properties.h"
 #include "utils.h"
+#include "value_arena.h"
 
 namespace ycsbc {
 
@@ -254,8 +256,8 @@ protected:
   DB::Status TransactionUpdate(DB &db);
   DB::Status TransactionInsert(DB &db);
 
-  // for productiont traces
-  virtual std::string BuildValue(size_t size);
+  // for productiont traces; the value is a slice of the thread's arena
+  std::string_view BuildValue(size_t size);
   virtual DB::Status TransactionRead(DB &db, std::string const &key);
   DB::Status TransactionReadModifyWrite(DB &db, std::string const &key,
                                         size_t objectSize);
@@ -283,8 +285,9 @@ protected:
   bool ordered_inserts_;
   size_t record_count_{0};
   size_t operation_count_{0};
-  size_t ops_{0};
-  size_t inserts_{0};
+  // shared by the threads of a tenant
+  std::atomic<size_t> ops_{0};
+  std::atomic<size_t> inserts_{0};
   long zero_padding_;
 
   std::atomic_bool inserts_done_ = {false};
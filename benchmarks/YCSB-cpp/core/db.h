@@ -9,7 +9,11 @@
 #ifndef YCSB_C_DB_H_
 #define YCSB_C_DB_H_
 
+#include <chrono>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include "properties.h"
@@ -87,6 +91,36 @@ public:
   virtual Status Insert(const std::string &table, const std::string &key,
                         std::vector<Field> &values) = 0;
   ///
+  /// Updates a record made of a single unnamed field, as written by trace
+  /// replay, without materializing its value.
+  ///
+  /// @param table The name of the table.
+  /// @param key The key of the record to write.
+  /// @param value The new value of the record.
+  /// @return Zero on success, a non-zero error code on error.
+  ///
+  virtual Status Update(const std::string &table, const std::string &key,
+                        std::string_view value) {
+    std::vector<Field> values(1);
+    values.front().value.assign(value);
+    return Update(table, key, values);
+  }
+  ///
+  /// Inserts a record made of a single unnamed field without materializing
+  /// its value.
+  ///
+  /// @param table The name of the table.
+  /// @param key The key of the record to insert.
+  /// @param value The value of the record.
+  /// @return Zero on success, a non-zero error code on error.
+  ///
+  virtual Status Insert(const std::string &table, const std::string &key,
+                        std::string_view value) {
+    std::vector<Field> values(1);
+    values.front().value.assign(value);
+    return Insert(table, key, values);
+  }
+  ///
   /// Deletes a record from the database.
   ///
   /// @param table The name of the table.
@@ -95,12 +129,26 @@ public:
   ///
   virtual Status Delete(const std::string &table, const std::string &key) = 0;
 
+  ///
+  /// Sets the time the next operation was intended to start, from which its
+  /// latency is measured instead of from when it is issued (open-loop
+  /// replay). Ignored by databases that do not measure latency.
+  ///
+  /// @param t The intended start time of the next operation.
+  ///
+  virtual void SetIntendedStart(std::chrono::steady_clock::time_point t) {}
+
   //
   //
   virtual std::tuple<std::string, std::string, uint64_t, uint64_t, uint64_t,
                      uint64_t>
   OccupancyCapacityAndGlobal() = 0;
 
+  ///
+  /// Cumulative hits and misses of the DB's cache, if it has one.
+  ///
+  virtual std::pair<uint64_t, uint64_t> HitsAndMisses() { return {0, 0}; }
+
   virtual ~DB() {}
 
   void SetProps(utils::Properties *props) { props_ = props; }
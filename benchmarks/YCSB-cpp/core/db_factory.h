@@ -23,7 +23,7 @@ public:
   using DBCreator = DB *(*)(int);
   static bool RegisterDB(std::string db_name, DBCreator db_creator);
   static DB *CreateDB(utils::Properties *props, Measurements *measurements,
-                      Measurements *gMeasurements, int threadId);
+                      int threadId);
 
 private:
   static std::map<std::string, DBCreator> &Registry();
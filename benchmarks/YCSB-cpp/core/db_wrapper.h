@@ -8,6 +8,7 @@
 #ifndef YCSB_C_DB_WRAPPER_H_
 #define YCSB_C_DB_WRAPPER_H_
 
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -20,100 +21,59 @@ namespace ycsbc {
 
 class DBWrapper : public DB {
 public:
-  DBWrapper(DB *db, Measurements *measurements, Measurements *gMeasurements)
-      : db_(db), measurements_(measurements), gMeasurements_(gMeasurements) {}
+  DBWrapper(DB *db, Measurements *measurements)
+      : db_(db), measurements_(measurements) {}
   ~DBWrapper() { delete db_; }
   void Init() { db_->Init(); }
   void Cleanup() { db_->Cleanup(); }
   Status Read(const std::string &table, const std::string &key,
               const std::vector<std::string> *fields,
               std::vector<Field> &result) {
-    timer_.Start();
+    auto timer = StartTimer();
     Status s = db_->Read(table, key, fields, result);
-    uint64_t elapsed = timer_.End();
-    if (s == kOK) {
-      measurements_->Report(READ_PASSED, elapsed);
-      gMeasurements_->Report(READ_PASSED, elapsed);
-    } else {
-      measurements_->Report(READ_FAILED, elapsed);
-      gMeasurements_->Report(READ_FAILED, elapsed);
-    }
-    measurements_->Report(READ, elapsed);
-    gMeasurements_->Report(READ, elapsed);
-    measurements_->Report(ALL, elapsed);
-    gMeasurements_->Report(ALL, elapsed);
+    measurements_->Report(READ, s == kOK, timer.End());
     return s;
   }
   Status Scan(const std::string &table, const std::string &key,
               long record_count, const std::vector<std::string> *fields,
               std::vector<std::vector<Field>> &result) {
-    timer_.Start();
+    auto timer = StartTimer();
     Status s = db_->Scan(table, key, record_count, fields, result);
-    uint64_t elapsed = timer_.End();
-    if (s == kOK) {
-      measurements_->Report(SCAN_PASSED, elapsed);
-      gMeasurements_->Report(SCAN_PASSED, elapsed);
-    } else {
-      measurements_->Report(SCAN_FAILED, elapsed);
-      gMeasurements_->Report(SCAN_FAILED, elapsed);
-    }
-    measurements_->Report(SCAN, elapsed);
-    gMeasurements_->Report(SCAN, elapsed);
-    measurements_->Report(ALL, elapsed);
-    gMeasurements_->Report(ALL, elapsed);
+    measurements_->Report(SCAN, s == kOK, timer.End());
     return s;
   }
   Status Update(const std::string &table, const std::string &key,
                 std::vector<Field> &values) {
-    timer_.Start();
+    auto timer = StartTimer();
     Status s = db_->Update(table, key, values);
-    uint64_t elapsed = timer_.End();
-    if (s == kOK) {
-      measurements_->Report(UPDATE_PASSED, elapsed);
-      gMeasurements_->Report(UPDATE_PASSED, elapsed);
-    } else {
-      measurements_->Report(UPDATE_FAILED, elapsed);
-      gMeasurements_->Report(UPDATE_FAILED, elapsed);
-    }
-    measurements_->Report(UPDATE, elapsed);
-    gMeasurements_->Report(UPDATE, elapsed);
-    measurements_->Report(ALL, elapsed);
-    gMeasurements_->Report(ALL, elapsed);
+    measurements_->Report(UPDATE, s == kOK, timer.End());
     return s;
   }
   Status Insert(const std::string &table, const std::string &key,
                 std::vector<Field> &values) {
-    timer_.Start();
+    auto timer = StartTimer();
     Status s = db_->Insert(table, key, values);
-    uint64_t elapsed = timer_.End();
-    if (s == kOK) {
-      measurements_->Report(INSERT_PASSED, elapsed);
-      gMeasurements_->Report(INSERT_PASSED, elapsed);
-    } else {
-      measurements_->Report(INSERT_FAILED, elapsed);
-      gMeasurements_->Report(INSERT_FAILED, elapsed);
-    }
-    measurements_->Report(INSERT, elapsed);
-    gMeasurements_->Report(INSERT, elapsed);
-    measurements_->Report(ALL, elapsed);
-    gMeasurements_->Report(ALL, elapsed);
+    measurements_->Report(INSERT, s == kOK, timer.End());
+    return s;
+  }
+  Status Update(const std::string &table, const std::string &key,
+                std::string_view value) {
+    auto timer = StartTimer();
+    Status s = db_->Update(table, key, value);
+    measurements_->Report(UPDATE, s == kOK, timer.End());
+    return s;
+  }
+  Status Insert(const std::string &table, const std::string &key,
+                std::string_view value) {
+    auto timer = StartTimer();
+    Status s = db_->Insert(table, key, value);
+    measurements_->Report(INSERT, s == kOK, timer.End());
     return s;
   }
   Status Delete(const std::string &table, const std::string &key) {
-    timer_.Start();
+    auto timer = StartTimer();
     Status s = db_->Delete(table, key);
-    uint64_t elapsed = timer_.End();
-    if (s == kOK) {
-      measurements_->Report(DELETE_PASSED, elapsed);
-      gMeasurements_->Report(DELETE_PASSED, elapsed);
-    } else {
-      measurements_->Report(DELETE_FAILED, elapsed);
-      gMeasurements_->Report(DELETE_FAILED, elapsed);
-    }
-    measurements_->Report(DELETE, elapsed);
-    gMeasurements_->Report(DELETE, elapsed);
-    measurements_->Report(ALL, elapsed);
-    gMeasurements_->Report(ALL, elapsed);
+    measurements_->Report(DELETE, s == kOK, timer.End());
     return s;
   }
 
@@ -122,11 +82,34 @@ public:
     return db_->OccupancyCapacityAndGlobal();
   }
 
+  std::pair<uint64_t, uint64_t> HitsAndMisses() {
+    return db_->HitsAndMisses();
+  }
+
+  void SetIntendedStart(std::chrono::steady_clock::time_point t) {
+    intended_start_ = t;
+  }
+
 private:
+  using Timer = utils::Timer<uint64_t, std::nano>;
+
+  // times the next operation from its intended start, if one was set, so
+  // that the time it spent queued behind late operations is accounted for;
+  // each operation has its own timer, as fibers interleave operations
+  Timer StartTimer() {
+    Timer timer;
+    if (intended_start_) {
+      timer.Start(*intended_start_);
+      intended_start_.reset();
+    } else {
+      timer.Start();
+    }
+    return timer;
+  }
+
   DB *db_;
   Measurements *measurements_;
-  Measurements *gMeasurements_;
-  utils::Timer<uint64_t, std::nano> timer_;
+  std::optional<std::chrono::steady_clock::time_point> intended_start_;
 };
 
 } // namespace ycsbc
@@ -0,0 +1,207 @@
+//
+//  fiber.h
+//  YCSB-cpp
+//
+//  Cooperative fibers multiplexed on one client thread, so that a thread
+//  keeps several operations outstanding. A fiber runs until it awaits an
+//  offloaded call (see offload_pool.h) or sleeps, and the scheduler then
+//  resumes another one; the thread itself blocks only when every fiber is
+//  waiting. Fibers of a thread never run in parallel, so they share the
+//  thread's workload, DB and measurements without synchronization.
+//
+
+#ifndef YCSB_C_FIBER_H_
+#define YCSB_C_FIBER_H_
+
+#include <ucontext.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ycsbc {
+
+namespace utils {
+
+class OffloadPool;
+
+class FiberScheduler {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr size_t kDefaultStackSize = 256 << 10;
+
+  explicit FiberScheduler(OffloadPool *offload_pool = nullptr,
+                          size_t stack_size = kDefaultStackSize)
+      : offload_pool_(offload_pool), stack_size_(stack_size) {}
+
+  ~FiberScheduler() {
+    // waits for a pending Complete to release the lock
+    std::lock_guard<std::mutex> lock(mutex_);
+  }
+
+  FiberScheduler(const FiberScheduler &) = delete;
+  FiberScheduler &operator=(const FiberScheduler &) = delete;
+
+  void Spawn(std::function<void()> fn) {
+    auto fiber = std::make_unique<Fiber>();
+    fiber->fn = std::move(fn);
+    fiber->index = fibers_.size();
+    fiber->stack.reset(new char[stack_size_]);
+    getcontext(&fiber->context);
+    fiber->context.uc_stack.ss_sp = fiber->stack.get();
+    fiber->context.uc_stack.ss_size = stack_size_;
+    fiber->context.uc_link = &context_;
+    makecontext(&fiber->context, &FiberScheduler::Entry, 0);
+    fibers_.push_back(std::move(fiber));
+  }
+
+  // Runs the fibers until all of them return; an exception escaping a fiber
+  // is rethrown here (the other fibers are then abandoned)
+  void Run() {
+    FiberScheduler *outer = current_;
+    current_ = this;
+    size_t live = fibers_.size();
+    while (live > 0) {
+      bool ran = false;
+      Clock::time_point wake = Clock::time_point::max();
+      Clock::time_point now = Clock::now();
+      for (auto &fiber : fibers_) {
+        if (fiber->finished) {
+          continue;
+        }
+        if (fiber->awaiting != nullptr &&
+            !fiber->awaiting->load(std::memory_order_acquire)) {
+          continue;
+        }
+        if (fiber->wake > now) {
+          wake = std::min(wake, fiber->wake);
+          continue;
+        }
+        fiber->awaiting = nullptr;
+        fiber->wake = Clock::time_point::min();
+        running_ = fiber.get();
+        swapcontext(&context_, &fiber->context);
+        running_ = nullptr;
+        ran = true;
+        if (fiber->error) {
+          current_ = outer;
+          std::rethrow_exception(fiber->error);
+        }
+        if (fiber->finished) {
+          --live;
+        }
+      }
+      if (!ran && live > 0) {
+        // every fiber waits: sleep until one is woken up or due
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (wake == Clock::time_point::max()) {
+          cv_.wait(lock, [this] { return notified_; });
+        } else {
+          cv_.wait_until(lock, wake, [this] { return notified_; });
+        }
+        notified_ = false;
+      }
+    }
+    current_ = outer;
+  }
+
+  // Suspends the running fiber until done is set by Complete
+  void Await(const std::atomic<bool> &done) {
+    if (!done.load(std::memory_order_acquire)) {
+      running_->awaiting = &done;
+      Yield();
+    }
+  }
+
+  // Suspends the running fiber until t
+  void SleepUntil(Clock::time_point t) {
+    running_->wake = t;
+    Yield();
+  }
+
+  // Sets an awaited flag and wakes the scheduler up (from any thread); done
+  // may be gone as soon as it is set, and the scheduler once unlocked
+  void Complete(std::atomic<bool> &done) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    done.store(true, std::memory_order_release);
+    notified_ = true;
+    cv_.notify_one();
+  }
+
+  OffloadPool *offload_pool() const { return offload_pool_; }
+
+  // Scheduler of the fiber running on this thread, if any
+  static FiberScheduler *Current() {
+    return current_ != nullptr && current_->running_ != nullptr ? current_
+                                                                : nullptr;
+  }
+
+  // Index of the fiber running on this thread, or 0 outside fibers
+  static size_t CurrentIndex() {
+    FiberScheduler *scheduler = Current();
+    return scheduler != nullptr ? scheduler->running_->index : 0;
+  }
+
+ private:
+  struct Fiber {
+    ucontext_t context;
+    std::unique_ptr<char[]> stack;
+    std::function<void()> fn;
+    size_t index;
+    const std::atomic<bool> *awaiting{nullptr};
+    Clock::time_point wake{Clock::time_point::min()};
+    bool finished{false};
+    std::exception_ptr error;
+  };
+
+  static void Entry() {
+    Fiber *fiber = current_->running_;
+    try {
+      fiber->fn();
+    } catch (...) {
+      fiber->error = std::current_exception();
+    }
+    fiber->finished = true;
+    // returns to the scheduler through uc_link
+  }
+
+  void Yield() {
+    Fiber *fiber = running_;
+    swapcontext(&fiber->context, &context_);
+  }
+
+  static inline thread_local FiberScheduler *current_ = nullptr;
+
+  OffloadPool *offload_pool_;
+  size_t stack_size_;
+  std::vector<std::unique_ptr<Fiber>> fibers_;
+  Fiber *running_{nullptr};
+  ucontext_t context_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool notified_{false};
+};
+
+// Sleeps until t, letting the other fibers of the thread run meanwhile
+inline void SleepUntil(FiberScheduler::Clock::time_point t) {
+  if (FiberScheduler *scheduler = FiberScheduler::Current()) {
+    scheduler->SleepUntil(t);
+  } else {
+    std::this_thread::sleep_until(t);
+  }
+}
+
+} // utils
+
+} // ycsbc
+
+#endif // YCSB_C_FIBER_H_
@@ -7,6 +7,7 @@
 
 #include "measurements.h"
 
+#include <algorithm>
 #include <limits>
 #include <numeric>
 #include <sstream>
@@ -24,27 +25,60 @@ const std::string MEASUREMENT_TYPE_DEFAULT = "basic";
 
 namespace ycsbc {
 
-BasicMeasurements::BasicMeasurements()
-    : count_{}, latency_sum_{}, latency_max_{} {
-  std::fill(std::begin(latency_min_), std::end(latency_min_),
-            std::numeric_limits<uint64_t>::max());
+BasicMeasurements::BasicMeasurements() {}
+
+void BasicMeasurements::Stats::Add(uint64_t latency) {
+  count++;
+  latency_sum += latency;
+  latency_min = std::min(latency_min, latency);
+  latency_max = std::max(latency_max, latency);
+}
+
+void BasicMeasurements::Stats::Merge(const Stats &other) {
+  count += other.count;
+  latency_sum += other.latency_sum;
+  latency_min = std::min(latency_min, other.latency_min);
+  latency_max = std::max(latency_max, other.latency_max);
+}
+
+void BasicMeasurements::Report(Operation op, bool passed, uint64_t latency) {
+  int64_t critical_value = phaser_.WriterEnter();
+  auto &stats = interval_[active_.load(std::memory_order_acquire)];
+  stats[op].Add(latency);
+  stats[Outcome(op, passed)].Add(latency);
+  stats[ALL].Add(latency);
+  phaser_.WriterExit(critical_value);
+}
+
+void BasicMeasurements::Sample() {
+  int sampled = active_.load(std::memory_order_relaxed);
+  interval_[1 - sampled].fill(Stats());
+  active_.store(1 - sampled, std::memory_order_release);
+  phaser_.FlipPhase();
+  for (int op = 0; op < MAXOPTYPE; op++) {
+    total_[op].Merge(interval_[sampled][op]);
+  }
+  sampled_ = sampled;
+}
+
+void BasicMeasurements::Merge(const Measurements &other) {
+  const auto &basic = dynamic_cast<const BasicMeasurements &>(other);
+  for (int op = 0; op < MAXOPTYPE; op++) {
+    total_[op].Merge(basic.total_[op]);
+    interval_[sampled_][op].Merge(basic.interval_[basic.sampled_][op]);
+  }
 }
 
-void BasicMeasurements::Report(Operation op, uint64_t latency) {
-  count_[op].fetch_add(1, std::memory_order_relaxed);
-  latency_sum_[op].fetch_add(latency, std::memory_order_relaxed);
-  {
-    uint64_t prev_min = latency_min_[op].load(std::memory_order_relaxed);
-    while (prev_min > latency &&
-           !latency_min_[op].compare_exchange_weak(prev_min, latency,
-                                                   std::memory_order_relaxed))
-      ;
-    uint64_t prev_max = latency_max_[op].load(std::memory_order_relaxed);
-    while (prev_max < latency &&
-           !latency_max_[op].compare_exchange_weak(prev_max, latency,
-                                                   std::memory_order_relaxed))
-      ;
+Measurements::Summary BasicMeasurements::GetIntervalSummary(Operation op) {
+  const Stats &stats = interval_[sampled_][op];
+  Summary summary;
+  summary.count = stats.count;
+  if (stats.count > 0) {
+    summary.mean = static_cast<double>(stats.latency_sum) / stats.count / 1000;
+    summary.min = stats.latency_min / 1000.0;
+    summary.max = stats.latency_max / 1000.0;
   }
+  return summary;
 }
 
 std::string
@@ -54,31 +88,24 @@ BasicMeasurements::GetStatusMsg(std::vector<Operation> const &operations) {
   msg_stream << std::fixed << " operations;";
   for (auto const &o : operations) {
     Operation op = static_cast<Operation>(o);
-    uint64_t cnt = count_[op].load(std::memory_order_relaxed);
+    const Stats &stats = total_[op];
     msg_stream << " [" << kOperationString[op] << ":"
-               << " Count=" << cnt << " Max="
-               << latency_max_[op].load(std::memory_order_relaxed) / 1000.0
-               << " Min="
-               << latency_min_[op].load(std::memory_order_relaxed) / 1000.0
-               << " Avg="
-               << ((cnt > 0) ? static_cast<double>(latency_sum_[op].load(
-                                   std::memory_order_relaxed)) /
-                                   cnt
-                             : 0) /
+               << " Count=" << stats.count
+               << " Max=" << stats.latency_max / 1000.0
+               << " Min=" << stats.latency_min / 1000.0 << " Avg="
+               << ((stats.count > 0)
+                       ? static_cast<double>(stats.latency_sum) / stats.count
+                       : 0) /
                       1000.0
                << "]";
   }
-  return std::to_string(
-             count_[Operation::ALL].load(std::memory_order_relaxed)) +
-         msg_stream.str();
+  return std::to_string(total_[Operation::ALL].count) + msg_stream.str();
 }
 
 void BasicMeasurements::Reset() {
-  std::fill(std::begin(count_), std::end(count_), 0);
-  std::fill(std::begin(latency_sum_), std::end(latency_sum_), 0);
-  std::fill(std::begin(latency_min_), std::end(latency_min_),
-            std::numeric_limits<uint64_t>::max());
-  std::fill(std::begin(latency_max_), std::end(latency_max_), 0);
+  for (auto &stats : {&interval_[0], &interval_[1], &total_}) {
+    stats->fill(Stats());
+  }
 }
 
 std::string BasicMeasurements::GetMean() {
@@ -86,11 +113,10 @@ std::string BasicMeasurements::GetMean() {
   msg_stream.precision(6);
   msg_stream << "Mean latencies (ms):";
   for (int op = 0; op < MAXOPTYPE; op++) {
-    uint64_t cnt = count_[op].load(std::memory_order_relaxed);
-    double mean = (cnt > 0) ? static_cast<double>(latency_sum_[op].load(
-                                  std::memory_order_relaxed)) /
-                                  cnt
-                            : 0;
+    const Stats &stats = total_[op];
+    double mean = (stats.count > 0)
+                      ? static_cast<double>(stats.latency_sum) / stats.count
+                      : 0;
     msg_stream << " [" << kOperationString[static_cast<Operation>(op)] << ":"
                << mean / 1000.0 << "]";
   }
@@ -100,14 +126,109 @@ std::string BasicMeasurements::GetMean() {
 #ifdef HDRMEASUREMENT
 HdrHistogramMeasurements::HdrHistogramMeasurements() {
   for (int op = 0; op < MAXOPTYPE; op++) {
-    if (hdr_init(10, 100LL * 1000 * 1000 * 1000, 3, &histogram_[op]) != 0) {
-      utils::Exception("hdr init failed");
+    interval_[0][op] = NewHistogram();
+    interval_[1][op] = NewHistogram();
+    histogram_[op] = NewHistogram();
+  }
+}
+
+HdrHistogramMeasurements::~HdrHistogramMeasurements() {
+  for (int op = 0; op < MAXOPTYPE; op++) {
+    hdr_close(interval_[0][op]);
+    hdr_close(interval_[1][op]);
+    hdr_close(histogram_[op]);
+  }
+}
+
+hdr_histogram *HdrHistogramMeasurements::NewHistogram() {
+  hdr_histogram *histogram;
+  if (hdr_init(10, 100LL * 1000 * 1000 * 1000, 3, &histogram) != 0) {
+    throw utils::Exception("hdr init failed");
+  }
+  return histogram;
+}
+
+void HdrHistogramMeasurements::Report(Operation op, bool passed,
+                                      uint64_t latency) {
+  int64_t critical_value = phaser_.WriterEnter();
+  hdr_histogram **histograms =
+      interval_[active_.load(std::memory_order_acquire)];
+  hdr_record_value(histograms[op], latency);
+  hdr_record_value(histograms[Outcome(op, passed)], latency);
+  hdr_record_value(histograms[ALL], latency);
+  phaser_.WriterExit(critical_value);
+}
+
+void HdrHistogramMeasurements::Sample() {
+  int sampled = active_.load(std::memory_order_relaxed);
+  for (int op = 0; op < MAXOPTYPE; op++) {
+    if (interval_[1 - sampled][op]->total_count > 0) {
+      hdr_reset(interval_[1 - sampled][op]);
+    }
+  }
+  active_.store(1 - sampled, std::memory_order_release);
+  phaser_.FlipPhase();
+  for (int op = 0; op < MAXOPTYPE; op++) {
+    if (interval_[sampled][op]->total_count > 0) {
+      hdr_add(histogram_[op], interval_[sampled][op]);
+    }
+  }
+  sampled_ = sampled;
+}
+
+void HdrHistogramMeasurements::Merge(const Measurements &other) {
+  const auto &hdr = dynamic_cast<const HdrHistogramMeasurements &>(other);
+  for (int op = 0; op < MAXOPTYPE; op++) {
+    if (hdr.histogram_[op]->total_count > 0) {
+      hdr_add(histogram_[op], hdr.histogram_[op]);
+    }
+    if (hdr.interval_[hdr.sampled_][op]->total_count > 0) {
+      hdr_add(interval_[sampled_][op], hdr.interval_[hdr.sampled_][op]);
     }
   }
 }
 
-void HdrHistogramMeasurements::Report(Operation op, uint64_t latency) {
-  hdr_record_value_atomic(histogram_[op], latency);
+Measurements::Summary
+HdrHistogramMeasurements::GetIntervalSummary(Operation op) {
+  const hdr_histogram *histogram = interval_[sampled_][op];
+  Summary summary;
+  summary.count = histogram->total_count;
+  if (summary.count > 0) {
+    summary.mean = hdr_mean(histogram) / 1000.0;
+    summary.min = hdr_min(histogram) / 1000.0;
+    summary.max = hdr_max(histogram) / 1000.0;
+    summary.percentiles.emplace();
+    for (size_t i = 0; i < kPercentiles.size(); i++) {
+      (*summary.percentiles)[i] =
+          hdr_value_at_percentile(histogram, kPercentiles[i]) / 1000.0;
+    }
+  }
+  return summary;
+}
+
+static hdr_timespec ToTimespec(std::chrono::system_clock::time_point t) {
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                t.time_since_epoch())
+                .count();
+  hdr_timespec ts;
+  ts.tv_sec = ns / 1000000000;
+  ts.tv_nsec = ns % 1000000000;
+  return ts;
+}
+
+bool HdrHistogramMeasurements::WriteIntervalLog(
+    std::FILE *log, std::chrono::system_clock::time_point start,
+    std::chrono::system_clock::time_point end) {
+  hdr_timespec start_ts = ToTimespec(start);
+  hdr_timespec end_ts = ToTimespec(end);
+  if (!log_started_) {
+    hdr_log_writer_init(&log_writer_);
+    hdr_log_write_header(&log_writer_, log, "YCSB-cpp latencies (ns)",
+                         &start_ts);
+    log_started_ = true;
+  }
+  return hdr_log_write(&log_writer_, log, &start_ts, &end_ts,
+                       interval_[sampled_][ALL]) == 0;
 }
 
 std::string HdrHistogramMeasurements::GetStatusMsg(
@@ -159,6 +280,8 @@ std::string HdrHistogramMeasurements::GetCDF() {
 
 void HdrHistogramMeasurements::Reset() {
   for (int op = 0; op < MAXOPTYPE; op++) {
+    hdr_reset(interval_[0][op]);
+    hdr_reset(interval_[1][op]);
     hdr_reset(histogram_[op]);
   }
 }
@@ -8,57 +8,136 @@
 #ifndef YCSB_C_MEASUREMENTS_H_
 #define YCSB_C_MEASUREMENTS_H_
 
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <optional>
 
 #include "core_workload.h"
 #include "properties.h"
+#include "writer_reader_phaser.h"
 
 #ifdef HDRMEASUREMENT
 #include <hdr/hdr_histogram.h>
+#include <hdr/hdr_histogram_log.h>
 #endif
 
 typedef unsigned int uint;
 
 namespace ycsbc {
 
+//
+// Latency measurements of one client thread, or the merge of several.
+// Reports come from the owning thread only and go to one of two interval
+// buffers; Sample flips the buffers under a writer-reader phaser and adds
+// the quiescent one to the totals, so the owner never contends with other
+// threads and each sample is a consistent snapshot. Sample, Merge and the
+// getters, which read the totals or the last sampled interval, are called
+// by one thread at a time.
+//
 class Measurements {
 public:
-  virtual void Report(Operation op, uint64_t latency) = 0;
+  static constexpr std::array<double, 4> kPercentiles = {50, 90, 99, 99.9};
+
+  // latencies (us) of an operation type
+  struct Summary {
+    uint64_t count{0};
+    double mean{0};
+    double min{0};
+    double max{0};
+    // at kPercentiles, if a histogram is kept
+    std::optional<std::array<double, kPercentiles.size()>> percentiles;
+  };
+
+  virtual ~Measurements() {}
+  // reports an operation under its own type, its outcome's and ALL
+  virtual void Report(Operation op, bool passed, uint64_t latency) = 0;
+  virtual void Sample() = 0;
+  // adds the totals and last interval of other (of the same type) to these
+  virtual void Merge(const Measurements &other) = 0;
+  virtual Summary GetIntervalSummary(Operation op) = 0;
+  // appends the last interval of ALL operations to an HdrHistogram interval
+  // log; returns false if no histogram is kept
+  virtual bool WriteIntervalLog(std::FILE *log,
+                                std::chrono::system_clock::time_point start,
+                                std::chrono::system_clock::time_point end) {
+    return false;
+  }
   virtual std::string
   GetStatusMsg(std::vector<Operation> const &operations) = 0;
   virtual std::string GetCDF() = 0;
   virtual std::string GetMean() = 0;
+  // clears all measurements, while no operation is reported
   virtual void Reset() = 0;
+
+protected:
+  static Operation Outcome(Operation op, bool passed) {
+    return static_cast<Operation>(op +
+                                  (passed ? INSERT_PASSED : INSERT_FAILED));
+  }
 };
 
 class BasicMeasurements : public Measurements {
 public:
   BasicMeasurements();
-  void Report(Operation op, uint64_t latency) override;
+  void Report(Operation op, bool passed, uint64_t latency) override;
+  void Sample() override;
+  void Merge(const Measurements &other) override;
+  Summary GetIntervalSummary(Operation op) override;
   std::string GetStatusMsg(std::vector<Operation> const &operations) override;
   std::string GetCDF() override { return ""; }
   void Reset() override;
   std::string GetMean() override;
 
 private:
-  std::atomic<uint> count_[MAXOPTYPE];
-  std::atomic<uint64_t> latency_sum_[MAXOPTYPE];
-  std::atomic<uint64_t> latency_min_[MAXOPTYPE];
-  std::atomic<uint64_t> latency_max_[MAXOPTYPE];
+  struct Stats {
+    uint64_t count{0};
+    uint64_t latency_sum{0};
+    uint64_t latency_min{std::numeric_limits<uint64_t>::max()};
+    uint64_t latency_max{0};
+
+    void Add(uint64_t latency);
+    void Merge(const Stats &other);
+  };
+
+  WriterReaderPhaser phaser_;
+  std::atomic<int> active_{0};
+  // the interval buffer not active holds the last sampled interval
+  int sampled_{1};
+  std::array<Stats, MAXOPTYPE> interval_[2];
+  std::array<Stats, MAXOPTYPE> total_;
 };
 
 #ifdef HDRMEASUREMENT
 class HdrHistogramMeasurements : public Measurements {
 public:
   HdrHistogramMeasurements();
-  void Report(Operation op, uint64_t latency) override;
+  ~HdrHistogramMeasurements();
+  void Report(Operation op, bool passed, uint64_t latency) override;
+  void Sample() override;
+  void Merge(const Measurements &other) override;
+  Summary GetIntervalSummary(Operation op) override;
+  bool WriteIntervalLog(std::FILE *log,
+                        std::chrono::system_clock::time_point start,
+                        std::chrono::system_clock::time_point end) override;
   std::string GetStatusMsg(std::vector<Operation> const &operations) override;
   std::string GetCDF() override;
   void Reset() override;
   std::string GetMean() override { return ""; }
 
 private:
+  static hdr_histogram *NewHistogram();
+
+  WriterReaderPhaser phaser_;
+  std::atomic<int> active_{0};
+  // the interval buffer not active holds the last sampled interval
+  int sampled_{1};
+  hdr_histogram *interval_[2][MAXOPTYPE];
   hdr_histogram *histogram_[MAXOPTYPE];
+  hdr_log_writer log_writer_;
+  bool log_started_{false};
 };
 #endif
 
@@ -0,0 +1,120 @@
+//
+//  offload_pool.h
+//  YCSB-cpp
+//
+//  Threads running the blocking backend calls of DBs on behalf of client
+//  fibers, so that a client thread overlaps the backend reads of its
+//  outstanding operations (e.g., cache misses going to RocksDB).
+//
+
+#ifndef YCSB_C_OFFLOAD_POOL_H_
+#define YCSB_C_OFFLOAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "fiber.h"
+
+namespace ycsbc {
+
+namespace utils {
+
+class OffloadPool {
+ public:
+  explicit OffloadPool(size_t threads) {
+    for (size_t i = 0; i < threads; i++) {
+      threads_.emplace_back([this] { Work(); });
+    }
+  }
+
+  ~OffloadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto &thread : threads_) {
+      thread.join();
+    }
+  }
+
+  void Submit(std::function<void()> task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+  }
+
+ private:
+  void Work() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        return;
+      }
+      auto task = std::move(tasks_.front());
+      tasks_.pop_front();
+      lock.unlock();
+      task();
+      lock.lock();
+    }
+  }
+
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> tasks_;
+  bool stop_{false};
+};
+
+//
+// Runs a blocking call. On a fiber whose scheduler has an offload pool, the
+// call runs on the pool while the fiber is suspended; anywhere else it runs
+// inline. Exceptions are rethrown on the calling fiber.
+//
+template <typename F> auto Offload(F &&fn) -> decltype(fn()) {
+  using Result = decltype(fn());
+  FiberScheduler *scheduler = FiberScheduler::Current();
+  if (scheduler == nullptr || scheduler->offload_pool() == nullptr) {
+    return fn();
+  }
+
+  std::atomic<bool> done{false};
+  std::exception_ptr error;
+  std::conditional_t<std::is_void_v<Result>, bool, std::optional<Result>>
+      result;
+  scheduler->offload_pool()->Submit([&, scheduler] {
+    try {
+      if constexpr (std::is_void_v<Result>) {
+        fn();
+      } else {
+        result.emplace(fn());
+      }
+    } catch (...) {
+      error = std::current_exception();
+    }
+    scheduler->Complete(done);
+  });
+  scheduler->Await(done);
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  if constexpr (!std::is_void_v<Result>) {
+    return std::move(*result);
+  }
+}
+
+} // utils
+
+} // ycsbc
+
+#endif // YCSB_C_OFFLOAD_POOL_H_
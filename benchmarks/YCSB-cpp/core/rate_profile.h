@@ -0,0 +1,214 @@
+//
+//  rate_profile.h
+//  YCSB-cpp
+//
+//  Offered load of an open-loop client: a target rate, possibly varying over
+//  time, and the schedule of intended start times that follows from it.
+//
+
+#ifndef YCSB_C_RATE_PROFILE_H_
+#define YCSB_C_RATE_PROFILE_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "fiber.h"
+#include "utils.h"
+
+namespace ycsbc {
+
+namespace utils {
+
+//
+// Target rate (ops/sec) as a function of the time since the run started.
+// Profiles, applied to a base rate:
+//
+//   constant                 the base rate
+//   step:<sec>:<rate>        the base rate, then <rate> from <sec> on
+//   ramp:<sec>:<rate>        linear from the base rate to <rate> over <sec>,
+//                            then <rate>
+//   sine:<sec>:<amplitude>   base rate + amplitude * sin(2 pi t / <sec>)
+//   file:<path>              piecewise linear through the "<sec> <rate>"
+//                            lines of <path> ('#' starts a comment), holding
+//                            the first and last rates outside them
+//
+class RateProfile {
+ public:
+  RateProfile(double rate, const std::string &spec) : base_(rate) {
+    std::vector<std::string> args;
+    std::stringstream ss(spec);
+    std::string arg;
+    while (std::getline(ss, arg, ':')) {
+      args.push_back(Trim(arg));
+    }
+    if (args.empty() || args[0] == "constant") {
+      kind_ = kConstant;
+      return;
+    }
+    if (args[0] == "file" && args.size() >= 2) {
+      // the path may itself contain ':'
+      LoadPoints(spec.substr(spec.find(':') + 1));
+      kind_ = kPiecewise;
+      return;
+    }
+    if (args.size() != 3) {
+      throw Exception("Invalid rate profile: " + spec);
+    }
+    if (args[0] == "step") {
+      kind_ = kStep;
+    } else if (args[0] == "ramp") {
+      kind_ = kRamp;
+    } else if (args[0] == "sine") {
+      kind_ = kSine;
+    } else {
+      throw Exception("Unknown rate profile: " + spec);
+    }
+    seconds_ = std::stod(args[1]);
+    value_ = std::stod(args[2]);
+    if (seconds_ <= 0 && kind_ != kStep) {
+      throw Exception("Rate profile period must be positive: " + spec);
+    }
+  }
+
+  // Scales every rate of the profile, e.g. to split it among threads
+  void Scale(double factor) {
+    base_ *= factor;
+    if (kind_ != kConstant) {
+      value_ *= factor;
+    }
+    for (auto &point : points_) {
+      point.second *= factor;
+    }
+  }
+
+  // target rate t seconds into the run, never negative
+  double Rate(double t) const {
+    double rate = base_;
+    switch (kind_) {
+    case kConstant:
+      break;
+    case kStep:
+      rate = t < seconds_ ? base_ : value_;
+      break;
+    case kRamp:
+      rate = base_ + (value_ - base_) * std::min(1.0, t / seconds_);
+      break;
+    case kSine:
+      rate = base_ + value_ * std::sin(2 * M_PI * t / seconds_);
+      break;
+    case kPiecewise: {
+      auto next = std::upper_bound(
+          points_.begin(), points_.end(), t,
+          [](double time, const std::pair<double, double> &point) {
+            return time < point.first;
+          });
+      if (next == points_.begin()) {
+        rate = next->second;
+      } else if (next == points_.end()) {
+        rate = points_.back().second;
+      } else {
+        auto prev = std::prev(next);
+        rate = prev->second + (next->second - prev->second) *
+                                  (t - prev->first) /
+                                  (next->first - prev->first);
+      }
+      break;
+    }
+    }
+    return std::max(0.0, rate);
+  }
+
+ private:
+  void LoadPoints(const std::string &path) {
+    std::ifstream file(path);
+    if (!file) {
+      throw Exception("Cannot open rate profile: " + path);
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+      line = Trim(line.substr(0, line.find('#')));
+      if (line.empty()) {
+        continue;
+      }
+      std::replace(line.begin(), line.end(), ',', ' ');
+      std::stringstream ss(line);
+      double t, rate;
+      if (!(ss >> t >> rate)) {
+        throw Exception("Invalid rate profile line: " + line);
+      }
+      points_.emplace_back(t, rate);
+    }
+    if (points_.empty()) {
+      throw Exception("Empty rate profile: " + path);
+    }
+    std::stable_sort(points_.begin(), points_.end(),
+                     [](const auto &a, const auto &b) {
+                       return a.first < b.first;
+                     });
+  }
+
+  enum Kind { kConstant, kStep, kRamp, kSine, kPiecewise };
+
+  Kind kind_{kConstant};
+  double base_;
+  double seconds_{0};
+  double value_{0};
+  std::vector<std::pair<double, double>> points_;
+};
+
+//
+// Intended start times of an open-loop client: each operation is due one
+// period (the inverse of the current target rate) after the previous one,
+// regardless of when that one completed. Operations running behind are due
+// at once, so the client catches up instead of lowering the offered load.
+// Fibers of a client share its schedule, each awaiting the next slot.
+//
+class OpenLoopSchedule {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit OpenLoopSchedule(RateProfile profile)
+      : profile_(std::move(profile)) {}
+
+  // Waits for the next operation to be due and returns its intended start
+  // time, or nothing after waiting through an idle (zero rate) interval
+  std::optional<Clock::time_point> Await() {
+    if (!started_) {
+      start_ = next_ = Clock::now();
+      started_ = true;
+    }
+    double rate = profile_.Rate(Seconds(next_ - start_).count());
+    if (rate <= 0) {
+      next_ += kIdleStep;
+      SleepUntil(next_);
+      return std::nullopt;
+    }
+    Clock::time_point intended = next_;
+    next_ += std::chrono::duration_cast<Clock::duration>(Seconds(1 / rate));
+    SleepUntil(intended);
+    return intended;
+  }
+
+ private:
+  using Seconds = std::chrono::duration<double>;
+
+  static constexpr std::chrono::milliseconds kIdleStep{10};
+
+  RateProfile profile_;
+  bool started_{false};
+  Clock::time_point start_;
+  Clock::time_point next_;
+};
+
+} // utils
+
+} // ycsbc
+
+#endif // YCSB_C_RATE_PROFILE_H_
@@ -0,0 +1,112 @@
+//
+//  status_sink.cc
+//  YCSB-cpp
+//
+
+#include "status_sink.h"
+
+#include "utils.h"
+
+namespace {
+
+std::string JsonString(const std::string &s) {
+  std::string escaped = "\"";
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      escaped.push_back('\\');
+    }
+    escaped.push_back(c);
+  }
+  return escaped + "\"";
+}
+
+std::string PercentileName(double percentile) {
+  std::string name = std::to_string(percentile);
+  name.erase(name.find_last_not_of('0') + 1);
+  if (name.back() == '.') {
+    name.pop_back();
+  }
+  return "p" + name;
+}
+
+} // namespace
+
+namespace ycsbc {
+
+StatusSink::StatusSink(const std::string &path, const std::string &format)
+    : out_(path, std::ios::trunc), csv_(format == "csv") {
+  if (!out_) {
+    throw utils::Exception("Cannot open status output: " + path);
+  }
+  if (format != "csv" && format != "jsonl") {
+    throw utils::Exception("Unknown status format: " + format);
+  }
+  if (csv_) {
+    out_ << "time,scope,name,operations,throughput,hit_ratio,pool_used,"
+            "pool_size,cache_used,cache_size,latency_count,latency_mean,"
+            "latency_min,latency_max";
+    for (double percentile : Measurements::kPercentiles) {
+      out_ << ",latency_" << PercentileName(percentile);
+    }
+    out_ << "\n";
+  }
+}
+
+void StatusSink::Write(const StatusRecord &record) {
+  if (csv_) {
+    WriteCsv(record);
+  } else {
+    WriteJson(record);
+  }
+}
+
+void StatusSink::WriteJson(const StatusRecord &record) {
+  out_ << "{\"time\":" << record.time
+       << ",\"scope\":" << JsonString(record.scope)
+       << ",\"name\":" << JsonString(record.name)
+       << ",\"operations\":" << record.operations
+       << ",\"throughput\":" << record.throughput << ",\"hit_ratio\":";
+  if (record.hit_ratio) {
+    out_ << *record.hit_ratio;
+  } else {
+    out_ << "null";
+  }
+  out_ << ",\"pool_used\":" << record.pool_used
+       << ",\"pool_size\":" << record.pool_size
+       << ",\"cache_used\":" << record.cache_used
+       << ",\"cache_size\":" << record.cache_size << ",\"latency_us\":{"
+       << "\"count\":" << record.latency.count
+       << ",\"mean\":" << record.latency.mean
+       << ",\"min\":" << record.latency.min
+       << ",\"max\":" << record.latency.max;
+  for (size_t i = 0; i < Measurements::kPercentiles.size(); i++) {
+    out_ << ",\"" << PercentileName(Measurements::kPercentiles[i]) << "\":";
+    if (record.latency.percentiles) {
+      out_ << (*record.latency.percentiles)[i];
+    } else {
+      out_ << "null";
+    }
+  }
+  out_ << "}}\n";
+}
+
+void StatusSink::WriteCsv(const StatusRecord &record) {
+  out_ << record.time << "," << record.scope << "," << record.name << ","
+       << record.operations << "," << record.throughput << ",";
+  if (record.hit_ratio) {
+    out_ << *record.hit_ratio;
+  }
+  out_ << "," << record.pool_used << "," << record.pool_size << ","
+       << record.cache_used << "," << record.cache_size << ","
+       << record.latency.count << "," << record.latency.mean << ","
+       << record.latency.min << "," << record.latency.max;
+  for (size_t i = 0; i < Measurements::kPercentiles.size(); i++) {
+    out_ << ",";
+    if (record.latency.percentiles) {
+      out_ << (*record.latency.percentiles)[i];
+    }
+  }
+  out_ << "\n";
+}
+
+} // ycsbc
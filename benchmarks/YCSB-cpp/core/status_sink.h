@@ -0,0 +1,55 @@
+//
+//  status_sink.h
+//  YCSB-cpp
+//
+//  Structured time series of the status thread: one record per interval for
+//  every client thread, every cache pool and the whole run, as JSON lines or
+//  CSV.
+//
+
+#ifndef YCSB_C_STATUS_SINK_H_
+#define YCSB_C_STATUS_SINK_H_
+
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+
+#include "measurements.h"
+
+namespace ycsbc {
+
+struct StatusRecord {
+  double time;       // seconds since the phase started
+  std::string scope; // "thread", "pool" or "global"
+  std::string name;  // T-<thread>, <pool>@<cache> or GLOBAL
+  uint64_t operations;
+  double throughput; // ops/sec over the interval
+  std::optional<double> hit_ratio;
+  uint64_t pool_used;
+  uint64_t pool_size;
+  uint64_t cache_used;
+  uint64_t cache_size;
+  Measurements::Summary latency; // of all operations over the interval
+};
+
+class StatusSink {
+ public:
+  // format is "jsonl" or "csv"
+  StatusSink(const std::string &path, const std::string &format);
+
+  void Write(const StatusRecord &record);
+
+  void Flush() { out_.flush(); }
+
+ private:
+  void WriteJson(const StatusRecord &record);
+  void WriteCsv(const StatusRecord &record);
+
+  std::ofstream out_;
+  bool csv_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_STATUS_SINK_H_
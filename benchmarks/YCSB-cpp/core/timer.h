@@ -19,6 +19,9 @@ template <typename R, typename P = std::ratio<1>> class Timer {
 public:
   void Start() { time_ = Clock::now(); }
 
+  // Starts timing from a given (possibly past) time point
+  void Start(std::chrono::steady_clock::time_point t) { time_ = t; }
+
   R End() {
     Duration span;
     Clock::time_point t = Clock::now();
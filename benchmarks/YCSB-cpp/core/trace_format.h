@@ -0,0 +1,231 @@
+//
+//  trace_format.h
+//  YCSB-cpp
+//
+//  Binary trace format replayed by TraceReplayer.
+//
+
+#ifndef YCSB_C_TRACE_FORMAT_H_
+#define YCSB_C_TRACE_FORMAT_H_
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ycsbc {
+
+namespace trace {
+
+//
+// Layout of a binary trace (little endian, as written by trace-converter):
+//
+//   Header
+//   Record[record_count]       fixed-width operations, in trace order
+//   uint64_t[key_count + 1]    offset of each key within the key data
+//   char[]                     key data, keys concatenated without separators
+//
+// Each distinct key is stored once and referenced by its index (key id).
+//
+
+constexpr char kMagic[8] = {'Y', 'C', 'S', 'B', 'T', 'R', 'C', '1'};
+
+enum OpCode : uint8_t { GET = 0, SET, ADD, REPLACE, OTHER };
+
+struct Header {
+  char magic[8];
+  uint64_t record_count;
+  uint64_t key_count;
+  uint64_t records_offset;
+  uint64_t key_index_offset;
+  uint64_t key_data_offset;
+};
+
+struct Record {
+  uint32_t timestamp;  // seconds, as in the text trace
+  uint32_t key_id;
+  uint32_t value_size;
+  uint8_t op;          // OpCode
+  uint8_t padding[3];
+};
+
+static_assert(sizeof(Record) == 16, "trace records must be 16 bytes wide");
+
+// Op code of a Twitter trace operation name
+inline OpCode ParseOpCode(std::string_view op) {
+  if (op == "get") {
+    return GET;
+  } else if (op == "set") {
+    return SET;
+  } else if (op == "add") {
+    return ADD;
+  } else if (op == "replace") {
+    return REPLACE;
+  }
+  return OTHER;
+}
+
+// Operation of a text trace line, whose key points into the line
+struct TextOperation {
+  uint32_t timestamp;
+  std::string_view key;
+  uint32_t value_size;
+  OpCode op;
+};
+
+// Parses a Twitter trace line (timestamp,key,key size,value size,client id,
+// operation,TTL) in a single pass; returns false if it has too few fields
+inline bool ParseTextLine(std::string_view line, TextOperation &operation) {
+  std::string_view fields[6];
+  size_t field = 0;
+  size_t start = 0;
+  while (field < 6) {
+    size_t end = line.find(',', start);
+    fields[field++] = line.substr(start, end - start);
+    if (end == std::string_view::npos) {
+      break;
+    }
+    start = end + 1;
+  }
+  if (field < 6) {
+    return false;
+  }
+  operation.timestamp = 0;
+  std::from_chars(fields[0].data(), fields[0].data() + fields[0].size(),
+                  operation.timestamp);
+  operation.key = fields[1];
+  operation.value_size = 0;
+  std::from_chars(fields[3].data(), fields[3].data() + fields[3].size(),
+                  operation.value_size);
+  operation.op = ParseOpCode(fields[5]);
+  return true;
+}
+
+// Whether the file at path starts with the binary trace magic
+inline bool IsBinaryTrace(const std::string &path) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  char magic[sizeof(kMagic)];
+  bool binary = ::read(fd, magic, sizeof(magic)) == sizeof(magic) &&
+                std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+  ::close(fd);
+  return binary;
+}
+
+// Read-only memory mapping of a binary trace; decoding allocates nothing
+class MappedTrace {
+ public:
+  MappedTrace() = default;
+  MappedTrace(const MappedTrace &) = delete;
+  MappedTrace &operator=(const MappedTrace &) = delete;
+  ~MappedTrace() { Close(); }
+
+  // Maps the trace at path; returns false if it is missing or malformed
+  bool Open(const std::string &path) {
+    Close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 ||
+        static_cast<size_t>(st.st_size) < sizeof(Header)) {
+      ::close(fd);
+      return false;
+    }
+    void *data = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+      return false;
+    }
+    data_ = static_cast<const char *>(data);
+    size_ = st.st_size;
+    ::madvise(data, size_, MADV_SEQUENTIAL);
+
+    std::memcpy(&header_, data_, sizeof(header_));
+    if (!Valid()) {
+      Close();
+      return false;
+    }
+    return true;
+  }
+
+  void Close() {
+    if (data_ != nullptr) {
+      ::munmap(const_cast<char *>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    records_ = nullptr;
+    key_index_ = nullptr;
+  }
+
+  uint64_t RecordCount() const { return header_.record_count; }
+
+  const Record &GetRecord(uint64_t i) const { return records_[i]; }
+
+  // Key of a record of the trace (ids are validated when it is mapped)
+  std::string_view Key(uint32_t key_id) const {
+    return std::string_view(data_ + header_.key_data_offset +
+                                key_index_[key_id],
+                            key_index_[key_id + 1] - key_index_[key_id]);
+  }
+
+ private:
+  // Whether count items of the given width fit in the mapping at offset
+  bool Fits(uint64_t offset, uint64_t count, uint64_t width) const {
+    return offset <= size_ && count <= (size_ - offset) / width;
+  }
+
+  // Checks the header and the whole trace once, so that decoding needs no
+  // checks: sections within the file, key offsets in order and within the
+  // key data, and every key id below the key count
+  bool Valid() {
+    if (std::memcmp(header_.magic, kMagic, sizeof(kMagic)) != 0 ||
+        !Fits(header_.records_offset, header_.record_count, sizeof(Record)) ||
+        header_.key_count == UINT64_MAX ||
+        !Fits(header_.key_index_offset, header_.key_count + 1,
+              sizeof(uint64_t)) ||
+        header_.key_data_offset > size_) {
+      return false;
+    }
+    records_ = reinterpret_cast<const Record *>(data_ + header_.records_offset);
+    key_index_ =
+        reinterpret_cast<const uint64_t *>(data_ + header_.key_index_offset);
+    uint64_t const key_data_size = size_ - header_.key_data_offset;
+    for (uint64_t i = 0; i < header_.key_count; i++) {
+      if (key_index_[i] > key_index_[i + 1]) {
+        return false;
+      }
+    }
+    if (key_index_[header_.key_count] > key_data_size) {
+      return false;
+    }
+    for (uint64_t i = 0; i < header_.record_count; i++) {
+      if (records_[i].key_id >= header_.key_count) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  const char *data_{nullptr};
+  size_t size_{0};
+  Header header_{};
+  const Record *records_{nullptr};
+  const uint64_t *key_index_{nullptr};
+};
+
+} // namespace trace
+
+} // namespace ycsbc
+
+#endif // YCSB_C_TRACE_FORMAT_H_
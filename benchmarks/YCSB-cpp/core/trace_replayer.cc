@@ -13,7 +13,7 @@
 #include <iostream>
 #include <string>
 
-#include "random_byte_generator.h"
+#include "fiber.h"
 #include "utils.h"
 
 using std::string;
@@ -28,6 +28,12 @@ const string TraceReplayer::OVERRIDE_VALUE_SIZE_PROPERTY =
 
 const string TraceReplayer::DIRECTORY_PROPERTY = "trace.dir";
 
+const string TraceReplayer::OPEN_LOOP_PROPERTY = "trace.open_loop";
+const string TraceReplayer::OPEN_LOOP_DEFAULT = "false";
+
+const string TraceReplayer::SPEEDUP_PROPERTY = "trace.speedup";
+const string TraceReplayer::SPEEDUP_DEFAULT = "1.0";
+
 namespace ycsbc {
 
 void TraceReplayer::Init(std::string const property_suffix,
@@ -58,17 +64,8 @@ void TraceReplayer::Init(std::string const property_suffix,
   std::string runfile_name = p.GetProperty(RUNFILE_PROPERTY + property_suffix,
                                            p.GetProperty(RUNFILE_PROPERTY));
 
-  try {
-    loadfile_.open(dir + "/" + loadfile_name);
-  } catch (const std::exception &e) {
-    std::cerr << "Error opening load file: " << e.what() << std::endl;
-  }
-
-  try {
-    runfile_.open(dir + "/" + runfile_name);
-  } catch (const std::exception &e) {
-    std::cerr << "Error opening run file: " << e.what() << std::endl;
-  }
+  OpenTrace(loadfile_, dir + "/" + loadfile_name);
+  OpenTrace(runfile_, dir + "/" + runfile_name);
 
   request_key_prefix_ = p.GetProperty(
       REQUEST_KEY_PREFIX_PROPERTY + property_suffix,
@@ -86,6 +83,17 @@ void TraceReplayer::Init(std::string const property_suffix,
     override_value_size_set = false;
   }
 
+  open_loop_ = utils::StrToBool(
+      p.GetProperty(OPEN_LOOP_PROPERTY + property_suffix,
+                    p.GetProperty(OPEN_LOOP_PROPERTY, OPEN_LOOP_DEFAULT)));
+  speedup_ = std::stod(p.GetProperty(
+      SPEEDUP_PROPERTY + property_suffix,
+      p.GetProperty(SPEEDUP_PROPERTY, SPEEDUP_DEFAULT)));
+  if (speedup_ <= 0) {
+    throw utils::Exception("trace.speedup must be positive");
+  }
+  replay_start_.reset();
+
   ops_ = 0;
 
   operation_count_ =
@@ -93,52 +101,127 @@ void TraceReplayer::Init(std::string const property_suffix,
                               p.GetProperty(OPERATION_COUNT_PROPERTY, "0")));
 }
 
-std::string TraceReplayer::BuildValue(size_t size) {
-  std::string result;
-  RandomByteGenerator byteGenerator;
-  std::generate_n(std::back_inserter(result), size,
-                  [&]() { return byteGenerator.Next(); });
-  return result;
+void TraceReplayer::OpenTrace(TraceFile &file, const std::string &path) {
+  file.is_binary = trace::IsBinaryTrace(path);
+  file.next_record = 0;
+  if (file.is_binary) {
+    if (!file.binary.Open(path)) {
+      std::cerr << "Error mapping binary trace: " << path << std::endl;
+    }
+    return;
+  }
+  try {
+    file.text.open(path);
+  } catch (const std::exception &e) {
+    std::cerr << "Error opening trace file: " << e.what() << std::endl;
+  }
 }
 
-std::tuple<Operation, std::string, size_t>
-TraceReplayer::NextOperation(std::ifstream &file_buffer_) {
-  std::string line;
-  if (!std::getline(file_buffer_, line)) {
-    return std::make_tuple(MAXOPTYPE, "", 0);
+static Operation ToOperation(trace::OpCode op) {
+  switch (op) {
+  case trace::GET:
+    return READ;
+  case trace::SET:
+  case trace::REPLACE:
+    return UPDATE;
+  case trace::ADD:
+    return INSERT;
+  default:
+    return MAXOPTYPE;
   }
+}
 
-  // split the line by commas
-  std::vector<std::string> parts;
-  size_t pos = 0;
-  while ((pos = line.find(',')) != std::string::npos) {
-    parts.push_back(line.substr(0, pos));
-    line.erase(0, pos + 1);
+std::tuple<Operation, std::string_view, size_t, uint32_t>
+TraceReplayer::NextOperation(TraceFile &file) {
+  if (file.is_binary) {
+    uint64_t index = file.next_record.fetch_add(1, std::memory_order_relaxed);
+    if (index >= file.binary.RecordCount()) {
+      return std::make_tuple(MAXOPTYPE, std::string_view(), 0, 0);
+    }
+    const trace::Record &record = file.binary.GetRecord(index);
+    return std::make_tuple(ToOperation(static_cast<trace::OpCode>(record.op)),
+                           file.binary.Key(record.key_id), record.value_size,
+                           record.timestamp);
   }
-  parts.push_back(line);
 
-  std::string key{parts[1]};
-  size_t valuesize = std::stoul(std::string(parts[3]));
-  std::string operation{parts[5]};
+  // the key points into the line, so each thread reads into its own
+  static thread_local std::string line;
+  trace::TextOperation operation;
+  std::lock_guard<std::mutex> lock(file.mutex);
+  do {
+    if (!std::getline(file.text, line)) {
+      return std::make_tuple(MAXOPTYPE, std::string_view(), 0, 0);
+    }
+  } while (!trace::ParseTextLine(line, operation));
+  return std::make_tuple(ToOperation(operation.op), operation.key,
+                         operation.value_size, operation.timestamp);
+}
 
-  if (operation == "get") {
-    return std::make_tuple(READ, key, valuesize);
-  } else if (operation == "set" || operation == "replace") {
-    return std::make_tuple(UPDATE, key, valuesize);
-  } else if (operation == "add") {
-    return std::make_tuple(INSERT, key, valuesize);
-  } else {
-    return std::make_tuple(MAXOPTYPE, key, valuesize);
+uint64_t TraceReplayer::CountAhead(TraceFile &file, uint32_t timestamp) {
+  uint64_t count = 0;
+  if (file.is_binary) {
+    for (uint64_t i = file.next_record.load();
+         i < file.binary.RecordCount() &&
+         file.binary.GetRecord(i).timestamp == timestamp;
+         ++i) {
+      ++count;
+    }
+    return count;
   }
+
+  // text traces are read ahead and rewound, so each line is parsed twice
+  std::lock_guard<std::mutex> lock(file.mutex);
+  auto position = file.text.tellg();
+  trace::TextOperation operation;
+  while (std::getline(file.text, file.lookahead)) {
+    if (!trace::ParseTextLine(file.lookahead, operation)) {
+      continue;
+    }
+    if (operation.timestamp != timestamp) {
+      break;
+    }
+    ++count;
+  }
+  file.text.clear();
+  file.text.seekg(position);
+  return count;
 }
 
-std::string TraceReplayer::BuildKeyName(const std::string &k) {
-  std::string key;
-  return key.append(request_key_prefix_).append("+").append(k);
+std::chrono::steady_clock::time_point
+TraceReplayer::IntendedStart(uint32_t timestamp) {
+  if (!replay_start_) {
+    replay_start_ = std::chrono::steady_clock::now();
+    first_timestamp_ = timestamp;
+  }
+  if (timestamp != group_timestamp_ || group_index_ >= group_size_) {
+    group_timestamp_ = timestamp;
+    group_index_ = 0;
+    group_size_ = 1 + CountAhead(runfile_, timestamp);
+  }
+
+  double offset = timestamp > first_timestamp_ ? timestamp - first_timestamp_
+                                               : 0;
+  offset += static_cast<double>(group_index_++) / group_size_;
+  return *replay_start_ +
+         std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+             std::chrono::duration<double>(offset / speedup_));
+}
+
+const std::string &TraceReplayer::BuildKeyName(std::string_view k) {
+  // one buffer per fiber of the thread, as the threads of a tenant share the
+  // workload
+  static thread_local std::vector<std::string> buffers;
+  size_t fiber = utils::FiberScheduler::CurrentIndex();
+  if (fiber >= buffers.size()) {
+    buffers.resize(fiber + 1);
+  }
+  std::string &key = buffers[fiber];
+  key.assign(request_key_prefix_).append("+").append(k);
+  return key;
 }
 
 bool TraceReplayer::DoInsert(DB &db) {
-  auto [_, k_, size] = NextOperation(loadfile_);
+  auto [_, k_, size, timestamp] = NextOperation(loadfile_);
   if (k_.empty()) {
     stop_inserts();
     return DB::kOK;
@@ -146,21 +229,36 @@ bool TraceReplayer::DoInsert(DB &db) {
   if (override_value_size_set) {
     size = override_value_size;
   }
-  const std::string key = BuildKeyName(k_);
-  std::vector<DB::Field> fields;
-  auto field = DB::Field();
-  field.value = BuildValue(size);
-  fields.push_back(field);
-  return db.Insert(table_name_, key, fields);
+  return db.Insert(table_name_, BuildKeyName(k_), BuildValue(size));
 }
 
 bool TraceReplayer::DoTransaction(DB &db) {
   DB::Status status;
-  auto [op, k_, size] = NextOperation(runfile_);
+  Operation op;
+  std::string_view k_;
+  size_t size;
+  uint32_t timestamp;
+  std::optional<std::chrono::steady_clock::time_point> intended;
+  if (open_loop_) {
+    std::lock_guard<std::mutex> lock(replay_mutex_);
+    std::tie(op, k_, size, timestamp) = NextOperation(runfile_);
+    if (op != MAXOPTYPE) {
+      intended = IntendedStart(timestamp);
+    }
+  } else {
+    std::tie(op, k_, size, timestamp) = NextOperation(runfile_);
+  }
+  // the key is copied out of the line buffer before other fibers may read on
+  const std::string &key = BuildKeyName(k_);
+  if (intended) {
+    // a late operation is issued at once, its latency still counting from
+    // when it should have started
+    utils::SleepUntil(*intended);
+    db.SetIntendedStart(*intended);
+  }
   if (override_value_size_set) {
     size = override_value_size;
   }
-  const std::string key = BuildKeyName(k_);
   switch (op) {
   case READ:
     status = TransactionRead(db, key);
@@ -194,20 +292,12 @@ DB::Status TraceReplayer::TransactionRead(DB &db, std::string const &key) {
 
 DB::Status TraceReplayer::TransactionUpdate(DB &db, std::string const &key,
                                             size_t size) {
-  std::vector<DB::Field> fields;
-  auto field = DB::Field();
-  field.value = BuildValue(size);
-  fields.push_back(field);
-  return db.Update(table_name_, key, fields);
+  return db.Update(table_name_, key, BuildValue(size));
 }
 
 DB::Status TraceReplayer::TransactionInsert(DB &db, std::string const &key,
                                             size_t size) {
-  std::vector<DB::Field> fields;
-  auto field = DB::Field();
-  field.value = BuildValue(size);
-  fields.push_back(field);
-  return db.Insert(table_name_, key, fields);
+  return db.Insert(table_name_, key, BuildValue(size));
 }
 
 } // namespace ycsbc
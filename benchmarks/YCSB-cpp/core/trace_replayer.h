@@ -4,8 +4,15 @@
 #define YCSB_C_TRACE_REPLAYER_H_
 
 #include "core_workload.h"
+#include "trace_format.h"
 
+#include <atomic>
+#include <chrono>
 #include <fstream>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <vector>
 
 namespace ycsbc {
 
@@ -21,6 +28,12 @@ public:
 
   static const std::string DIRECTORY_PROPERTY;
 
+  static const std::string OPEN_LOOP_PROPERTY;
+  static const std::string OPEN_LOOP_DEFAULT;
+
+  static const std::string SPEEDUP_PROPERTY;
+  static const std::string SPEEDUP_DEFAULT;
+
   /// Called once, in the main client thread, before any operations are started.
   ///
   void Init(std::string const property_suffix,
@@ -37,21 +50,60 @@ protected:
   DB::Status TransactionInsert(DB &db, std::string const &key,
                                size_t size) override final;
 
+  // trace file, either text (read line by line) or binary (memory mapped,
+  // as written by trace-converter), shared by the threads of a tenant:
+  // binary records are dispatched lock-free, text lines under the mutex
+  struct TraceFile {
+    std::ifstream text;
+    trace::MappedTrace binary;
+    bool is_binary{false};
+    std::atomic<uint64_t> next_record{0};
+    std::mutex mutex;
+    // line buffer for looking ahead without invalidating the current key
+    std::string lookahead;
+  };
+
   // for productiont traces
-  std::string BuildValue(size_t size) override final;
-  std::string BuildKeyName(std::string const &k);
+  const std::string &BuildKeyName(std::string_view k);
+
+  // operation, key, value size and timestamp (seconds) of the next trace
+  // operation; the key is only valid until the thread's next call
+  std::tuple<Operation, std::string_view, size_t, uint32_t>
+  NextOperation(TraceFile &file);
 
-  std::tuple<Operation, std::string, size_t> NextOperation(std::ifstream &file);
+  // number of operations following the current one with the same timestamp
+  uint64_t CountAhead(TraceFile &file, uint32_t timestamp);
+
+  // open-loop replay: intended start of the operation just taken, issued at
+  // the given trace timestamp
+  std::chrono::steady_clock::time_point IntendedStart(uint32_t timestamp);
+
+  void OpenTrace(TraceFile &file, const std::string &path);
 
 private:
   // file buffer
-  std::ifstream loadfile_;
-  std::ifstream runfile_;
+  TraceFile loadfile_;
+  TraceFile runfile_;
 
   std::string request_key_prefix_;
 
   bool override_value_size_set{false};
   uint64_t override_value_size{0};
+
+  // open-loop replay: the trace's timestamps, divided by the speedup, are
+  // replayed relative to the time the first operation is issued; operations
+  // are taken and scheduled under replay_mutex_, so their intended starts
+  // follow the trace order
+  bool open_loop_{false};
+  std::mutex replay_mutex_;
+  double speedup_{1.0};
+  std::optional<std::chrono::steady_clock::time_point> replay_start_;
+  uint32_t first_timestamp_{0};
+
+  // operations sharing a (one second) timestamp are spread evenly over it
+  uint32_t group_timestamp_{0};
+  uint64_t group_index_{0};
+  uint64_t group_size_{0};
 };
 
 } // namespace ycsbc
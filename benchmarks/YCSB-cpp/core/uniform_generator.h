@@ -16,22 +16,26 @@
 
 namespace ycsbc {
 
+// Safe to share between the client threads of a workload: each thread draws
+// from its own engine
 class UniformGenerator : public Generator<uint64_t> {
 public:
   // Both min and max are inclusive
-  UniformGenerator(uint64_t min, uint64_t max) : dist_(min, max) { Next(); }
+  UniformGenerator(uint64_t min, uint64_t max) : params_(min, max) { Next(); }
 
   uint64_t Next();
   uint64_t Last();
 
 private:
-  std::mt19937_64 generator_;
-  std::uniform_int_distribution<uint64_t> dist_;
-  uint64_t last_int_;
+  const std::uniform_int_distribution<uint64_t>::param_type params_;
+  std::atomic<uint64_t> last_int_;
 };
 
 inline uint64_t UniformGenerator::Next() {
-  return last_int_ = dist_(generator_);
+  static thread_local std::random_device rd;
+  static thread_local std::mt19937_64 generator(rd());
+  return last_int_ =
+             std::uniform_int_distribution<uint64_t>()(generator, params_);
 }
 
 inline uint64_t UniformGenerator::Last() { return last_int_; }
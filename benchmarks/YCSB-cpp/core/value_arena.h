@@ -0,0 +1,57 @@
+//
+//  value_arena.h
+//  YCSB-cpp
+//
+//  Random values served as slices of a buffer filled once per client thread,
+//  so building a value neither allocates nor generates bytes.
+//
+
+#ifndef YCSB_C_VALUE_ARENA_H_
+#define YCSB_C_VALUE_ARENA_H_
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+
+#include "random_byte_generator.h"
+#include "utils.h"
+
+namespace ycsbc {
+
+class ValueArena {
+ public:
+  static constexpr size_t kDefaultSize = 4 << 20;
+
+  explicit ValueArena(size_t size = kDefaultSize) { Fill(size); }
+
+  // Arena of the calling thread, shared by the workloads it runs
+  static ValueArena &ForThread() {
+    static thread_local ValueArena arena;
+    return arena;
+  }
+
+  // Value of the given size at a random offset of the arena; valid until the
+  // next call, which may grow the arena for a larger value
+  std::string_view Next(size_t size) {
+    if (size > arena_.size()) {
+      Fill(2 * size);
+    }
+    size_t offset = utils::ThreadLocalRandomInt() % (arena_.size() - size + 1);
+    return std::string_view(arena_.data() + offset, size);
+  }
+
+ private:
+  void Fill(size_t size) {
+    arena_.clear();
+    arena_.reserve(size);
+    RandomByteGenerator byte_generator;
+    std::generate_n(std::back_inserter(arena_), size,
+                    [&]() { return byte_generator.Next(); });
+  }
+
+  std::string arena_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_VALUE_ARENA_H_
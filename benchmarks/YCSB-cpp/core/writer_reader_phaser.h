@@ -0,0 +1,52 @@
+//
+//  writer_reader_phaser.h
+//  YCSB-cpp
+//
+//  Writer-reader phaser, as in HdrHistogram's Recorder: writers enter and
+//  exit critical sections wait-free, and a reader flipping the phase waits
+//  until every critical section begun before the flip has exited.
+//
+
+#ifndef YCSB_C_WRITER_READER_PHASER_H_
+#define YCSB_C_WRITER_READER_PHASER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <thread>
+
+namespace ycsbc {
+
+class WriterReaderPhaser {
+ public:
+  // Enters a writer critical section; returns the value to exit it with
+  int64_t WriterEnter() { return start_epoch_.fetch_add(1); }
+
+  void WriterExit(int64_t critical_value) {
+    (critical_value < 0 ? odd_end_epoch_ : even_end_epoch_).fetch_add(1);
+  }
+
+  // Flips the phase and waits for the writers of the previous phase; the
+  // caller swaps the data written to before flipping (one reader at a time)
+  void FlipPhase() {
+    bool next_phase_even = start_epoch_.load() < 0;
+    int64_t initial = next_phase_even ? 0 : kOddInitial;
+    (next_phase_even ? even_end_epoch_ : odd_end_epoch_).store(initial);
+    int64_t start_at_flip = start_epoch_.exchange(initial);
+    auto &end_epoch = next_phase_even ? odd_end_epoch_ : even_end_epoch_;
+    while (end_epoch.load() != start_at_flip) {
+      std::this_thread::yield();
+    }
+  }
+
+ private:
+  static constexpr int64_t kOddInitial = std::numeric_limits<int64_t>::min();
+
+  std::atomic<int64_t> start_epoch_{0};
+  std::atomic<int64_t> even_end_epoch_{0};
+  std::atomic<int64_t> odd_end_epoch_{kOddInitial};
+};
+
+} // ycsbc
+
+#endif // YCSB_C_WRITER_READER_PHASER_H_
@@ -8,10 +8,13 @@
 
 #include <atomic>
 #include <chrono>
+#include <cstdio>
 #include <cstring>
 #include <ctime>
 #include <future>
 #include <iostream>
+#include <map>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <thread>
@@ -22,6 +25,8 @@
 #include "core_workload.h"
 #include "db_factory.h"
 #include "measurements.h"
+#include "offload_pool.h"
+#include "status_sink.h"
 #include "timer.h"
 #include "trace_replayer.h"
 #include "utils.h"
@@ -69,36 +74,186 @@ static const std::string LOAD_OUTPUT_FILE_PROPERTY = "loadoutputfile";
 
 static const std::string RUN_OUTPUT_FILE_PROPERTY = "runoutputfile";
 
+static const std::string TARGET_PROPERTY = "target";
+
+static const std::string TARGET_PROFILE_PROPERTY = "target.profile";
+static const std::string TARGET_PROFILE_DEFAULT = "constant";
+
+static const std::string TENANT_PROPERTY = "tenant";
+static const std::string TENANT_THREADS_PROPERTY = ".threads";
+static const std::string TENANT_THREADS_DEFAULT = "1";
+
+static const std::string OUTSTANDING_PROPERTY = "outstanding";
+static const std::string OUTSTANDING_DEFAULT = "1";
+
+static const std::string OFFLOAD_THREADS_PROPERTY = "offload.threads";
+
+static const std::string STATUS_OUTPUT_PROPERTY = "status.output";
+
+static const std::string STATUS_FORMAT_PROPERTY = "status.format";
+static const std::string STATUS_FORMAT_DEFAULT = "jsonl";
+
+static const std::string STATUS_HDRLOG_PROPERTY = "status.hdrlog";
+
 void UsageMessage(const char *command);
 bool StrStartWith(const char *str, const char *pre);
 void ParseCommandLine(int argc, const char *argv[],
                       ycsbc::utils::Properties &props);
 
+// Samples the measurements of every client thread and merges them into the
+// global ones (called by one thread at a time)
+void SampleMeasurements(std::vector<ycsbc::Measurements *> *measurements,
+                        ycsbc::Measurements *gMeasurements) {
+  gMeasurements->Reset();
+  for (auto m : *measurements) {
+    m->Sample();
+    gMeasurements->Merge(*m);
+  }
+}
+
+// Structured status output of the run phase (both optional)
+struct StatusOutput {
+  ycsbc::StatusSink *sink{nullptr};
+  std::FILE *hdr_log{nullptr};
+};
+
 void StatusThread(std::vector<ycsbc::Measurements *> *measurements,
                   ycsbc::Measurements *gMeasurements,
                   std::vector<ycsbc::Operation> *operations,
                   std::vector<ycsbc::DB *> *dbs, std::atomic_bool *done,
+                  ycsbc::utils::Properties *props, bool print,
+                  StatusOutput output,
                   std::chrono::seconds interval = 1s) {
   using namespace std::chrono;
 
+  // per-pool merges of the measurements of the threads sharing a pool
+  std::map<std::string, std::unique_ptr<ycsbc::Measurements>> pools;
+  std::vector<std::pair<uint64_t, uint64_t>> hitsAndMisses(dbs->size());
+
   auto start = steady_clock::now();
+  auto previous = start;
+  auto previousWallClock = system_clock::now();
   while (1) {
     auto now = steady_clock::now();
     auto elapsed_time = duration_cast<std::chrono::seconds>(now - start);
     std::stringstream msg;
 
+    SampleMeasurements(measurements, gMeasurements);
+
+    double const kTime = duration<double>(now - start).count();
+    double const kInterval =
+        std::max(duration<double>(now - previous).count(), 1e-9);
+    auto record = [&](std::string scope, std::string name,
+                      ycsbc::Measurements *m, uint64_t hits, uint64_t misses,
+                      uint64_t occ, uint64_t cap, uint64_t gOcc,
+                      uint64_t gCap) {
+      ycsbc::StatusRecord r;
+      r.time = kTime;
+      r.scope = std::move(scope);
+      r.name = std::move(name);
+      r.latency = m->GetIntervalSummary(ycsbc::Operation::ALL);
+      r.operations = r.latency.count;
+      r.throughput = r.operations / kInterval;
+      if (hits + misses > 0) {
+        r.hit_ratio = static_cast<double>(hits) / (hits + misses);
+      }
+      r.pool_used = occ;
+      r.pool_size = cap;
+      r.cache_used = gOcc;
+      r.cache_size = gCap;
+      return r;
+    };
+
+    // interval hits and misses of a pool, and its latest occupancy
+    struct PoolInterval {
+      uint64_t hits{0}, misses{0}, occ{0}, cap{0}, gOcc{0}, gCap{0};
+    };
+    std::vector<ycsbc::StatusRecord> records;
+    std::map<std::string, PoolInterval> poolIntervals;
+    std::map<std::string, std::pair<uint64_t, uint64_t>> caches;
+    uint64_t totalHits = 0, totalMisses = 0;
     for (long i = 0; i < measurements->size(); i++) {
       auto const &[cacheName, poolName, occ, cap, gOcc, gCap] =
           (*dbs)[i]->OccupancyCapacityAndGlobal();
-      msg << elapsed_time.count() << " sec [T-" << i
-          << "]: " << (*measurements)[i]->GetStatusMsg(*operations) << " ("
-          << poolName << "@" << cacheName << ": " << occ << " / " << cap
-          << " | " << gOcc << " / " << gCap << ")" << std::endl;
-    }
-    msg << elapsed_time.count()
-        << " sec [GLOBAL]: " << gMeasurements->GetStatusMsg(*operations)
-        << std::endl;
-    (*output_stream) << msg.str();
+      if (print) {
+        msg << elapsed_time.count() << " sec [T-" << i
+            << "]: " << (*measurements)[i]->GetStatusMsg(*operations) << " ("
+            << poolName << "@" << cacheName << ": " << occ << " / " << cap
+            << " | " << gOcc << " / " << gCap << ")" << std::endl;
+      }
+      if (output.sink == nullptr) {
+        continue;
+      }
+
+      // hits and misses are cumulative, records hold those of the interval
+      auto const [hits, misses] = (*dbs)[i]->HitsAndMisses();
+      uint64_t const kHits = hits - hitsAndMisses[i].first;
+      uint64_t const kMisses = misses - hitsAndMisses[i].second;
+      hitsAndMisses[i] = {hits, misses};
+      totalHits += kHits;
+      totalMisses += kMisses;
+      records.push_back(record("thread", "T-" + std::to_string(i),
+                               (*measurements)[i], kHits, kMisses, occ, cap,
+                               gOcc, gCap));
+      if (!cacheName.empty()) {
+        caches[cacheName] = {gOcc, gCap};
+      }
+      if (poolName.empty()) {
+        continue;
+      }
+
+      std::string const kPool = poolName + "@" + cacheName;
+      auto &pool = pools[kPool];
+      if (pool == nullptr) {
+        pool.reset(ycsbc::CreateMeasurements(props));
+      }
+      auto [it, first] = poolIntervals.try_emplace(kPool);
+      if (first) {
+        pool->Reset();
+      }
+      pool->Merge(*(*measurements)[i]);
+      it->second.hits += kHits;
+      it->second.misses += kMisses;
+      it->second.occ = occ;
+      it->second.cap = cap;
+      it->second.gOcc = gOcc;
+      it->second.gCap = gCap;
+    }
+    if (print) {
+      msg << elapsed_time.count()
+          << " sec [GLOBAL]: " << gMeasurements->GetStatusMsg(*operations)
+          << std::endl;
+      (*output_stream) << msg.str();
+    }
+
+    if (output.sink != nullptr) {
+      for (auto const &r : records) {
+        output.sink->Write(r);
+      }
+      for (auto const &[name, p] : poolIntervals) {
+        output.sink->Write(record("pool", name, pools[name].get(), p.hits,
+                                  p.misses, p.occ, p.cap, p.gOcc, p.gCap));
+      }
+      uint64_t cacheUsed = 0, cacheSize = 0;
+      for (auto const &[name, usedAndSize] : caches) {
+        cacheUsed += usedAndSize.first;
+        cacheSize += usedAndSize.second;
+      }
+      output.sink->Write(record("global", "GLOBAL", gMeasurements, totalHits,
+                                totalMisses, 0, 0, cacheUsed, cacheSize));
+      output.sink->Flush();
+    }
+    auto wallClock = system_clock::now();
+    if (output.hdr_log != nullptr &&
+        !gMeasurements->WriteIntervalLog(output.hdr_log, previousWallClock,
+                                         wallClock)) {
+      std::cerr << "status.hdrlog requires hdrhistogram measurements"
+                << std::endl;
+      output.hdr_log = nullptr;
+    }
+    previous = now;
+    previousWallClock = wallClock;
+
     if (done->load()) {
       break;
     }
@@ -117,7 +272,22 @@ int main(const int argc, const char *argv[]) {
     exit(1);
   }
 
-  const int num_threads = stoi(props.GetProperty("threadcount", "1"));
+  // each of the threadcount tenants is run by tenant.N.threads threads,
+  // sharing its workload, cache pool and ".N" properties
+  const int num_tenants = stoi(props.GetProperty("threadcount", "1"));
+  std::vector<int> tenant_of;
+  std::vector<int> tenant_threads;
+  for (int t = 0; t < num_tenants; t++) {
+    tenant_threads.push_back(stoi(props.GetProperty(
+        TENANT_PROPERTY + "." + std::to_string(t) + TENANT_THREADS_PROPERTY,
+        TENANT_THREADS_DEFAULT)));
+    if (tenant_threads[t] < 1) {
+      std::cerr << "Tenant " << t << " needs at least one thread" << std::endl;
+      exit(1);
+    }
+    tenant_of.insert(tenant_of.end(), tenant_threads[t], t);
+  }
+  const int num_threads = tenant_of.size();
   std::vector<ycsbc::Operation> operationsForStatus;
   for (int i = 0; i < ycsbc::Operation::MAXOPTYPE; i++) {
     if (props.ContainsKey("status." +
@@ -136,7 +306,7 @@ int main(const int argc, const char *argv[]) {
       exit(1);
     }
     ycsbc::DB *db =
-        ycsbc::DBFactory::CreateDB(&props, measurements[i], gMeasurements, i);
+        ycsbc::DBFactory::CreateDB(&props, measurements[i], tenant_of[i]);
     if (db == nullptr) {
       std::cerr << "Unknown database name " << props["dbname"] << std::endl;
       exit(1);
@@ -145,7 +315,7 @@ int main(const int argc, const char *argv[]) {
   }
 
   std::vector<ycsbc::CoreWorkload *> wls;
-  for (int i = 0; i < num_threads; i++) {
+  for (int i = 0; i < num_tenants; i++) {
     ycsbc::CoreWorkload *wl;
     if (props.GetProperty(WORKLOAD_TYPE_PROPERTY, WORKLOAD_TYPE_DEFAULT) ==
         "trace") {
@@ -187,33 +357,38 @@ int main(const int argc, const char *argv[]) {
     timer.Start();
     std::future<void> status_future;
     if (show_status) {
-      status_future = std::async(
-          std::launch::async, StatusThread, &measurements, gMeasurements,
-          &operationsForStatus, &dbs, &done, status_interval);
+      status_future = std::async(std::launch::async, StatusThread,
+                                 &measurements, gMeasurements,
+                                 &operationsForStatus, &dbs, &done, &props,
+                                 true, StatusOutput(), status_interval);
     }
     std::vector<std::thread> client_threads;
     for (int i = 0; i < num_threads; ++i) {
+      const std::string tenant = "." + std::to_string(tenant_of[i]);
       const long thread_ops = stol(props.GetProperty(
-          ycsbc::CoreWorkload::RECORD_COUNT_PROPERTY + "." + std::to_string(i),
+          ycsbc::CoreWorkload::RECORD_COUNT_PROPERTY + tenant,
           props.GetProperty(ycsbc::CoreWorkload::RECORD_COUNT_PROPERTY, "0")));
 
       const bool cleanup_after_load =
-          (props.GetProperty(
-               CLEANUP_AFTER_LOAD_PROPERTY + "." + std::to_string(i),
-               props.GetProperty(CLEANUP_AFTER_LOAD_PROPERTY,
-                                 CLEANUP_AFTER_LOAD_DEFAULT)) == "true");
+          (props.GetProperty(CLEANUP_AFTER_LOAD_PROPERTY + tenant,
+                             props.GetProperty(CLEANUP_AFTER_LOAD_PROPERTY,
+                                               CLEANUP_AFTER_LOAD_DEFAULT)) ==
+           "true");
 
-      client_threads.emplace_back(std::thread(ycsbc::ClientThread, 0s, 0s, i,
-                                              dbs[i], wls[i], thread_ops, true,
-                                              cleanup_after_load));
+      client_threads.emplace_back(
+          std::thread(ycsbc::ClientThread, 0s, 0s, i, dbs[i],
+                      wls[tenant_of[i]], thread_ops, true, cleanup_after_load,
+                      nullptr, 1, nullptr));
     }
     assert((int)client_threads.size() == num_threads);
 
-    long sum = 0;
     for (int i = 0; i < num_threads; i++) {
       assert(client_threads[i].joinable());
       client_threads[i].join();
-      sum += wls[i]->GetExecutedOps();
+    }
+    long sum = 0;
+    for (auto wl : wls) {
+      sum += wl->GetExecutedOps();
     }
     done.store(true);
     double runtime = timer.End();
@@ -254,49 +429,114 @@ int main(const int argc, const char *argv[]) {
     std::atomic_bool done(false);
     ycsbc::utils::Timer<double> timer;
 
+    // time series of the run, for plotting without parsing the status text
+    std::unique_ptr<ycsbc::StatusSink> status_sink;
+    if (props.ContainsKey(STATUS_OUTPUT_PROPERTY)) {
+      status_sink = std::make_unique<ycsbc::StatusSink>(
+          props.GetProperty(STATUS_OUTPUT_PROPERTY),
+          props.GetProperty(STATUS_FORMAT_PROPERTY, STATUS_FORMAT_DEFAULT));
+    }
+    std::FILE *hdr_log = nullptr;
+    if (props.ContainsKey(STATUS_HDRLOG_PROPERTY)) {
+      hdr_log = std::fopen(props.GetProperty(STATUS_HDRLOG_PROPERTY).c_str(),
+                           "w");
+      if (hdr_log == nullptr) {
+        std::cerr << "Cannot open " << props[STATUS_HDRLOG_PROPERTY]
+                  << std::endl;
+        exit(1);
+      }
+    }
+    const bool run_status =
+        show_status || status_sink != nullptr || hdr_log != nullptr;
+
+    // threads keeping several operations outstanding run them on fibers,
+    // whose backend calls share a pool of (by default) one thread each
+    std::vector<int> outstanding;
+    for (int i = 0; i < num_threads; ++i) {
+      outstanding.push_back(std::stoi(props.GetProperty(
+          OUTSTANDING_PROPERTY + "." + std::to_string(tenant_of[i]),
+          props.GetProperty(OUTSTANDING_PROPERTY, OUTSTANDING_DEFAULT))));
+    }
+    std::unique_ptr<ycsbc::utils::OffloadPool> offload_pool;
+    int fibers = 0;
+    for (int n : outstanding) {
+      fibers += n > 1 ? n : 0;
+    }
+    if (fibers > 0) {
+      offload_pool = std::make_unique<ycsbc::utils::OffloadPool>(std::stoi(
+          props.GetProperty(OFFLOAD_THREADS_PROPERTY, std::to_string(fibers))));
+    }
+
     timer.Start();
     std::thread status_thread;
-    if (show_status) {
-      status_thread =
-          std::thread(StatusThread, &measurements, gMeasurements,
-                      &operationsForStatus, &dbs, &done, status_interval);
+    if (run_status) {
+      status_thread = std::thread(
+          StatusThread, &measurements, gMeasurements, &operationsForStatus,
+          &dbs, &done, &props, show_status,
+          StatusOutput{status_sink.get(), hdr_log}, status_interval);
     }
+    std::vector<std::unique_ptr<ycsbc::utils::RateProfile>> rate_profiles;
     std::vector<std::thread> client_threads;
     for (int i = 0; i < num_threads; ++i) {
+      const std::string tenant = "." + std::to_string(tenant_of[i]);
+
+      // threads with a target rate (ops/sec) run open loop, splitting that
+      // of their tenant
+      rate_profiles.emplace_back();
+      if (props.ContainsKey(TARGET_PROPERTY + tenant) ||
+          props.ContainsKey(TARGET_PROPERTY)) {
+        rate_profiles.back() = std::make_unique<ycsbc::utils::RateProfile>(
+            stod(props.GetProperty(TARGET_PROPERTY + tenant,
+                                   props.GetProperty(TARGET_PROPERTY))),
+            props.GetProperty(
+                TARGET_PROFILE_PROPERTY + tenant,
+                props.GetProperty(TARGET_PROFILE_PROPERTY,
+                                  TARGET_PROFILE_DEFAULT)));
+        rate_profiles.back()->Scale(1.0 / tenant_threads[tenant_of[i]]);
+      }
+
       long thread_ops = stol(props.GetProperty(
-          ycsbc::CoreWorkload::OPERATION_COUNT_PROPERTY + "." +
-              std::to_string(i),
+          ycsbc::CoreWorkload::OPERATION_COUNT_PROPERTY + tenant,
           props.GetProperty(ycsbc::CoreWorkload::OPERATION_COUNT_PROPERTY,
                             "0")));
       std::chrono::seconds maxexecutiontime =
           std::chrono::seconds(stoi(props.GetProperty(
-              MAX_EXECUTION_TIME_PROPERTY + "." + std::to_string(i),
+              MAX_EXECUTION_TIME_PROPERTY + tenant,
               props.GetProperty(MAX_EXECUTION_TIME_PROPERTY,
                                 MAX_EXECUTION_TIME_DEFAULT))));
 
       std::chrono::seconds sleepafterload = std::chrono::seconds(stoi(
-          props.GetProperty(SLEEP_AFTER_LOAD_PROPERTY + "." + std::to_string(i),
+          props.GetProperty(SLEEP_AFTER_LOAD_PROPERTY + tenant,
                             props.GetProperty(SLEEP_AFTER_LOAD_PROPERTY,
                                               SLEEP_AFTER_LOAD_DEFAULT))));
 
       client_threads.emplace_back(
           std::thread(ycsbc::ClientThread, sleepafterload, maxexecutiontime, i,
-                      dbs[i], wls[i], thread_ops, false, true));
+                      dbs[i], wls[tenant_of[i]], thread_ops, false, true,
+                      rate_profiles.back().get(), outstanding[i],
+                      offload_pool.get()));
     }
     assert((int)client_threads.size() == num_threads);
 
-    long sum = 0;
     for (int i = 0; i < num_threads; i++) {
       assert(client_threads[i].joinable());
       client_threads[i].join();
-      sum += wls[i]->GetExecutedOps();
+    }
+    long sum = 0;
+    for (auto wl : wls) {
+      sum += wl->GetExecutedOps();
     }
 
     done.store(true);
     double runtime = timer.End();
 
-    if (show_status) {
+    if (run_status) {
       status_thread.join();
+    } else {
+      SampleMeasurements(&measurements, gMeasurements);
+    }
+    if (hdr_log != nullptr) {
+      std::fclose(hdr_log);
     }
 
     (*output_stream) << "Run runtime(sec): " << runtime << std::endl;
@@ -305,9 +545,11 @@ int main(const int argc, const char *argv[]) {
                      << std::endl;
     (*output_stream) << gMeasurements->GetCDF() << std::endl;
 
-    for (int i = 0; i < num_threads; i++) {
-      delete dbs[i];
-      delete wls[i];
+    for (auto db : dbs) {
+      delete db;
+    }
+    for (auto wl : wls) {
+      delete wl;
     }
 
     if (redirected_output) {
@@ -9,6 +9,7 @@
 #ifndef YCSB_C_ZIPFIAN_GENERATOR_H_
 #define YCSB_C_ZIPFIAN_GENERATOR_H_
 
+#include <atomic>
 #include <cassert>
 #include <cmath>
 #include <cstdint>
@@ -79,7 +80,7 @@ class ZipfianGenerator : public Generator<uint64_t> {
   // Computed parameters for generating the distribution
   double theta_, zeta_n_, eta_, alpha_, zeta_2_;
   uint64_t count_for_zeta_; /// Number of items used to compute zeta_n
-  uint64_t last_value_;
+  std::atomic<uint64_t> last_value_;
   std::mutex mutex_;
   bool allow_count_decrease_;
 };
@@ -1,5 +1,6 @@
 #include "cachelib-lru.h"
 #include "core/db_factory.h"
+#include "core/offload_pool.h"
 #include <cachelib/allocator/HitsPerSlabStrategy.h>
 
 namespace {
@@ -44,28 +45,26 @@ const std::string PROP_POOL_REBALANCER_SLABS_DEFAULT = "1";
 namespace ycsbc {
 
 std::mutex CacheLibLRU::mutex_;
-std::unordered_map<std::string, std::tuple<RocksDB, CacheLibLRU::Cache, int>>
-    CacheLibLRU::rocksdbsAndCaches_;
+std::unordered_map<std::string, std::pair<CacheLibLRU::Cache, int>>
+    CacheLibLRU::caches_;
+std::unordered_map<std::string, std::pair<facebook::cachelib::PoolId, int>>
+    CacheLibLRU::pools_;
 
 void CacheLibLRU::Init() {
 
   std::lock_guard<std::mutex> lock(mutex_);
 
-  if (rocksdbsAndCaches_.empty()) {
-    rocksdbsAndCaches_.reserve(
-        std::stoi(props_->GetProperty("threadcount", "1")));
+  if (caches_.empty()) {
+    caches_.reserve(std::stoi(props_->GetProperty("threadcount", "1")));
   }
 
   cacheName_ = props_->GetProperty(
       PROP_CACHE_NAME + "." + std::to_string(threadId_),
       props_->GetProperty(PROP_CACHE_NAME, PROP_CACHE_NAME_DEFAULT));
 
-  if (auto it = rocksdbsAndCaches_.find(cacheName_);
-      it != rocksdbsAndCaches_.end()) {
-    cache_ = std::get<1>(it->second);
-    rocksdb_ = std::get<0>(it->second);
-    rocksdb_.Init();
-    ++std::get<2>(it->second); // increment ref count
+  if (auto it = caches_.find(cacheName_); it != caches_.end()) {
+    cache_ = it->second.first;
+    ++it->second.second; // increment ref count
   } else {
     Config config;
     config
@@ -122,14 +121,20 @@ void CacheLibLRU::Init() {
     }
     config.validate(); // will throw if bad config
     cache_ = std::make_shared<CacheLibLRU::CacheAllocator>(config);
-    rocksdb_.SetProps(props_);
-    rocksdb_.Init();
-    rocksdbsAndCaches_[cacheName_] = std::make_tuple(rocksdb_, cache_, 1);
+    caches_[cacheName_] = std::make_pair(cache_, 1);
   }
+  backend_.reset(NewBackend(props_));
+  backend_->Init();
   if (poolName_.empty()) {
     poolName_ = props_->GetProperty(
         PROP_POOL_NAME + "." + std::to_string(threadId_),
         props_->GetProperty(PROP_POOL_NAME, PROP_POOL_NAME_DEFAULT));
+    auto &[poolId, users] = pools_[poolName_ + "@" + cacheName_];
+    if (users++ > 0) {
+      // another thread of the tenant added the pool
+      poolId_ = poolId;
+      return;
+    }
     auto poolSize = std::stod(props_->GetProperty(
         PROP_POOL_SIZE + "." + std::to_string(threadId_),
         props_->GetProperty(PROP_POOL_SIZE, PROP_POOL_SIZE_DEFAULT)));
@@ -144,6 +149,7 @@ void CacheLibLRU::Init() {
             ? 0
             : static_cast<long>(cache_->getCacheMemoryStats().ramCacheSize *
                                 poolSize));
+    poolId = poolId_;
     // now it's safe to set cache_
   }
 }
@@ -154,7 +160,11 @@ DB::Status CacheLibLRU::Read(const std::string &table, const std::string &key,
   auto handle = cache_->find(key);
   auto status = handle != nullptr ? kOK : kNotFound;
   if (status == kNotFound) {
-    if (rocksdb_.Read(table, key, fields, result) == kOK) {
+    // the backend read may run on the offload pool, overlapping the other
+    // outstanding operations of the client thread
+    if (utils::Offload([&] {
+          return backend_->Read(table, key, fields, result);
+        }) == kOK) {
       uint32_t size = result.front().value.size();
       auto new_handle = cache_->allocate(poolId_, key, size);
       if (new_handle) {
@@ -167,7 +177,7 @@ DB::Status CacheLibLRU::Read(const std::string &table, const std::string &key,
         return kError;
       }
     } else {
-      std::cerr << "Key not found in RocksDB: " << key << std::endl;
+      std::cerr << "Key not found in backend: " << key << std::endl;
       std::abort();
     }
   } else {
@@ -191,7 +201,7 @@ DB::Status CacheLibLRU::Update(const std::string &table, const std::string &key,
   //  std::lock_guard<std::mutex> lock(mutex_);
   std::string data = values.front().value;
   uint32_t size = values.front().value.size();
-  if (rocksdb_.Update(table, key, values) == kOK) {
+  if (backend_->Update(table, key, values) == kOK) {
     auto handle = cache_->find(key);
     if (cache_->find(key) != nullptr) {
       auto new_handle = cache_->allocate(poolId_, key, size);
@@ -212,7 +222,7 @@ DB::Status CacheLibLRU::Insert(const std::string &table, const std::string &key,
   // std::lock_guard<std::mutex> lock(mutex_);
   uint32_t size = values.front().value.size();
   std::string data = values.front().value;
-  if (rocksdb_.Insert(table, key, values) == kOK) {
+  if (backend_->Insert(table, key, values) == kOK) {
     auto handle = cache_->find(key);
     if (cache_->find(key) != nullptr) {
       auto new_handle = cache_->allocate(poolId_, key, size);
@@ -243,12 +253,16 @@ const bool registered = DBFactory::RegisterDB("cachelib-lru", NewCacheLibLRU);
 
 void CacheLibLRU::Cleanup() {
   std::lock_guard<std::mutex> lock(mutex_);
-  rocksdb_.Cleanup();
+  backend_->Cleanup();
   cache_ = nullptr;
+  auto const kPool = poolName_ + "@" + cacheName_;
+  if (--pools_[kPool].second == 0) {
+    pools_.erase(kPool);
+  }
   poolName_.clear();
-  auto &[x, y, refCount] = rocksdbsAndCaches_[cacheName_];
+  auto &[x, refCount] = caches_[cacheName_];
   if (refCount == 1) {
-    rocksdbsAndCaches_.erase(cacheName_);
+    caches_.erase(cacheName_);
   } else {
     --refCount;
   }
@@ -1,8 +1,9 @@
 #pragma once
 
-#include "rocksdb.h"
+#include "emulator.h"
 #include <cachelib/allocator/CacheAllocator.h>
 #include <core/db.h>
+#include <memory>
 #include <unordered_map>
 
 namespace ycsbc {
@@ -16,15 +17,20 @@ public:
 
 private:
   static std::mutex mutex_;
-  static std::unordered_map<std::string, std::tuple<RocksDB, Cache, int>>
-      rocksdbsAndCaches_;
+  static std::unordered_map<std::string, std::pair<Cache, int>> caches_;
+  // pools and their number of users by <pool>@<cache>, shared by the
+  // threads of a tenant
+  static std::unordered_map<std::string,
+                            std::pair<facebook::cachelib::PoolId, int>>
+      pools_;
 
   int const threadId_;
   Cache cache_ = nullptr;
   std::string cacheName_;
   std::string poolName_ = "";
   facebook::cachelib::PoolId poolId_;
-  RocksDB rocksdb_;
+  // RocksDB, or its in-memory emulator
+  std::unique_ptr<DB> backend_;
 
 public:
   explicit CacheLibLRU2Q(int threadId) : threadId_(threadId) {}
@@ -47,6 +47,8 @@ namespace ycsbc {
 std::mutex CacheLibOverhead::mutex_;
 std::unordered_map<std::string, std::pair<CacheLibOverhead::Cache, int>>
     CacheLibOverhead::caches_;
+std::unordered_map<std::string, std::pair<facebook::cachelib::PoolId, int>>
+    CacheLibOverhead::pools_;
 
 void CacheLibOverhead::Init() {
 
@@ -136,6 +138,12 @@ void CacheLibOverhead::Init() {
     poolName_ = props_->GetProperty(
         PROP_POOL_NAME + "." + std::to_string(threadId_),
         props_->GetProperty(PROP_POOL_NAME, PROP_POOL_NAME_DEFAULT));
+    auto &[poolId, users] = pools_[poolName_ + "@" + cacheName_];
+    if (users++ > 0) {
+      // another thread of the tenant added the pool
+      poolId_ = poolId;
+      return;
+    }
     auto poolSize = std::stod(props_->GetProperty(
         PROP_POOL_SIZE + "." + std::to_string(threadId_),
         props_->GetProperty(PROP_POOL_SIZE, PROP_POOL_SIZE_DEFAULT)));
@@ -143,6 +151,7 @@ void CacheLibOverhead::Init() {
     poolId_ = cache_->addPool(
         poolName_, static_cast<long>(
                        cache_->getCacheMemoryStats().ramCacheSize * poolSize));
+    poolId = poolId_;
   }
 }
 
@@ -222,6 +231,10 @@ const bool registered =
 void CacheLibOverhead::Cleanup() {
   std::lock_guard<std::mutex> lock(mutex_);
   cache_ = nullptr;
+  auto const kPool = poolName_ + "@" + cacheName_;
+  if (--pools_[kPool].second == 0) {
+    pools_.erase(kPool);
+  }
   poolName_.clear();
   auto &[_, refCount] = caches_[cacheName_];
   if (refCount == 1) {
@@ -17,6 +17,11 @@ public:
 private:
   static std::mutex mutex_;
   static std::unordered_map<std::string, std::pair<Cache, int>> caches_;
+  // pools and their number of users by <pool>@<cache>, shared by the
+  // threads of a tenant
+  static std::unordered_map<std::string,
+                            std::pair<facebook::cachelib::PoolId, int>>
+      pools_;
 
   int const threadId_;
   Cache cache_ = nullptr;
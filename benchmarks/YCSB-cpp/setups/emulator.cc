@@ -0,0 +1,373 @@
+#include "emulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <sstream>
+
+#include "core/db_factory.h"
+#include "core/fiber.h"
+#include "core/utils.h"
+#include "rocksdb.h"
+
+namespace {
+
+const std::string PROP_BACKEND = "backend";
+const std::string PROP_BACKEND_DEFAULT = "rocksdb";
+
+const std::string PROP_VALUES = "emulator.values";
+const std::string PROP_VALUES_DEFAULT = "stored";
+
+const std::string PROP_VALUE_SIZE = "emulator.valuesize";
+const std::string PROP_VALUE_SIZE_DEFAULT = "100";
+
+const std::string PROP_LATENCY = "emulator.latency";
+const std::string PROP_LATENCY_DEFAULT = "constant";
+
+const std::string PROP_LATENCY_US = "emulator.latency.us";
+const std::string PROP_LATENCY_US_DEFAULT = "100";
+
+const std::string PROP_LATENCY_SIGMA = "emulator.latency.sigma";
+const std::string PROP_LATENCY_SIGMA_DEFAULT = "0.5";
+
+const std::string PROP_LATENCY_HISTOGRAM = "emulator.latency.histogram";
+
+const std::string PROP_CONCURRENCY = "emulator.concurrency";
+const std::string PROP_CONCURRENCY_DEFAULT = "0";
+
+const std::string PROP_SEED = "emulator.seed";
+const std::string PROP_SEED_DEFAULT = "0";
+
+// generated values are slices of a fixed pseudo-random buffer
+constexpr size_t kGeneratedValuesSize = 4 << 20;
+
+} // namespace
+
+namespace ycsbc {
+
+std::mutex BackendEmulator::mutex_;
+int BackendEmulator::refCount_ = 0;
+std::array<BackendEmulator::Shard, BackendEmulator::kShards>
+    BackendEmulator::shards_;
+
+bool BackendEmulator::generated_ = false;
+uint32_t BackendEmulator::valueSize_ = 0;
+std::string BackendEmulator::generatedValues_;
+
+BackendEmulator::Latency BackendEmulator::latency_ =
+    BackendEmulator::Latency::kNone;
+std::chrono::nanoseconds BackendEmulator::constantLatency_{0};
+std::lognormal_distribution<double>::param_type BackendEmulator::lognormal_;
+std::vector<double> BackendEmulator::histogramMicros_;
+std::discrete_distribution<size_t>::param_type BackendEmulator::histogram_;
+uint64_t BackendEmulator::seed_ = 0;
+std::atomic<uint64_t> BackendEmulator::streams_{0};
+
+std::mutex BackendEmulator::channelsMutex_;
+std::vector<BackendEmulator::Clock::time_point> BackendEmulator::channels_;
+
+void BackendEmulator::Init() {
+  const std::lock_guard<std::mutex> lock(mutex_);
+
+  if (refCount_++) {
+    return;
+  }
+
+  const std::string values =
+      props_->GetProperty(PROP_VALUES, PROP_VALUES_DEFAULT);
+  if (values != "stored" && values != "generated") {
+    throw utils::Exception("Unknown emulator.values: " + values);
+  }
+  generated_ = values == "generated";
+  valueSize_ =
+      std::stoul(props_->GetProperty(PROP_VALUE_SIZE, PROP_VALUE_SIZE_DEFAULT));
+  seed_ = std::stoull(props_->GetProperty(PROP_SEED, PROP_SEED_DEFAULT));
+
+  if (generated_ && generatedValues_.empty()) {
+    std::mt19937_64 generator(seed_);
+    std::uniform_int_distribution<int> printable(' ', '~');
+    generatedValues_.resize(kGeneratedValuesSize);
+    for (char &c : generatedValues_) {
+      c = static_cast<char>(printable(generator));
+    }
+  }
+
+  const std::string latency =
+      props_->GetProperty(PROP_LATENCY, PROP_LATENCY_DEFAULT);
+  const double micros = std::stod(
+      props_->GetProperty(PROP_LATENCY_US, PROP_LATENCY_US_DEFAULT));
+  if (latency == "none") {
+    latency_ = Latency::kNone;
+  } else if (latency == "constant") {
+    latency_ = Latency::kConstant;
+    constantLatency_ = std::chrono::nanoseconds(
+        static_cast<int64_t>(micros * 1000));
+  } else if (latency == "lognormal") {
+    // parameterized by its mean, as the other distributions
+    const double sigma = std::stod(
+        props_->GetProperty(PROP_LATENCY_SIGMA, PROP_LATENCY_SIGMA_DEFAULT));
+    if (micros <= 0 || sigma < 0) {
+      throw utils::Exception("Invalid emulator lognormal latency");
+    }
+    latency_ = Latency::kLognormal;
+    lognormal_ = std::lognormal_distribution<double>::param_type(
+        std::log(micros) - sigma * sigma / 2, sigma);
+  } else if (latency == "histogram") {
+    latency_ = Latency::kHistogram;
+    if (!props_->ContainsKey(PROP_LATENCY_HISTOGRAM)) {
+      throw utils::Exception("emulator.latency.histogram is missing");
+    }
+    LoadHistogram(props_->GetProperty(PROP_LATENCY_HISTOGRAM));
+  } else {
+    throw utils::Exception("Unknown emulator.latency: " + latency);
+  }
+
+  const int concurrency = std::stoi(
+      props_->GetProperty(PROP_CONCURRENCY, PROP_CONCURRENCY_DEFAULT));
+  channels_.assign(std::max(concurrency, 0), Clock::time_point::min());
+}
+
+// Records are kept for the whole process, as RocksDB's data on disk, so a
+// run phase finds what the load phase inserted (e.g., with cleanupafterload)
+void BackendEmulator::Cleanup() {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  --refCount_;
+}
+
+// One bucket per line: "<latency in us> <weight>", '#' starting a comment
+void BackendEmulator::LoadHistogram(const std::string &path) {
+  std::ifstream file(path);
+  if (!file) {
+    throw utils::Exception("Cannot open latency histogram: " + path);
+  }
+  std::vector<double> weights;
+  histogramMicros_.clear();
+  std::string line;
+  while (std::getline(file, line)) {
+    line = utils::Trim(line.substr(0, line.find('#')));
+    if (line.empty()) {
+      continue;
+    }
+    std::replace(line.begin(), line.end(), ',', ' ');
+    std::istringstream fields(line);
+    double micros, weight;
+    if (!(fields >> micros >> weight) || micros < 0 || weight < 0) {
+      throw utils::Exception("Invalid latency histogram line: " + line);
+    }
+    histogramMicros_.push_back(micros);
+    weights.push_back(weight);
+  }
+  if (histogramMicros_.empty()) {
+    throw utils::Exception("Empty latency histogram: " + path);
+  }
+  if (std::all_of(weights.begin(), weights.end(),
+                  [](double weight) { return weight == 0; })) {
+    throw utils::Exception("Latency histogram weights are all zero: " + path);
+  }
+  histogram_ = std::discrete_distribution<size_t>::param_type(weights.begin(),
+                                                              weights.end());
+}
+
+BackendEmulator::Shard &BackendEmulator::ShardOf(const std::string &key) {
+  return shards_[std::hash<std::string>{}(key) % kShards];
+}
+
+// Deterministic in the key: the same key always reads the same bytes
+std::string_view BackendEmulator::GeneratedValue(const std::string &key,
+                                                 uint32_t size) {
+  if (size > generatedValues_.size()) {
+    throw utils::Exception("Emulated value larger than the generated buffer");
+  }
+  size_t offset = std::hash<std::string>{}(key) %
+                  (generatedValues_.size() - size + 1);
+  return std::string_view(generatedValues_.data() + offset, size);
+}
+
+std::chrono::nanoseconds BackendEmulator::SampleLatency() {
+  // one stream per thread, so that sampling takes no lock; streams are
+  // assigned in the order threads first sample, so the seed fixes the set
+  // of streams but not which thread draws from which
+  static thread_local std::mt19937_64 generator(
+      seed_ ^ utils::Hash(streams_++));
+  double micros;
+  switch (latency_) {
+  case Latency::kConstant:
+    return constantLatency_;
+  case Latency::kLognormal:
+    micros = std::lognormal_distribution<double>()(generator, lognormal_);
+    break;
+  case Latency::kHistogram:
+    micros = histogramMicros_[std::discrete_distribution<size_t>()(
+        generator, histogram_)];
+    break;
+  default:
+    return std::chrono::nanoseconds(0);
+  }
+  return std::chrono::nanoseconds(static_cast<int64_t>(micros * 1000));
+}
+
+// Waits for a read to be served: with a concurrency cap, the read starts
+// on the channel free the earliest, queueing behind the reads issued before
+// it once all channels are busy. Fibers of the thread run meanwhile.
+void BackendEmulator::AwaitDevice() {
+  if (latency_ == Latency::kNone) {
+    return;
+  }
+  const auto now = Clock::now();
+  const auto service = SampleLatency();
+  auto done = now + service;
+  if (!channels_.empty()) {
+    std::lock_guard<std::mutex> lock(channelsMutex_);
+    std::pop_heap(channels_.begin(), channels_.end(), std::greater<>());
+    done = std::max(now, channels_.back()) + service;
+    channels_.back() = done;
+    std::push_heap(channels_.begin(), channels_.end(), std::greater<>());
+  }
+  utils::SleepUntil(done);
+}
+
+DB::Status BackendEmulator::Read(const std::string &table,
+                                 const std::string &key,
+                                 const std::vector<std::string> *fields,
+                                 std::vector<Field> &result) {
+  Status status = kOK;
+  auto &shard = ShardOf(key);
+  if (generated_) {
+    uint32_t size = valueSize_;
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      if (auto it = shard.sizes.find(key); it != shard.sizes.end()) {
+        size = it->second;
+      }
+    }
+    result.clear();
+    result.push_back({"", std::string(GeneratedValue(key, size))});
+  } else {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.rows.find(key);
+    if (it == shard.rows.end()) {
+      status = kNotFound;
+    } else if (fields == nullptr) {
+      result = it->second;
+    } else {
+      result.clear();
+      for (const Field &field : it->second) {
+        if (std::find(fields->begin(), fields->end(), field.name) !=
+            fields->end()) {
+          result.push_back(field);
+        }
+      }
+    }
+  }
+  // misses are answered from memory (as by RocksDB's filters), not the device
+  if (status == kOK) {
+    AwaitDevice();
+  }
+  return status;
+}
+
+DB::Status BackendEmulator::Scan(const std::string &table,
+                                 const std::string &key, long len,
+                                 const std::vector<std::string> *fields,
+                                 std::vector<std::vector<Field>> &result) {
+  return kNotImplemented;
+}
+
+// Writes are absorbed in memory, as by RocksDB's memtable, without latency
+DB::Status BackendEmulator::Update(const std::string &table,
+                                   const std::string &key,
+                                   std::vector<Field> &values) {
+  auto &shard = ShardOf(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  if (generated_) {
+    shard.sizes[key] = values.front().value.size();
+    return kOK;
+  }
+  auto it = shard.rows.find(key);
+  if (it == shard.rows.end()) {
+    return kNotFound;
+  }
+  for (Field &new_field : values) {
+    auto field = std::find_if(
+        it->second.begin(), it->second.end(),
+        [&](const Field &field) { return field.name == new_field.name; });
+    if (field != it->second.end()) {
+      field->value = new_field.value;
+    }
+  }
+  return kOK;
+}
+
+DB::Status BackendEmulator::Insert(const std::string &table,
+                                   const std::string &key,
+                                   std::vector<Field> &values) {
+  auto &shard = ShardOf(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  if (generated_) {
+    shard.sizes[key] = values.front().value.size();
+  } else {
+    shard.rows[key] = values;
+  }
+  return kOK;
+}
+
+DB::Status BackendEmulator::Update(const std::string &table,
+                                   const std::string &key,
+                                   std::string_view value) {
+  auto &shard = ShardOf(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  if (generated_) {
+    shard.sizes[key] = value.size();
+    return kOK;
+  }
+  auto it = shard.rows.find(key);
+  if (it == shard.rows.end()) {
+    return kNotFound;
+  }
+  it->second.assign(1, Field{"", std::string(value)});
+  return kOK;
+}
+
+DB::Status BackendEmulator::Insert(const std::string &table,
+                                   const std::string &key,
+                                   std::string_view value) {
+  auto &shard = ShardOf(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  if (generated_) {
+    shard.sizes[key] = value.size();
+  } else {
+    shard.rows[key].assign(1, Field{"", std::string(value)});
+  }
+  return kOK;
+}
+
+DB::Status BackendEmulator::Delete(const std::string &table,
+                                   const std::string &key) {
+  auto &shard = ShardOf(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  shard.rows.erase(key);
+  shard.sizes.erase(key);
+  return kOK;
+}
+
+DB *NewBackendEmulator(int threadId) { return new BackendEmulator(); }
+
+const bool registered = DBFactory::RegisterDB("emulator", NewBackendEmulator);
+
+DB *NewBackend(utils::Properties *props) {
+  const std::string backend =
+      props->GetProperty(PROP_BACKEND, PROP_BACKEND_DEFAULT);
+  DB *db;
+  if (backend == "rocksdb") {
+    db = new RocksDB();
+  } else if (backend == "emulator") {
+    db = new BackendEmulator();
+  } else {
+    throw utils::Exception("Unknown backend: " + backend);
+  }
+  db->SetProps(props);
+  return db;
+}
+
+} // namespace ycsbc
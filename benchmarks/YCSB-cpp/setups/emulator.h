@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "core/db.h"
+#include "core/properties.h"
+
+namespace ycsbc {
+
+// In-memory stand-in for the RocksDB backend of the cache setups: records
+// are kept in memory, or generated from their key, and each read waits for
+// a latency drawn from a configurable distribution on one of a bounded
+// number of device channels, so that reads queue up once the emulated
+// device saturates. The state is shared by all instances, as RocksDB's, and
+// the records outlive them for the whole process.
+class BackendEmulator : public DB {
+  using Clock = std::chrono::steady_clock;
+
+  enum class Latency { kNone, kConstant, kLognormal, kHistogram };
+
+  static constexpr size_t kShards = 64;
+
+  struct Shard {
+    std::mutex mutex;
+    std::unordered_map<std::string, std::vector<Field>> rows;
+    // value sizes of the records written when values are generated
+    std::unordered_map<std::string, uint32_t> sizes;
+  };
+
+  static std::mutex mutex_;
+  static int refCount_;
+  static std::array<Shard, kShards> shards_;
+
+  static bool generated_;
+  static uint32_t valueSize_;
+  static std::string generatedValues_;
+
+  static Latency latency_;
+  static std::chrono::nanoseconds constantLatency_;
+  static std::lognormal_distribution<double>::param_type lognormal_;
+  static std::vector<double> histogramMicros_;
+  static std::discrete_distribution<size_t>::param_type histogram_;
+  static uint64_t seed_;
+  static std::atomic<uint64_t> streams_;
+
+  // times the device channels become free, as a min-heap
+  static std::mutex channelsMutex_;
+  static std::vector<Clock::time_point> channels_;
+
+  static Shard &ShardOf(const std::string &key);
+
+  static void LoadHistogram(const std::string &path);
+
+  std::string_view GeneratedValue(const std::string &key, uint32_t size);
+
+  std::chrono::nanoseconds SampleLatency();
+
+  void AwaitDevice();
+
+public:
+  Status Read(const std::string &table, const std::string &key,
+              const std::vector<std::string> *fields,
+              std::vector<Field> &result);
+
+  Status Scan(const std::string &table, const std::string &key, long len,
+              const std::vector<std::string> *fields,
+              std::vector<std::vector<Field>> &result);
+
+  Status Update(const std::string &table, const std::string &key,
+                std::vector<Field> &values);
+
+  Status Insert(const std::string &table, const std::string &key,
+                std::vector<Field> &values);
+
+  Status Update(const std::string &table, const std::string &key,
+                std::string_view value);
+
+  Status Insert(const std::string &table, const std::string &key,
+                std::string_view value);
+
+  Status Delete(const std::string &table, const std::string &key);
+
+  void Init();
+  void Cleanup();
+
+  std::tuple<std::string, std::string, uint64_t, uint64_t, uint64_t, uint64_t>
+  OccupancyCapacityAndGlobal() {
+    return std::make_tuple("", "", 0, 0, 0, 0);
+  }
+};
+
+DB *NewBackendEmulator(int threadId);
+
+// Backend behind the cache of a setup, selected by the "backend" property:
+// "rocksdb" (default) or "emulator"
+DB *NewBackend(utils::Properties *props);
+
+} // namespace ycsbc
@@ -14,6 +14,12 @@ const std::string PROP_SIZE_DEFAULT = "1000000000";
 const std::string PROP_ORCHESTRATOR_ADDRESS = "holpaca.orchestrator.address";
 const std::string PROP_ORCHESTRATOR_ADDRESS_DEFAULT = "";
 
+const std::string PROP_DOMAIN = "holpaca.domain";
+const std::string PROP_DOMAIN_DEFAULT = "";
+
+const std::string PROP_CHANGE_THRESHOLD = "holpaca.changethreshold";
+const std::string PROP_CHANGE_THRESHOLD_DEFAULT = "0.0";
+
 const std::string PROP_AGENT_ADDRESS = "holpaca.agent.address";
 const std::string PROP_AGENT_ADDRESS_DEFAULT = "";
 
@@ -50,6 +56,8 @@ namespace ycsbc {
 std::mutex CacheLibHolpacaOverhead::mutex_;
 std::unordered_map<std::string, std::pair<CacheLibHolpacaOverhead::Cache, int>>
     CacheLibHolpacaOverhead::caches_;
+std::unordered_map<std::string, std::pair<holpaca::PoolId, int>>
+    CacheLibHolpacaOverhead::pools_;
 
 void CacheLibHolpacaOverhead::Init() {
 
@@ -90,6 +98,13 @@ void CacheLibHolpacaOverhead::Init() {
     if (!orchestratorAddress.empty()) {
       config.setOrchestratorAddress(orchestratorAddress);
     }
+    config.setDomain(props_->GetProperty(
+        PROP_DOMAIN + "." + std::to_string(threadId_),
+        props_->GetProperty(PROP_DOMAIN, PROP_DOMAIN_DEFAULT)));
+    config.setChangeThreshold(std::stod(props_->GetProperty(
+        PROP_CHANGE_THRESHOLD + "." + std::to_string(threadId_),
+        props_->GetProperty(PROP_CHANGE_THRESHOLD,
+                            PROP_CHANGE_THRESHOLD_DEFAULT))));
 
     if (props_->GetProperty(
             PROP_POOL_REBALANCER + "." + std::to_string(threadId_),
@@ -146,6 +161,12 @@ void CacheLibHolpacaOverhead::Init() {
     poolName_ = props_->GetProperty(
         PROP_POOL_NAME + "." + std::to_string(threadId_),
         props_->GetProperty(PROP_POOL_NAME, PROP_POOL_NAME_DEFAULT));
+    auto &[poolId, users] = pools_[poolName_ + "@" + cacheName_];
+    if (users++ > 0) {
+      // another thread of the tenant added the pool
+      poolId_ = poolId;
+      return;
+    }
     auto poolSize = std::stod(props_->GetProperty(
         PROP_POOL_SIZE + "." + std::to_string(threadId_),
         props_->GetProperty(PROP_POOL_SIZE, PROP_POOL_SIZE_DEFAULT)));
@@ -153,6 +174,7 @@ void CacheLibHolpacaOverhead::Init() {
     poolId_ = cache_->addPool(
         poolName_, static_cast<long>(
                        cache_->getCacheMemoryStats().ramCacheSize * poolSize));
+    poolId = poolId_;
   }
 }
 
@@ -228,6 +250,10 @@ const bool registered =
 void CacheLibHolpacaOverhead::Cleanup() {
   std::lock_guard<std::mutex> lock(mutex_);
   cache_ = nullptr;
+  auto const kPool = poolName_ + "@" + cacheName_;
+  if (--pools_[kPool].second == 0) {
+    pools_.erase(kPool);
+  }
   poolName_.clear();
   auto &[_, refCount] = caches_[cacheName_];
   if (refCount == 1) {
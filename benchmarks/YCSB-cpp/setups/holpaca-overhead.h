@@ -16,6 +16,10 @@ public:
 private:
   static std::mutex mutex_;
   static std::unordered_map<std::string, std::pair<Cache, int>> caches_;
+  // pools and their number of users by <pool>@<cache>, shared by the
+  // threads of a tenant
+  static std::unordered_map<std::string, std::pair<holpaca::PoolId, int>>
+      pools_;
 
   int const threadId_;
   Cache cache_ = nullptr;
@@ -64,6 +68,11 @@ public:
 
   void Cleanup() override;
 
+  std::pair<uint64_t, uint64_t> HitsAndMisses() override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return {missesAndHits_.second, missesAndHits_.first};
+  }
+
   std::tuple<std::string, std::string, uint64_t, uint64_t, uint64_t, uint64_t>
   OccupancyCapacityAndGlobal() {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -1,5 +1,7 @@
 #include "holpaca.h"
 #include "core/db_factory.h"
+#include "core/offload_pool.h"
+#include <algorithm>
 #include <cachelib/allocator/HitsPerSlabStrategy.h>
 
 namespace {
@@ -18,6 +20,12 @@ const std::string PROP_PROPORTION_DEFAULT = "1.0";
 const std::string PROP_ORCHESTRATOR_ADDRESS = "holpaca.orchestrator.address";
 const std::string PROP_ORCHESTRATOR_ADDRESS_DEFAULT = "";
 
+const std::string PROP_DOMAIN = "holpaca.domain";
+const std::string PROP_DOMAIN_DEFAULT = "";
+
+const std::string PROP_CHANGE_THRESHOLD = "holpaca.changethreshold";
+const std::string PROP_CHANGE_THRESHOLD_DEFAULT = "0.0";
+
 const std::string PROP_STAGE_ADDRESS = "holpaca.agent.address";
 const std::string PROP_STAGE_ADDRESS_DEFAULT = "";
 
@@ -30,9 +38,18 @@ const std::string PROP_POOL_SIZE_DEFAULT = "1";
 const std::string PROP_POOL_QOS_LEVEL = "holpaca.pool.qos";
 const std::string PROP_POOL_QOS_LEVEL_DEFAULT = "0.0";
 
+const std::string PROP_POOL_LATENCY_SLO = "holpaca.pool.latencyslo";
+const std::string PROP_POOL_LATENCY_SLO_DEFAULT = "0.0";
+
 const std::string PROP_POOL_PROPORTION = "holpaca.pool.proportion";
 const std::string PROP_POOL_PROPORTION_DEFAULT = "1.0";
 
+const std::string PROP_POOL_RESERVATION = "holpaca.pool.reservation";
+const std::string PROP_POOL_RESERVATION_DEFAULT = "0";
+
+const std::string PROP_POOL_LIMIT = "holpaca.pool.limit";
+const std::string PROP_POOL_LIMIT_DEFAULT = "0";
+
 const std::string PROP_POOL_NO_INITIAL_SIZE = "holpaca.pool.noinitialsize";
 const std::string PROP_POOL_NO_INITIAL_SIZE_DEFAULT = "off";
 
@@ -61,29 +78,26 @@ const std::string PROP_POOL_REBALANCER_SLABS_DEFAULT = "1";
 namespace ycsbc {
 
 std::mutex CacheLibHolpaca::mutex_;
-std::unordered_map<std::string,
-                   std::tuple<RocksDB, CacheLibHolpaca::Cache, int>>
-    CacheLibHolpaca::rocksdbsAndCaches_;
+std::unordered_map<std::string, std::pair<CacheLibHolpaca::Cache, int>>
+    CacheLibHolpaca::caches_;
+std::unordered_map<std::string, CacheLibHolpaca::Pool>
+    CacheLibHolpaca::pools_;
 
 void CacheLibHolpaca::Init() {
 
   std::lock_guard<std::mutex> lock(mutex_);
 
-  if (rocksdbsAndCaches_.empty()) {
-    rocksdbsAndCaches_.reserve(
-        std::stoi(props_->GetProperty("threadcount", "1")));
+  if (caches_.empty()) {
+    caches_.reserve(std::stoi(props_->GetProperty("threadcount", "1")));
   }
 
   cacheName_ = props_->GetProperty(
       PROP_CACHE_NAME + "." + std::to_string(threadId_),
       props_->GetProperty(PROP_CACHE_NAME, PROP_CACHE_NAME_DEFAULT));
 
-  if (auto it = rocksdbsAndCaches_.find(cacheName_);
-      it != rocksdbsAndCaches_.end()) {
-    cache_ = std::get<1>(it->second);
-    rocksdb_ = std::get<0>(it->second);
-    rocksdb_.Init();
-    ++std::get<2>(it->second); // increment ref count
+  if (auto it = caches_.find(cacheName_); it != caches_.end()) {
+    cache_ = it->second.first;
+    ++it->second.second; // increment ref count
   } else {
     Config config;
     config
@@ -119,6 +133,13 @@ void CacheLibHolpaca::Init() {
     if (!orchestratorAddress.empty()) {
       config.setOrchestratorAddress(orchestratorAddress);
     }
+    config.setDomain(props_->GetProperty(
+        PROP_DOMAIN + "." + std::to_string(threadId_),
+        props_->GetProperty(PROP_DOMAIN, PROP_DOMAIN_DEFAULT)));
+    config.setChangeThreshold(std::stod(props_->GetProperty(
+        PROP_CHANGE_THRESHOLD + "." + std::to_string(threadId_),
+        props_->GetProperty(PROP_CHANGE_THRESHOLD,
+                            PROP_CHANGE_THRESHOLD_DEFAULT))));
     if (props_->GetProperty(
             PROP_POOL_REBALANCER + "." + std::to_string(threadId_),
             props_->GetProperty(PROP_POOL_REBALANCER,
@@ -164,14 +185,21 @@ void CacheLibHolpaca::Init() {
     }
     config.validate(); // will throw if bad config
     cache_ = std::make_shared<CacheLibHolpaca::CacheAllocator>(config);
-    rocksdb_.SetProps(props_);
-    rocksdb_.Init();
-    rocksdbsAndCaches_[cacheName_] = std::make_tuple(rocksdb_, cache_, 1);
+    caches_[cacheName_] = std::make_pair(cache_, 1);
   }
+  backend_.reset(NewBackend(props_));
+  backend_->Init();
   if (poolName_.empty()) {
     poolName_ = props_->GetProperty(
         PROP_POOL_NAME + "." + std::to_string(threadId_),
         props_->GetProperty(PROP_POOL_NAME, PROP_POOL_NAME_DEFAULT));
+    auto &shared = pools_[poolName_ + "@" + cacheName_];
+    shared.users.push_back(this);
+    if (shared.users.size() > 1) {
+      // another thread of the tenant added the pool
+      poolId_ = shared.id;
+      return;
+    }
     auto poolSize = std::stod(props_->GetProperty(
         PROP_POOL_SIZE + "." + std::to_string(threadId_),
         props_->GetProperty(PROP_POOL_SIZE, PROP_POOL_SIZE_DEFAULT)));
@@ -187,13 +215,27 @@ void CacheLibHolpaca::Init() {
         PROP_POOL_PROPORTION + "." + std::to_string(threadId_),
         props_->GetProperty(PROP_POOL_PROPORTION,
                             PROP_POOL_PROPORTION_DEFAULT)));
+    double latencySLO = std::stod(props_->GetProperty(
+        PROP_POOL_LATENCY_SLO + "." + std::to_string(threadId_),
+        props_->GetProperty(PROP_POOL_LATENCY_SLO,
+                            PROP_POOL_LATENCY_SLO_DEFAULT)));
     poolId_ = cache_->addPool(
         poolName_,
         dontSetPoolSize
             ? 0
             : static_cast<long>(cache_->getCacheMemoryStats().ramCacheSize *
                                 poolSize),
-        qosLevel, proportion);
+        qosLevel, proportion, latencySLO);
+    cache_->setSizeBounds(
+        poolId_,
+        std::stoull(props_->GetProperty(
+            PROP_POOL_RESERVATION + "." + std::to_string(threadId_),
+            props_->GetProperty(PROP_POOL_RESERVATION,
+                                PROP_POOL_RESERVATION_DEFAULT))),
+        std::stoull(props_->GetProperty(
+            PROP_POOL_LIMIT + "." + std::to_string(threadId_),
+            props_->GetProperty(PROP_POOL_LIMIT, PROP_POOL_LIMIT_DEFAULT))));
+    shared.id = poolId_;
   }
 } // namespace ycsbc
 
@@ -201,12 +243,17 @@ DB::Status CacheLibHolpaca::Read(const std::string &table,
                                  const std::string &key,
                                  const std::vector<std::string> *fields,
                                  std::vector<Field> &result) {
+  auto const start = std::chrono::steady_clock::now();
   auto handle = cache_->find(key);
   auto status = handle != nullptr ? kOK : kNotFound;
   if (status == kNotFound) {
-    rocksdbIOPS_++;
-    missesAndHits_.first++;
-    if (rocksdb_.Read(table, key, fields, result) == kOK) {
+    rocksdbIOPS_.fetch_add(1, std::memory_order_relaxed);
+    missesAndHits_.first.fetch_add(1, std::memory_order_relaxed);
+    // the backend read may run on the offload pool, overlapping the other
+    // outstanding operations of the client thread
+    if (utils::Offload([&] {
+          return backend_->Read(table, key, fields, result);
+        }) == kOK) {
       uint32_t size = result.front().value.size();
       auto new_handle = cache_->allocate(poolId_, key, size);
       if (new_handle) {
@@ -219,17 +266,21 @@ DB::Status CacheLibHolpaca::Read(const std::string &table,
         //              std::cerr << "Failed to allocate memory for key: "
         //              << key
         //                        << std::endl;
+        cache_->recordLatency(poolId_, false,
+                              std::chrono::steady_clock::now() - start);
         return kError;
       }
     } else {
-      std::cerr << "Key not found in RocksDB: " << key << std::endl;
+      std::cerr << "Key not found in backend: " << key << std::endl;
       std::abort();
     }
   } else {
-    missesAndHits_.second++;
+    missesAndHits_.second.fetch_add(1, std::memory_order_relaxed);
     volatile auto data = std::string(
         reinterpret_cast<const char *>(handle->getMemory()), handle->getSize());
   }
+  cache_->recordLatency(poolId_, status == kOK,
+                        std::chrono::steady_clock::now() - start);
   return status;
 }
 
@@ -249,7 +300,7 @@ DB::Status CacheLibHolpaca::Update(const std::string &table,
   //  std::lock_guard<std::mutex> lock(mutex_);
   std::string data = values.front().value;
   uint32_t size = values.front().value.size();
-  if (rocksdb_.Update(table, key, values) == kOK) {
+  if (backend_->Update(table, key, values) == kOK) {
     auto handle = cache_->find(key);
     if (cache_->find(key) != nullptr) {
       auto new_handle = cache_->allocate(poolId_, key, size);
@@ -271,7 +322,7 @@ DB::Status CacheLibHolpaca::Insert(const std::string &table,
   // std::lock_guard<std::mutex> lock(mutex_);
   uint32_t size = values.front().value.size();
   std::string data = values.front().value;
-  if (rocksdb_.Insert(table, key, values) == kOK) {
+  if (backend_->Insert(table, key, values) == kOK) {
     auto handle = cache_->find(key);
     if (cache_->find(key) != nullptr) {
       auto new_handle = cache_->allocate(poolId_, key, size);
@@ -287,6 +338,42 @@ DB::Status CacheLibHolpaca::Insert(const std::string &table,
   return kError;
 }
 
+DB::Status CacheLibHolpaca::Update(const std::string &table,
+                                   const std::string &key,
+                                   std::string_view value) {
+  if (backend_->Update(table, key, value) == kOK) {
+    if (cache_->find(key) != nullptr) {
+      auto new_handle = cache_->allocate(poolId_, key, value.size());
+      if (new_handle) {
+        std::memcpy(new_handle->getMemory(), value.data(), value.size());
+        cache_->insertOrReplace(new_handle);
+        return kOK;
+      }
+    } else {
+      return kOK;
+    }
+  }
+  return kError;
+}
+
+DB::Status CacheLibHolpaca::Insert(const std::string &table,
+                                   const std::string &key,
+                                   std::string_view value) {
+  if (backend_->Insert(table, key, value) == kOK) {
+    if (cache_->find(key) != nullptr) {
+      auto new_handle = cache_->allocate(poolId_, key, value.size());
+      if (new_handle) {
+        std::memcpy(new_handle->getMemory(), value.data(), value.size());
+        cache_->insertOrReplace(new_handle);
+        return kOK;
+      }
+    } else {
+      return kOK;
+    }
+  }
+  return kError;
+}
+
 DB::Status CacheLibHolpaca::Delete(const std::string &table,
                                    const std::string &key) {
   std::lock_guard<std::mutex> lock(mutex_);
@@ -302,13 +389,27 @@ const bool registered = DBFactory::RegisterDB("holpaca", NewCacheLibHolpaca);
 
 void CacheLibHolpaca::Cleanup() {
   std::lock_guard<std::mutex> lock(mutex_);
-  rocksdb_.Cleanup();
-  cache_->removePool(poolId_);
+  backend_->Cleanup();
+  auto const kPool = poolName_ + "@" + cacheName_;
+  auto &shared = pools_[kPool];
+  shared.users.erase(
+      std::find(shared.users.begin(), shared.users.end(), this));
+  if (shared.users.empty()) {
+    cache_->removePool(poolId_);
+    pools_.erase(kPool);
+  } else {
+    shared.departedMissesAndHits.first +=
+        missesAndHits_.first.load(std::memory_order_relaxed);
+    shared.departedMissesAndHits.second +=
+        missesAndHits_.second.load(std::memory_order_relaxed);
+    shared.departedRocksdbIOPS +=
+        rocksdbIOPS_.load(std::memory_order_relaxed);
+  }
   cache_ = nullptr;
   poolName_.clear();
-  auto &[x, y, refCount] = rocksdbsAndCaches_[cacheName_];
+  auto &[x, refCount] = caches_[cacheName_];
   if (refCount == 1) {
-    rocksdbsAndCaches_.erase(cacheName_);
+    caches_.erase(cacheName_);
   } else {
     --refCount;
   }
@@ -1,9 +1,13 @@
 #pragma once
 
-#include "rocksdb.h"
+#include "emulator.h"
+#include <atomic>
 #include <core/db.h>
 #include <holpaca/data-plane/CacheAllocator.h>
+#include <memory>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
 namespace ycsbc {
 
@@ -15,20 +19,32 @@ public:
   using Config = CacheAllocator::Config;
 
 private:
+  // pool shared by the threads of a tenant: its first user registers the
+  // metrics of all of them, counting those of users gone in departed*
+  struct Pool {
+    holpaca::PoolId id;
+    std::vector<CacheLibHolpaca *> users;
+    std::pair<long, long> departedMissesAndHits{0, 0};
+    long departedRocksdbIOPS = 0;
+    std::pair<long, long> previousMissesAndHits{0, 0};
+    long prevRocksdbIOPS = 0;
+  };
+
   static std::mutex mutex_;
-  static std::unordered_map<std::string, std::tuple<RocksDB, Cache, int>>
-      rocksdbsAndCaches_;
+  static std::unordered_map<std::string, std::pair<Cache, int>> caches_;
+  // by <pool>@<cache>
+  static std::unordered_map<std::string, Pool> pools_;
 
   int const threadId_;
   Cache cache_ = nullptr;
   std::string cacheName_;
   std::string poolName_ = "";
   holpaca::PoolId poolId_;
-  RocksDB rocksdb_;
-  std::pair<long, long> missesAndHits_{0, 0};
-  std::pair<long, long> previousMissesAndHits_{0, 0};
-  long rocksdbIOPS_ = 0;
-  long prevRocksdbIOPS_ = 0;
+  // RocksDB, or its in-memory emulator
+  std::unique_ptr<DB> backend_;
+  // read by the first user of the pool while this thread updates them
+  std::pair<std::atomic<long>, std::atomic<long>> missesAndHits_{};
+  std::atomic<long> rocksdbIOPS_{0};
 
 public:
   explicit CacheLibHolpaca(int threadId) : threadId_(threadId) {}
@@ -49,6 +65,12 @@ public:
   Status Insert(const std::string &table, const std::string &key,
                 std::vector<Field> &values);
 
+  Status Update(const std::string &table, const std::string &key,
+                std::string_view value);
+
+  Status Insert(const std::string &table, const std::string &key,
+                std::string_view value);
+
   Status Delete(const std::string &table, const std::string &key);
 
   static void SerializeRow(const std::vector<Field> &values, std::string &data);
@@ -69,30 +91,42 @@ public:
 
   void Cleanup() override;
 
+  std::pair<uint64_t, uint64_t> HitsAndMisses() override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return {missesAndHits_.second.load(std::memory_order_relaxed),
+            missesAndHits_.first.load(std::memory_order_relaxed)};
+  }
+
   std::tuple<std::string, std::string, uint64_t, uint64_t, uint64_t, uint64_t>
   OccupancyCapacityAndGlobal() {
     std::lock_guard<std::mutex> lock(mutex_);
     if (cache_ == nullptr) {
       return std::make_tuple("", "", 0, 0, 0, 0);
     }
-    auto [misses, hits] = missesAndHits_;
-    auto &[pmisses, phits] = previousMissesAndHits_;
-
-    long const kPrevMisses = misses;
-    long const kMisses = misses - pmisses;
-    pmisses = kPrevMisses;
-    long const kPrevHits = hits;
-    long const kHits = hits - phits;
-    phits = kPrevHits;
-    long const kPrevRocksdbIOPS = rocksdbIOPS_;
-    long const kRocksdbIOPS = rocksdbIOPS_ - prevRocksdbIOPS_;
-    prevRocksdbIOPS_ = kPrevRocksdbIOPS;
-    cache_->registerMetrics(poolId_, kRocksdbIOPS,
-                            (kMisses + kHits == 0)
-                                ? 0
-                                : static_cast<double>(kMisses) /
-                                      (kMisses + kHits),
-                            kHits + kMisses);
+    auto &shared = pools_[poolName_ + "@" + cacheName_];
+    if (shared.users.front() == this) {
+      auto [misses, hits] = shared.departedMissesAndHits;
+      long rocksdbIOPS = shared.departedRocksdbIOPS;
+      for (auto *user : shared.users) {
+        misses += user->missesAndHits_.first.load(std::memory_order_relaxed);
+        hits += user->missesAndHits_.second.load(std::memory_order_relaxed);
+        rocksdbIOPS += user->rocksdbIOPS_.load(std::memory_order_relaxed);
+      }
+      auto &[pmisses, phits] = shared.previousMissesAndHits;
+
+      long const kMisses = misses - pmisses;
+      pmisses = misses;
+      long const kHits = hits - phits;
+      phits = hits;
+      long const kRocksdbIOPS = rocksdbIOPS - shared.prevRocksdbIOPS;
+      shared.prevRocksdbIOPS = rocksdbIOPS;
+      cache_->registerMetrics(poolId_, kRocksdbIOPS,
+                              (kMisses + kHits == 0)
+                                  ? 0
+                                  : static_cast<double>(kMisses) /
+                                        (kMisses + kHits),
+                              kHits + kMisses);
+    }
 
     const auto &pool = cache_->getPool(poolId_);
     auto cms = cache_->getCacheMemoryStats();
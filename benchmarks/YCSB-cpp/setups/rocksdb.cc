@@ -350,6 +350,38 @@ DB::Status RocksDB::Insert(const std::string &table, const std::string &key,
   return kOK;
 }
 
+// A record of a single unnamed field is replaced whole, so it is not read
+// back and deserialized, only checked for existence
+DB::Status RocksDB::Update(const std::string &table, const std::string &key,
+                           std::string_view value) {
+  std::string data;
+  rocksdb::Status s = db_->Get(rocksdb::ReadOptions(), key, &data);
+  if (s.IsNotFound()) {
+    return kNotFound;
+  } else if (!s.ok()) {
+    throw utils::Exception(std::string("RocksDB Get: ") + s.ToString());
+  }
+  return Insert(table, key, value);
+}
+
+DB::Status RocksDB::Insert(const std::string &table, const std::string &key,
+                           std::string_view value) {
+  std::string data;
+  data.reserve(2 * sizeof(uint32_t) + value.size());
+  uint32_t len = 0;
+  data.append(reinterpret_cast<char *>(&len), sizeof(uint32_t));
+  len = value.size();
+  data.append(reinterpret_cast<char *>(&len), sizeof(uint32_t));
+  data.append(value.data(), value.size());
+  rocksdb::WriteOptions wopt;
+  wopt.disableWAL = true;
+  rocksdb::Status s = db_->Put(wopt, key, data);
+  if (!s.ok()) {
+    throw utils::Exception(std::string("RocksDB Put: ") + s.ToString());
+  }
+  return kOK;
+}
+
 DB::Status RocksDB::Delete(const std::string &table, const std::string &key) {
   rocksdb::WriteOptions wopt;
   rocksdb::Status s = db_->Delete(wopt, key);
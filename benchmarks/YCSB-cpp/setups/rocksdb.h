@@ -4,6 +4,7 @@
 #include <rocksdb/options.h>
 
 #include <mutex>
+#include <string_view>
 
 #include "core/db.h"
 #include "core/properties.h"
@@ -42,6 +43,12 @@ public:
   Status Insert(const std::string &table, const std::string &key,
                 std::vector<Field> &values);
 
+  Status Update(const std::string &table, const std::string &key,
+                std::string_view value);
+
+  Status Insert(const std::string &table, const std::string &key,
+                std::string_view value);
+
   Status Delete(const std::string &table, const std::string &key);
 
   void Init();
@@ -0,0 +1,99 @@
+//
+//  trace_converter.cc
+//  YCSB-cpp
+//
+//  Converts a Twitter text trace into the binary trace format replayed by
+//  TraceReplayer (see core/trace_format.h).
+//
+//  Usage: trace-converter <input text trace> <output binary trace>
+//
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "core/trace_format.h"
+
+using namespace ycsbc;
+
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    std::cerr << "Usage: " << argv[0]
+              << " <input text trace> <output binary trace>" << std::endl;
+    return 1;
+  }
+
+  std::ifstream input(argv[1]);
+  if (!input) {
+    std::cerr << "Error opening input trace: " << argv[1] << std::endl;
+    return 1;
+  }
+  std::ofstream output(argv[2], std::ios::binary | std::ios::trunc);
+  if (!output) {
+    std::cerr << "Error opening output trace: " << argv[2] << std::endl;
+    return 1;
+  }
+
+  // Records are streamed after a placeholder header, keys are interned
+  trace::Header header{};
+  std::memcpy(header.magic, trace::kMagic, sizeof(trace::kMagic));
+  header.records_offset = sizeof(trace::Header);
+  output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+  std::unordered_map<std::string, uint32_t> key_ids;
+  std::vector<uint64_t> key_index{0};
+  std::string key_data;
+
+  std::string line;
+  uint64_t malformed = 0;
+  trace::TextOperation operation;
+  while (std::getline(input, line)) {
+    if (!trace::ParseTextLine(line, operation)) {
+      ++malformed;
+      continue;
+    }
+    auto [it, inserted] = key_ids.try_emplace(
+        std::string(operation.key), static_cast<uint32_t>(key_ids.size()));
+    if (inserted) {
+      key_data.append(operation.key);
+      key_index.push_back(key_data.size());
+    }
+
+    trace::Record record{};
+    record.timestamp = operation.timestamp;
+    record.key_id = it->second;
+    record.value_size = operation.value_size;
+    record.op = operation.op;
+    output.write(reinterpret_cast<const char *>(&record), sizeof(record));
+    ++header.record_count;
+  }
+
+  // Key table, then the final header
+  header.key_count = key_ids.size();
+  header.key_index_offset =
+      header.records_offset + header.record_count * sizeof(trace::Record);
+  header.key_data_offset =
+      header.key_index_offset + key_index.size() * sizeof(uint64_t);
+  output.write(reinterpret_cast<const char *>(key_index.data()),
+               key_index.size() * sizeof(uint64_t));
+  output.write(key_data.data(), key_data.size());
+  output.seekp(0);
+  output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  output.close();
+  if (!output) {
+    std::cerr << "Error writing output trace: " << argv[2] << std::endl;
+    return 1;
+  }
+
+  std::cout << "Converted " << header.record_count << " operations over "
+            << header.key_count << " keys";
+  if (malformed > 0) {
+    std::cout << " (skipped " << malformed << " malformed lines)";
+  }
+  std::cout << std::endl;
+  return 0;
+}
@@ -0,0 +1,398 @@
+//
+//  trace_preprocess.cc
+//  YCSB-cpp
+//
+//  Turns a Twitter cluster trace (zstd-compressed or plain, from a file or
+//  stdin) into the run file replayed by TraceReplayer and the load file
+//  holding the first operation on each key.
+//
+//  Usage: trace-preprocess [-t threads] [-n max operations]
+//                          <input | -> <run file> <load file>
+//
+//  The input is cut into blocks of whole lines. Worker threads normalize the
+//  lines of a block (keys containing commas get them replaced by '_', so that
+//  every line has exactly 7 fields) and hash their keys, and a writer thread
+//  appends the blocks in order. Deduplication keeps a compact open-addressing
+//  set of 64-bit key fingerprints (8 bytes per distinct key), so it needs
+//  neither the keys themselves nor a second pass over the run file.
+//
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#ifdef YCSB_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+
+constexpr size_t kBlockSize = 16 << 20;
+constexpr size_t kMaxBlocksInFlight = 64;
+constexpr size_t kTraceFields = 7;
+
+// 64-bit FNV-1a, finalized with a murmur mix to spread the low bits
+uint64_t HashKey(std::string_view key) {
+  uint64_t h = 14695981039346656037ULL;
+  for (unsigned char c : key) {
+    h = (h ^ c) * 1099511628211ULL;
+  }
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  return h;
+}
+
+// Open-addressing set of key fingerprints (0 is reserved for empty slots)
+class FingerprintSet {
+ public:
+  FingerprintSet() : slots_(1 << 20, 0) {}
+
+  // Inserts a fingerprint; returns false if it was already present
+  bool Insert(uint64_t fingerprint) {
+    if (fingerprint == 0) {
+      fingerprint = 1;
+    }
+    if ((size_ + 1) * 4 > slots_.size() * 3) {
+      Grow();
+    }
+    if (!Place(slots_, fingerprint)) {
+      return false;
+    }
+    ++size_;
+    return true;
+  }
+
+  size_t Size() const { return size_; }
+
+ private:
+  static bool Place(std::vector<uint64_t> &slots, uint64_t fingerprint) {
+    size_t mask = slots.size() - 1;
+    for (size_t i = fingerprint & mask;; i = (i + 1) & mask) {
+      if (slots[i] == fingerprint) {
+        return false;
+      }
+      if (slots[i] == 0) {
+        slots[i] = fingerprint;
+        return true;
+      }
+    }
+  }
+
+  void Grow() {
+    std::vector<uint64_t> slots(slots_.size() * 2, 0);
+    for (uint64_t fingerprint : slots_) {
+      if (fingerprint != 0) {
+        Place(slots, fingerprint);
+      }
+    }
+    slots_.swap(slots);
+  }
+
+  std::vector<uint64_t> slots_;
+  size_t size_{0};
+};
+
+// Whole lines of the input, normalized by a worker
+struct Block {
+  uint64_t seq;
+  std::string input;
+  std::string output;
+  // end offset in output and key fingerprint of each line
+  std::vector<std::pair<size_t, uint64_t>> lines;
+};
+
+// Reads the input, decompressing it if it starts with the zstd magic
+class InputStream {
+ public:
+  bool Open(const std::string &path) {
+    file_ = path == "-" ? stdin : std::fopen(path.c_str(), "rb");
+    if (file_ == nullptr) {
+      return false;
+    }
+    raw_.resize(1 << 20);
+    raw_size_ = std::fread(raw_.data(), 1, raw_.size(), file_);
+    compressed_ = raw_size_ >= 4 && static_cast<uint8_t>(raw_[0]) == 0x28 &&
+                  static_cast<uint8_t>(raw_[1]) == 0xB5 &&
+                  static_cast<uint8_t>(raw_[2]) == 0x2F &&
+                  static_cast<uint8_t>(raw_[3]) == 0xFD;
+#ifdef YCSB_HAVE_ZSTD
+    if (compressed_) {
+      dctx_ = ZSTD_createDCtx();
+    }
+    return true;
+#else
+    if (compressed_) {
+      std::cerr << "zstd input requires building with zstd (or pipe it "
+                   "through zstdcat)"
+                << std::endl;
+      return false;
+    }
+    return true;
+#endif
+  }
+
+  ~InputStream() {
+#ifdef YCSB_HAVE_ZSTD
+    if (dctx_ != nullptr) {
+      ZSTD_freeDCtx(dctx_);
+    }
+#endif
+    if (file_ != nullptr && file_ != stdin) {
+      std::fclose(file_);
+    }
+  }
+
+  // Appends up to n bytes to out; returns the number of bytes appended
+  size_t Read(std::string &out, size_t n) {
+    size_t start = out.size();
+    out.resize(start + n);
+    size_t got = 0;
+    while (got < n) {
+      if (raw_pos_ == raw_size_) {
+        raw_pos_ = 0;
+        raw_size_ = std::fread(raw_.data(), 1, raw_.size(), file_);
+        if (raw_size_ == 0) {
+          break;
+        }
+      }
+      if (!compressed_) {
+        size_t copy = std::min(n - got, raw_size_ - raw_pos_);
+        std::memcpy(&out[start + got], raw_.data() + raw_pos_, copy);
+        raw_pos_ += copy;
+        got += copy;
+        continue;
+      }
+#ifdef YCSB_HAVE_ZSTD
+      ZSTD_inBuffer in{raw_.data(), raw_size_, raw_pos_};
+      ZSTD_outBuffer dst{&out[start], n, got};
+      size_t ret = ZSTD_decompressStream(dctx_, &dst, &in);
+      if (ZSTD_isError(ret)) {
+        std::cerr << "zstd: " << ZSTD_getErrorName(ret) << std::endl;
+        break;
+      }
+      raw_pos_ = in.pos;
+      got = dst.pos;
+#endif
+    }
+    out.resize(start + got);
+    return got;
+  }
+
+ private:
+  FILE *file_{nullptr};
+  std::vector<char> raw_;
+  size_t raw_size_{0};
+  size_t raw_pos_{0};
+  bool compressed_{false};
+#ifdef YCSB_HAVE_ZSTD
+  ZSTD_DCtx *dctx_{nullptr};
+#endif
+};
+
+// Normalizes the lines of a block and fingerprints their keys
+void ProcessBlock(Block &block) {
+  block.output.reserve(block.input.size());
+  std::string_view input(block.input);
+  size_t start = 0;
+  while (start < input.size()) {
+    size_t end = input.find('\n', start);
+    if (end == std::string_view::npos) {
+      end = input.size();
+    }
+    std::string_view line = input.substr(start, end - start);
+    start = end + 1;
+
+    // Fields around the key, which may itself contain commas
+    size_t first = line.find(',');
+    if (first == std::string_view::npos) {
+      continue;
+    }
+    size_t last = line.size();
+    size_t after = kTraceFields - 2;
+    for (; after > 0 && last != std::string_view::npos; --after) {
+      last = last == 0 ? std::string_view::npos : line.rfind(',', last - 1);
+    }
+    if (after > 0 || last == std::string_view::npos || last <= first) {
+      continue;
+    }
+
+    size_t key_start = block.output.size() + first + 1;
+    block.output.append(line.substr(0, last));
+    std::replace(block.output.begin() + key_start, block.output.end(), ',',
+                 '_');
+    block.output.append(line.substr(last));
+    std::string_view key(block.output.data() + key_start,
+                         block.output.size() - key_start -
+                             (line.size() - last));
+    block.output.push_back('\n');
+    block.lines.emplace_back(block.output.size(), HashKey(key));
+  }
+  std::string().swap(block.input);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  size_t threads = std::max(1u, std::thread::hardware_concurrency());
+  uint64_t max_ops = 0;
+  int arg = 1;
+  for (; arg + 1 < argc && argv[arg][0] == '-' && argv[arg][1] != '\0';
+       arg += 2) {
+    if (std::string(argv[arg]) == "-t") {
+      threads = std::max(1ul, std::stoul(argv[arg + 1]));
+    } else if (std::string(argv[arg]) == "-n") {
+      max_ops = std::stoull(argv[arg + 1]);
+    } else {
+      break;
+    }
+  }
+  if (argc - arg != 3) {
+    std::cerr << "Usage: " << argv[0]
+              << " [-t threads] [-n max operations] <input | -> <run file> "
+                 "<load file>"
+              << std::endl;
+    return 1;
+  }
+
+  InputStream input;
+  if (!input.Open(argv[arg])) {
+    std::cerr << "Error opening input trace: " << argv[arg] << std::endl;
+    return 1;
+  }
+  std::ofstream run_file(argv[arg + 1], std::ios::binary | std::ios::trunc);
+  std::ofstream load_file(argv[arg + 2], std::ios::binary | std::ios::trunc);
+  if (!run_file || !load_file) {
+    std::cerr << "Error opening output files" << std::endl;
+    return 1;
+  }
+
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::deque<std::unique_ptr<Block>> pending;
+  std::map<uint64_t, std::unique_ptr<Block>> done;
+  size_t in_flight = 0;
+  bool eof = false;
+
+  // Workers normalize blocks in any order
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < threads; ++i) {
+    workers.emplace_back([&] {
+      std::unique_lock<std::mutex> lock(mutex);
+      while (true) {
+        changed.wait(lock, [&] { return !pending.empty() || eof; });
+        if (pending.empty()) {
+          return;
+        }
+        auto block = std::move(pending.front());
+        pending.pop_front();
+        lock.unlock();
+        ProcessBlock(*block);
+        lock.lock();
+        done.emplace(block->seq, std::move(block));
+        changed.notify_all();
+      }
+    });
+  }
+
+  // The writer appends blocks in input order and deduplicates keys
+  FingerprintSet keys;
+  uint64_t operations = 0;
+  std::thread writer([&] {
+    uint64_t next = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      changed.wait(lock, [&] {
+        return done.count(next) > 0 || (eof && in_flight == 0);
+      });
+      if (done.count(next) == 0) {
+        return;
+      }
+      auto block = std::move(done[next]);
+      done.erase(next++);
+      lock.unlock();
+
+      run_file.write(block->output.data(), block->output.size());
+      size_t start = 0;
+      for (const auto &[end, fingerprint] : block->lines) {
+        if (keys.Insert(fingerprint)) {
+          load_file.write(block->output.data() + start, end - start);
+        }
+        start = end;
+      }
+      operations += block->lines.size();
+
+      lock.lock();
+      --in_flight;
+      changed.notify_all();
+    }
+  });
+
+  // Cut the input into blocks of whole lines, up to max_ops lines
+  std::string carry;
+  uint64_t lines = 0;
+  for (uint64_t seq = 0;; ++seq) {
+    auto block = std::make_unique<Block>();
+    block->seq = seq;
+    block->input.swap(carry);
+    bool more = input.Read(block->input, kBlockSize) > 0;
+
+    size_t cut = block->input.size();
+    if (more) {
+      size_t last_newline = block->input.rfind('\n');
+      cut = last_newline == std::string::npos ? 0 : last_newline + 1;
+    }
+    if (max_ops > 0) {
+      for (size_t pos = 0; pos < cut; ++pos) {
+        pos = block->input.find('\n', pos);
+        if (pos == std::string::npos || pos >= cut) {
+          break;
+        }
+        if (++lines == max_ops) {
+          cut = pos + 1;
+          more = false;
+          break;
+        }
+      }
+    }
+    carry.assign(block->input, cut, std::string::npos);
+    block->input.resize(cut);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [&] { return in_flight < kMaxBlocksInFlight; });
+    ++in_flight;
+    pending.push_back(std::move(block));
+    eof = !more;
+    changed.notify_all();
+    if (eof) {
+      break;
+    }
+  }
+
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  writer.join();
+  run_file.close();
+  load_file.close();
+  if (!run_file || !load_file) {
+    std::cerr << "Error writing output files" << std::endl;
+    return 1;
+  }
+
+  std::cout << "Preprocessed " << operations << " operations over "
+            << keys.Size() << " keys" << std::endl;
+  return 0;
+}
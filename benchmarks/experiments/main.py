@@ -6,6 +6,7 @@ import motivation_1
 import motivation_2
 import orchestrator_algorithm_latency_breakdown
 import orchestrator_control_interval
+import qos_recovery
 import use_case_1
 import use_case_2
 import use_case_3
@@ -19,6 +20,7 @@ EXPERIMENTS = {
     "agent_overhead": agent_overhead.EXPERIMENT,
     "orchestrator_algorithm_latency_breakdown": orchestrator_algorithm_latency_breakdown.EXPERIMENT,
     "orchestrator_control_interval": orchestrator_control_interval.EXPERIMENT,
+    "qos_recovery": qos_recovery.EXPERIMENT,
 }
 
 CWD = Path(__file__).resolve().parent.absolute()
@@ -0,0 +1,135 @@
+from utils.experiment import Experiment
+from utils.setup import Setup, SetupType
+
+THREADS = 4
+OVERHEAD_FACTOR = 1.2
+VIRTUAL_SIZE = 4_500_000_000
+CACHE_SIZE = VIRTUAL_SIZE * THREADS * OVERHEAD_FACTOR
+
+# The QoS tenant (I_1) runs alone until the other tenants join, at which point
+# memory is taken from it to host their new pools. Later on, its own offered
+# load jumps: the extra misses queue at the shared backend, so with a bounded
+# number of outstanding operations its throughput falls below the floor until
+# its pool is grown again.
+QOS_TENANT = 0
+JUMP_TIME = 600
+RUN_TIME = 1800
+QOS_RATE = 70_000
+QOS_RATE_JUMP_TIME = JUMP_TIME + RUN_TIME // 2
+QOS_RATE_AFTER_JUMP = 140_000
+QOS_OUTSTANDING = 32
+
+base_config = {
+    "threadcount": THREADS,
+    "cleanupafterload": "true",
+    "sleepafterload": JUMP_TIME,
+    f"sleepafterload.{QOS_TENANT}": 0,
+    "operationcount": 1_000_000_000_000,
+    "maxexecutiontime": RUN_TIME,
+    f"maxexecutiontime.{QOS_TENANT}": RUN_TIME + JUMP_TIME,
+    f"target.{QOS_TENANT}": QOS_RATE,
+    f"target.profile.{QOS_TENANT}": f"step:{QOS_RATE_JUMP_TIME}:{QOS_RATE_AFTER_JUMP}",
+    f"outstanding.{QOS_TENANT}": QOS_OUTSTANDING,
+    "status.interval": 1,
+    "cachelib.poolresizer": "on",
+    "cachelib.poolresizer.slabs": 1000,
+    "cachelib.size": CACHE_SIZE,
+    "holpaca.virtualsize.0": VIRTUAL_SIZE * 0.048,
+    "holpaca.virtualsize.1": VIRTUAL_SIZE * 0.078,
+    "holpaca.virtualsize.2": VIRTUAL_SIZE * 0.249,
+    "holpaca.virtualsize.3": VIRTUAL_SIZE * 0.625,
+    "cachelib.pool.relsize.0": VIRTUAL_SIZE * 0.048 / CACHE_SIZE,
+    "cachelib.pool.relsize.1": VIRTUAL_SIZE * 0.078 / CACHE_SIZE,
+    "cachelib.pool.relsize.2": VIRTUAL_SIZE * 0.249 / CACHE_SIZE,
+    "cachelib.pool.relsize.3": VIRTUAL_SIZE * 0.625 / CACHE_SIZE,
+    f"holpaca.pool.qos.{QOS_TENANT}": 60_000.0,
+    "holpaca.orchestrator.address": "localhost:11110",
+    **{f"holpaca.agent.address.{i}": f"localhost:{11111+i}" for i in range(THREADS)},
+    **{f"cachelib.name.{i}": f"instance-{i}" for i in range(THREADS)},
+    **{f"cachelib.pool.name.{i}": f"p{i}" for i in range(THREADS)},
+    **{f"request_key_prefix.{i}": f"p{i}" for i in range(THREADS)},
+    # rocksdb
+    "rocksdb.compression": "no",
+    "rocksdb.write_buffer_size": 134217728,
+    "rocksdb.max_write_buffer_number": 2,
+    "rocksdb.level0_file_number_compaction_trigger": 4,
+    "rocksdb.max_background_flushes": 1,
+    "rocksdb.max_background_compactions": 3,
+    "rocksdb.use_direct_reads": "true",
+    "rocksdb.no_block_cache": "true",
+    "rocksdb.use_direct_io_for_flush_compaction": "true",
+    # workload
+    "workload.type": "trace",
+    "trace.override_value_size": 1000,
+    "trace.runfile.0": "cluster18",
+    "trace.loadfile.0": "cluster18-keyed",
+    "trace.runfile.1": "cluster53",
+    "trace.loadfile.1": "cluster53-keyed",
+    "trace.runfile.2": "cluster40",
+    "trace.loadfile.2": "cluster40-keyed",
+    "trace.runfile.3": "cluster19",
+    "trace.loadfile.3": "cluster19-keyed",
+}
+
+# QoS only freezes the lower bound of pools below their level
+h_freeze = Setup(
+    "H_freeze",
+    SetupType.HOLPACA,
+    base_config,
+    orchestrator_args=["ThroughputMaximization", "1000:0.01"],
+)
+
+# QoS controller (PI law with MRC feed-forward) runs before the optimizer
+h_pi = Setup(
+    "H_PI",
+    SetupType.HOLPACA,
+    base_config,
+    orchestrator_args=["ThroughputMaximization", "1000:0.01:false:0:0.5:0.1:0"],
+)
+
+
+def override_timeout(config, timeout):
+    config["maxexecutiontime"] = timeout
+    config[f"maxexecutiontime.{QOS_TENANT}"] = timeout + JUMP_TIME
+    config[f"target.profile.{QOS_TENANT}"] = (
+        f"step:{JUMP_TIME + timeout // 2}:{QOS_RATE_AFTER_JUMP}"
+    )
+    for i in range(THREADS):
+        if i != QOS_TENANT:
+            config.pop(f"maxexecutiontime.{i}", None)
+
+
+def override_objsize(config, size):
+    config["trace.override_value_size"] = size
+    for i in range(THREADS):
+        config.pop(f"trace.override_value_size.{i}", None)
+
+
+def override_num_ops(config, num_ops):
+    config["operationcount"] = num_ops
+    for i in range(THREADS):
+        config.pop(f"operationcount.{i}", None)
+
+
+def override_cache_size(config, cache_size):
+    config[f"holpaca.virtualsize"] = cache_size
+    config[f"cachelib.size"] = cache_size * THREADS * OVERHEAD_FACTOR
+    config[f"cachelib.pool.relsize"] = 1
+    for i in range(THREADS):
+        config.pop(f"holpaca.virtualsize.{i}", None)
+        config.pop(f"cachelib.size.{i}", None)
+        config.pop(f"cachelib.pool.relsize.{i}", None)
+
+
+EXPERIMENT = Experiment(
+    name="qos_recovery",
+    setups={
+        "H_freeze": h_freeze,
+        "H_PI": h_pi,
+    },
+    override_timeout=override_timeout,
+    override_num_ops=override_num_ops,
+    override_objsize=override_objsize,
+    override_cache_size=override_cache_size,
+    status="INSERT-PASSED INSERT-FAILED READ-PASSED READ-FAILED ALL",
+)
@@ -0,0 +1,110 @@
+import argparse
+import json
+import re
+from pathlib import Path
+
+import matplotlib.pyplot as plt
+import numpy as np
+
+plt.style.use("seaborn-v0_8-whitegrid")
+plt.rcParams["font.size"] = 16
+plt.rcParams["axes.labelsize"] = 16
+plt.rcParams["xtick.labelsize"] = 14
+plt.rcParams["ytick.labelsize"] = 14
+plt.rcParams["axes.spines.top"] = False
+plt.rcParams["axes.spines.right"] = False
+plt.rcParams["figure.dpi"] = 200
+
+OUTDIR = None
+QOS_TENANT = 0
+SETUPS = {"H_freeze": {}, "H_PI": {}}
+LINE_COLORS = ["#de8f05", "#029e73"]
+
+# Seconds the throughput must stay above the QoS level to count as recovered
+RECOVERY_WINDOW = 10
+
+
+def getThroughput(results: str, thread: int):
+    values = []
+    previousThroughput = 0
+    # From cumulative to per-second
+    for t in re.findall(rf"\[T-{thread}\]: (\d+)", results):
+        values.append(int(t) - previousThroughput)
+        previousThroughput = int(t)
+    return values
+
+
+def timeToRecover(throughput, qos, jump, end=None):
+    """Seconds from a load jump until the throughput stays above the QoS
+    level for RECOVERY_WINDOW consecutive seconds, before end (None if it
+    never does)."""
+    above = 0
+    for t in range(jump, min(end or len(throughput), len(throughput))):
+        above = above + 1 if throughput[t] >= qos else 0
+        if above == RECOVERY_WINDOW:
+            return t - RECOVERY_WINDOW + 1 - jump
+    return None
+
+
+def plot(throughput_per_setup, qos, jumps):
+    fig, ax = plt.subplots(figsize=(12, 4))
+    for i, (setup, values) in enumerate(throughput_per_setup.items()):
+        ax.plot(np.arange(len(values)), values, label=setup, color=LINE_COLORS[i])
+    ax.axhline(y=qos, color="red", linestyle=":", linewidth=1, label="QoS")
+    for jump in jumps:
+        ax.axvline(x=jump, color="gray", linestyle="--", linewidth=1)
+    ax.set_xlabel("Time (s)", fontweight="bold")
+    ax.set_ylabel("Throughput (Ops/s)", fontweight="bold")
+    ax.legend(loc="lower right")
+    plt.tight_layout()
+    plt.savefig(OUTDIR / "qos_recovery.png", bbox_inches="tight", pad_inches=0)
+    plt.savefig(OUTDIR / "qos_recovery.pdf", bbox_inches="tight", pad_inches=0)
+    plt.close()
+
+
+def main():
+    global OUTDIR
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "experiment_results_dir", type=str, help="Directory with experiment results"
+    )
+    args = parser.parse_args()
+
+    results_dir = Path(args.experiment_results_dir).resolve().absolute()
+    OUTDIR = results_dir
+
+    throughput_per_setup = {}
+    for setup in SETUPS:
+        with open(results_dir / setup / "setup.json", "r") as f:
+            SETUPS[setup] = json.load(f)
+        with open(results_dir / setup / "run.txt", "r") as f:
+            throughput_per_setup[setup] = getThroughput(f.read(), QOS_TENANT)
+
+    config = next(iter(SETUPS.values()))
+    qos = float(config[f"holpaca.pool.qos.{QOS_TENANT}"])
+    # The other tenants join, then the QoS tenant's own rate steps up
+    jumps = {"tenants join": int(config["sleepafterload"])}
+    profile = config.get(f"target.profile.{QOS_TENANT}", "constant").split(":")
+    if profile[0] == "step":
+        jumps["rate jump"] = int(float(profile[1]))
+    starts = list(jumps.values())
+
+    for setup, values in throughput_per_setup.items():
+        for i, (phase, jump) in enumerate(jumps.items()):
+            end = starts[i + 1] if i + 1 < len(starts) else None
+            recovery = timeToRecover(values, qos, jump, end)
+            print(
+                f"{setup} after {phase}: "
+                + (
+                    f"recovered in {recovery} s"
+                    if recovery is not None
+                    else "never recovered"
+                )
+            )
+
+    plot(throughput_per_setup, qos, starts)
+
+
+if __name__ == "__main__":
+    main()
@@ -1,4 +1,3 @@
-import os
 import subprocess
 from pathlib import Path
 
@@ -21,41 +20,12 @@ for trace_id, max_ops in traces.items():
     trace_file = DIR / f"cluster{trace_id}"
     trace_file_keyed = DIR / f"cluster{trace_id}-keyed"
 
-    download_proc = subprocess.Popen(
-        f"wget --timeout=0 -q -O - {GetURL(trace_id)} | zstdcat | pv -l -s {max_ops} | head -n {max_ops} > {trace_file}",
+    # Streams the trace through trace-preprocess (built with YCSB-cpp), which
+    # normalizes keys containing commas and writes the run trace along with
+    # the first operation on each key
+    subprocess.run(
+        f"wget --timeout=0 -q -O - {GetURL(trace_id)} | "
+        f"trace-preprocess -n {max_ops} - {trace_file} {trace_file_keyed}",
         shell=True,
-        stdout=subprocess.PIPE,
+        check=True,
     )
-
-    # Process with awk-like logic
-    with open(trace_file, "w") as outfile:
-        for line in download_proc.stdout:
-            line = line.rstrip("\n")
-            fields = line.split(",")
-
-            if len(fields) == 7:
-                # Line is fine as-is
-                outfile.write(line + "\n")
-            elif len(fields) > 7:
-                # Reconstruct the key field
-                key_parts = fields[1 : len(fields) - 5]
-                key = ",".join(key_parts)
-
-                # Reconstruct the line
-                result = [fields[0], key] + fields[-5:]
-                outfile.write(",".join(result) + "\n")
-
-    download_proc.wait()
-
-    print(f"Generating keyed trace file: {trace_file_keyed}")
-
-    # Keep only the first occurrence of each key (field 2)
-    seen_keys = set()
-    with open(trace_file, "r") as infile, open(trace_file_keyed, "w") as outfile:
-        for line in infile:
-            fields = line.rstrip("\n").split(",")
-            if len(fields) >= 2:
-                key = fields[1]
-                if key not in seen_keys:
-                    seen_keys.add(key)
-                    outfile.write(line)
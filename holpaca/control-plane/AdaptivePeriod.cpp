@@ -0,0 +1,97 @@
+#include <holpaca/control-plane/AdaptivePeriod.h>
+#include <holpaca/control-plane/algorithms/MissRatioCurve.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace holpaca {
+
+/**
+ * @brief Constructs the decorator in front of the given ProxyManager.
+ */
+AdaptivePeriod::AdaptivePeriod(ProxyManager *const kProxyManager,
+                               std::chrono::milliseconds const kPeriodicity,
+                               Config const &kConfig)
+    : m_kProxyManager(kProxyManager), m_kConfig(kConfig),
+      m_period(std::clamp(kPeriodicity, kConfig.m_minPeriod,
+                          std::max(kConfig.m_minPeriod, kConfig.m_maxPeriod))
+                   .count()) {}
+
+/**
+ * @brief Largest change of a pool between the previous and the given status.
+ *
+ * Pools absent from the previous status (new agents or pools) count as a full
+ * change, so the algorithm soon allocates them.
+ *
+ * @param kAllCacheStatus Status of all caches, collected for the round
+ * @return Largest change, relative ([0, 1] for the MRC part)
+ */
+double AdaptivePeriod::change(
+    std::unordered_map<std::string, CacheStatus> const &kAllCacheStatus)
+    const {
+  double largest = 0.0;
+  for (const auto &[cacheId, cacheStatus] : kAllCacheStatus) {
+    auto const kCache = m_previous.find(cacheId);
+    for (const auto &[poolId, poolStatus] : cacheStatus.m_pools) {
+      if (kCache == m_previous.end() ||
+          !kCache->second.m_pools.count(poolId)) {
+        return 1.0;
+      }
+      auto const &kPrevious = kCache->second.m_pools.at(poolId);
+
+      double const kThroughput = std::max<double>(kPrevious.m_throughput, 1.0);
+      largest = std::max(
+          largest,
+          std::abs(static_cast<double>(poolStatus.m_throughput) -
+                   kPrevious.m_throughput) /
+              kThroughput);
+
+      if (poolStatus.m_MRC.empty()) {
+        continue;
+      }
+      MissRatioCurve const kPreviousMRC(kPrevious.m_MRC);
+      double drift = 0.0;
+      for (const auto &[size, missRatio] : poolStatus.m_MRC) {
+        drift += std::abs(missRatio - kPreviousMRC(size));
+      }
+      largest = std::max(largest, drift / poolStatus.m_MRC.size());
+    }
+  }
+  return largest;
+}
+
+/**
+ * @brief Forwards the status request and adapts the period to the change.
+ *
+ * @return Map of cache names (address) to their CacheStatus
+ */
+std::unordered_map<std::string, ProxyManager::CacheStatus>
+AdaptivePeriod::getStatus() {
+  auto cacheStatus = m_kProxyManager->getStatus();
+
+  double const kChange = change(cacheStatus);
+  auto const kPeriod = period();
+  double factor = 1.0;
+  if (kChange > m_kConfig.m_highChange) {
+    factor = m_kConfig.m_shrink;
+  } else if (kChange < m_kConfig.m_lowChange) {
+    factor = m_kConfig.m_growth;
+  }
+  auto next = std::chrono::milliseconds(
+      static_cast<std::chrono::milliseconds::rep>(
+          std::ceil(kPeriod.count() * factor)));
+  next = std::clamp(next, m_kConfig.m_minPeriod,
+                    std::max(m_kConfig.m_minPeriod, m_kConfig.m_maxPeriod));
+  if (next != kPeriod) {
+    std::cout << "AdaptivePeriod: change " << kChange << ", period "
+              << kPeriod.count() << " -> " << next.count() << " ms"
+              << std::endl;
+    m_period = next.count();
+  }
+
+  m_previous = cacheStatus;
+  return cacheStatus;
+}
+
+} // namespace holpaca
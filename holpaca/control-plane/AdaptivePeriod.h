@@ -0,0 +1,103 @@
+#pragma once
+
+#include <holpaca/control-plane/ProxyManager.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace holpaca {
+
+/**
+ * @brief ProxyManager decorator that adapts a control algorithm's period to
+ * how fast the workloads change.
+ *
+ * Every status collected through it is compared with the previous one: the
+ * change of a pool is the largest of its relative throughput change and the
+ * mean absolute change of its MRC (at the points of the new curve). When the
+ * largest change among pools exceeds a threshold the period shrinks, so the
+ * algorithm reacts sooner; while it stays below another threshold the period
+ * grows, so a stable system is disturbed (and queried) less often.
+ */
+class AdaptivePeriod : public ProxyManager {
+public:
+  /**
+   * @brief Adaptation parameters.
+   */
+  struct Config {
+    /* Shortest period */
+    std::chrono::milliseconds m_minPeriod{100};
+
+    /* Longest period */
+    std::chrono::milliseconds m_maxPeriod{60000};
+
+    /* Change below which the system is stable */
+    double m_lowChange{0.02};
+
+    /* Change above which the system is shifting */
+    double m_highChange{0.1};
+
+    /* Factor applied to the period when shifting */
+    double m_shrink{0.5};
+
+    /* Factor applied to the period when stable */
+    double m_growth{1.25};
+  };
+
+private:
+  /* ProxyManager that serves the algorithm */
+  ProxyManager *const m_kProxyManager;
+
+  /* Adaptation parameters */
+  Config const m_kConfig;
+
+  /* Current period (ms), read by the thread scheduling the algorithm */
+  std::atomic<std::chrono::milliseconds::rep> m_period;
+
+  /* Status collected in the previous round */
+  std::unordered_map<std::string, CacheStatus> m_previous;
+
+  /**
+   * @brief Largest change of a pool between the previous and the given
+   * status.
+   */
+  double change(std::unordered_map<std::string, CacheStatus> const
+                    &kAllCacheStatus) const;
+
+public:
+  /**
+   * @brief Constructs the decorator in front of the given ProxyManager.
+   *
+   * @param kProxyManager ProxyManager that serves the algorithm
+   * @param kPeriodicity Initial period (clamped to the configured bounds)
+   * @param kConfig Adaptation parameters
+   */
+  AdaptivePeriod(ProxyManager *const kProxyManager,
+                 std::chrono::milliseconds const kPeriodicity,
+                 Config const &kConfig);
+
+  /**
+   * @brief Current period of the algorithm.
+   */
+  std::chrono::milliseconds period() const {
+    return std::chrono::milliseconds(m_period.load());
+  }
+
+  /**
+   * @brief Forwards the status request and adapts the period to the change.
+   * @return Map of cache names to their status
+   */
+  std::unordered_map<std::string, CacheStatus> getStatus() override final;
+
+  /**
+   * @brief Forwards the resize instructions unchanged.
+   * @param cacheResize Vector of resize instructions
+   */
+  void resize(const std::vector<CacheResize> &cacheResize) override final {
+    m_kProxyManager->resize(cacheResize);
+  }
+};
+
+} // namespace holpaca
@@ -0,0 +1,234 @@
+#include <grpcpp/create_channel.h>
+#include <grpcpp/server_builder.h>
+#include <grpcpp/server_context.h>
+#include <holpaca/control-plane/Aggregator.h>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+
+namespace holpaca {
+
+/**
+ * @brief Starts the agent gRPC server and connects to the root orchestrator.
+ *
+ * Retries until the root orchestrator becomes available.
+ */
+Aggregator::Aggregator(ProxyManager *const kChildren,
+                       std::string const &kAddress,
+                       std::string const &kRootAddress,
+                       std::string const &kDomain)
+    : m_kChildren(kChildren), m_kAddress(kAddress) {
+  m_server = grpc::ServerBuilder()
+                 .AddListeningPort(m_kAddress,
+                                   grpc::InsecureServerCredentials())
+                 .RegisterService(static_cast<AgentRPC::Service *>(this))
+                 .BuildAndStart();
+  m_serverThread = std::thread([this] { m_server->Wait(); });
+
+  m_root = std::make_shared<OrchestratorRPC::Stub>(grpc::CreateChannel(
+      kRootAddress, grpc::InsecureChannelCredentials()));
+
+  ConnectRequest request;
+  ConnectResponse response;
+  request.set_cacheaddress(m_kAddress);
+  request.set_domain(kDomain);
+
+  ::grpc::Status status;
+  do {
+    ::grpc::ClientContext context;
+    status = m_root->Connect(&context, request, &response);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+  } while (!status.ok());
+}
+
+/**
+ * @brief Disconnects from the root orchestrator and stops the server.
+ */
+Aggregator::~Aggregator() {
+  ::grpc::ClientContext context;
+  DisconnectRequest request;
+  DisconnectResponse response;
+  request.set_cacheaddress(m_kAddress);
+  m_root->Disconnect(&context, request, &response);
+
+  if (m_server) {
+    m_server->Shutdown();
+    m_serverThread.join();
+  }
+}
+
+/**
+ * @brief Collects the children's status and reports it as one pool.
+ *
+ * The children's status is the one their control loops last collected (see
+ * Orchestrator::getStatus), so reporting it does not drain what those loops
+ * rely on. Sizes, loads and memory bounds are summed, and latency histograms
+ * merged.
+ * Pools without a meaningful MRC yet are set aside an even share of the
+ * memory (as the control algorithms do), and the combined MRC of the others
+ * starts after it. Its miss ratios account for the requests of every pool.
+ */
+grpc::Status Aggregator::GetStatus(grpc::ServerContext *context,
+                                   const GetStatusRequest *request,
+                                   GetStatusResponse *response) {
+  auto const kChildStatus = m_kChildren->getStatus();
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_childStatus = kChildStatus;
+
+  auto aggregate = response->mutable_cachestatus();
+  PoolStatus poolStatus;
+  uint64_t cacheSize = 0, poolSize = 0, usedSize = 0, reservation = 0;
+  uint64_t limit = 0, allocFailures = 0, diskIOPS = 0, throughput = 0;
+  bool limited = true;
+  double proportion = 0.0, qosLevel = 0.0, misses = 0.0;
+  int pools = 0, newPools = 0;
+  std::map<uint64_t, uint64_t> hitLatency, missLatency;
+
+  for (const auto &[cacheId, cacheStatus] : kChildStatus) {
+    cacheSize += cacheStatus.m_maxSize;
+    proportion += cacheStatus.m_proportion;
+    for (const auto &[poolId, pool] : cacheStatus.m_pools) {
+      poolSize += pool.m_maxSize;
+      usedSize += pool.m_usedSize;
+      diskIOPS += pool.m_diskIOPS;
+      throughput += pool.m_throughput;
+      misses += pool.m_throughput * pool.m_missRatio;
+      qosLevel += pool.m_qosLevel;
+      reservation += pool.m_reservation;
+      limit += pool.m_limit;
+      limited = limited && pool.m_limit > 0;
+      allocFailures += pool.m_allocFailures;
+      for (const auto &[bound, count] : pool.m_hitLatency) {
+        hitLatency[bound] += count;
+      }
+      for (const auto &[bound, count] : pool.m_missLatency) {
+        missLatency[bound] += count;
+      }
+      if (pool.m_MRC.size() < m_kMRCMinLength) {
+        newPools++;
+      }
+      pools++;
+    }
+  }
+
+  // Curves of the pools with a meaningful MRC
+  m_ids.clear();
+  m_curves.clear();
+  m_unmodeledSize = pools > 0 ? newPools * (cacheSize / pools) : 0;
+  double modeledThroughput = 0.0, unmodeledThroughput = 0.0;
+  double unmodeledMisses = 0.0;
+  for (const auto &[cacheId, cacheStatus] : kChildStatus) {
+    for (const auto &[poolId, pool] : cacheStatus.m_pools) {
+      if (pool.m_MRC.size() < m_kMRCMinLength) {
+        unmodeledThroughput += pool.m_throughput;
+        unmodeledMisses += pool.m_throughput * pool.m_missRatio;
+        continue;
+      }
+      m_ids.emplace_back(cacheId, poolId);
+      m_curves.add(pool.m_MRC, pool.plannedThroughput(),
+                   cacheStatus.m_maxSize);
+      modeledThroughput += pool.plannedThroughput();
+    }
+  }
+
+  // Combined MRC, after the memory set aside for the unmodeled pools
+  double const kTotalThroughput = modeledThroughput + unmodeledThroughput;
+  if (kTotalThroughput > 0.0) {
+    auto &mrc = *poolStatus.mutable_mrc();
+    for (const auto &[size, missRatio] :
+         m_curves.combinedMRC(m_kMRCPoints)) {
+      mrc[size + m_unmodeledSize] =
+          (modeledThroughput * missRatio + unmodeledMisses) /
+          kTotalThroughput;
+    }
+  }
+
+  poolStatus.set_poolid(0);
+  poolStatus.set_maxsize(poolSize);
+  poolStatus.set_usedsize(usedSize);
+  poolStatus.set_diskiops(diskIOPS);
+  poolStatus.set_throughput(throughput);
+  poolStatus.set_missratio(throughput > 0 ? misses / throughput : 1.0);
+  poolStatus.set_qos(qosLevel);
+  poolStatus.set_proportion(1.0);
+  *poolStatus.mutable_hitlatency() = {hitLatency.begin(), hitLatency.end()};
+  *poolStatus.mutable_misslatency() = {missLatency.begin(),
+                                       missLatency.end()};
+  poolStatus.set_reservation(reservation);
+  poolStatus.set_limit(limited ? limit : 0);
+  poolStatus.set_allocfailures(allocFailures);
+
+  aggregate->set_maxsize(cacheSize);
+  aggregate->set_proportion(proportion);
+  (*aggregate->mutable_pools())[0] = poolStatus;
+  return grpc::Status::OK;
+}
+
+/**
+ * @brief Redistributes the budget assigned to the pool among the children.
+ *
+ * Pools without a meaningful MRC get an even share of the budget; the rest
+ * goes where it maximizes the aggregated hit throughput, beyond the pools'
+ * reservations.
+ */
+grpc::Status Aggregator::Resize(grpc::ServerContext *context,
+                                const ResizeRequest *request,
+                                ResizeResponse *response) {
+  auto const kBudgetIt = request->poolsizes().find(0);
+  if (kBudgetIt == request->poolsizes().end()) {
+    return grpc::Status::OK;
+  }
+  uint64_t const kBudget = kBudgetIt->second;
+
+  std::vector<ProxyManager::CacheResize> cacheResizes;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    int pools = 0, newPools = 0;
+    for (const auto &[cacheId, cacheStatus] : m_childStatus) {
+      for (const auto &[poolId, pool] : cacheStatus.m_pools) {
+        if (pool.m_MRC.size() < m_kMRCMinLength) {
+          newPools++;
+        }
+        pools++;
+      }
+    }
+    if (pools == 0) {
+      return grpc::Status::OK;
+    }
+
+    uint64_t const kNewPoolSize = kBudget / pools;
+    std::vector<uint64_t> floors;
+    for (const auto &[cacheId, poolId] : m_ids) {
+      floors.push_back(m_childStatus[cacheId].m_pools[poolId].m_reservation);
+    }
+    auto const kSizes =
+        m_curves.efficient(floors, kBudget - newPools * kNewPoolSize);
+
+    std::unordered_map<std::string, std::unordered_map<PoolId, uint64_t>>
+        newPoolSizePerCache;
+    for (const auto &[cacheId, cacheStatus] : m_childStatus) {
+      for (const auto &[poolId, pool] : cacheStatus.m_pools) {
+        newPoolSizePerCache[cacheId][poolId] = kNewPoolSize;
+      }
+    }
+    for (size_t i = 0; i < m_ids.size(); i++) {
+      newPoolSizePerCache[m_ids[i].first][m_ids[i].second] = kSizes[i];
+    }
+
+    for (const auto &[cacheId, sizes] : newPoolSizePerCache) {
+      std::vector<ProxyManager::PoolResize> poolResizes;
+      for (const auto &[poolId, size] : sizes) {
+        poolResizes.emplace_back(
+            ProxyManager::PoolResize{.m_kId = poolId, .m_kSize = size});
+      }
+      cacheResizes.emplace_back(ProxyManager::CacheResize{
+          .m_kName = cacheId, .m_kPoolResizes = poolResizes});
+    }
+  }
+
+  m_kChildren->resize(cacheResizes);
+  return grpc::Status::OK;
+}
+
+} // namespace holpaca
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <grpcpp/server.h>
+#include <holpaca/control-plane/ProxyManager.h>
+#include <holpaca/control-plane/algorithms/FairAllocation.h>
+#include <holpaca/protos/Holpaca.grpc.pb.h>
+#include <holpaca/protos/Holpaca.pb.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace holpaca {
+
+/**
+ * @brief Mid-tier of a hierarchy of orchestrators.
+ *
+ * Presents the caches of an orchestrator (its children) to a root
+ * orchestrator as a single agent with a single pool. The pool's MRC is the
+ * combination of the children's curves (see FairAllocation::combinedMRC),
+ * so the root optimizes one curve per aggregator rather than one per pool.
+ * The size the root assigns to that pool is the aggregator's memory budget,
+ * which it redistributes among its children to maximize their aggregated
+ * hit throughput. Aggregators can be stacked, so each tier only handles a
+ * bounded number of children.
+ */
+class Aggregator : public AgentRPC::Service {
+
+  /* Minimum MRC length to consider a pool for optimization */
+  const uint32_t m_kMRCMinLength{3};
+
+  /* Number of points of the combined MRC */
+  const size_t m_kMRCPoints{64};
+
+  /* Caches aggregated (usually the orchestrator of the tier) */
+  ProxyManager *const m_kChildren;
+
+  /* Address on which the aggregator exposes its agent gRPC server */
+  std::string const m_kAddress;
+
+  /* gRPC server answering the root orchestrator */
+  std::unique_ptr<grpc::Server> m_server;
+
+  /* Thread running the gRPC server event loop */
+  std::thread m_serverThread;
+
+  /* Stub of the root orchestrator */
+  std::shared_ptr<OrchestratorRPC::Stub> m_root;
+
+  /* Protects the state below, used by concurrent RPCs */
+  std::mutex m_mutex;
+
+  /* Status of the children at the last GetStatus */
+  std::unordered_map<std::string, ProxyManager::CacheStatus> m_childStatus;
+
+  /* Modeled pool of each curve of m_curves */
+  std::vector<std::pair<std::string, PoolId>> m_ids;
+
+  /* Hit ratio curves of the modeled pools at the last GetStatus */
+  FairAllocation m_curves;
+
+  /* Memory reserved for the pools without an MRC at the last GetStatus */
+  uint64_t m_unmodeledSize{0};
+
+  /**
+   * @brief Collects the children's status and reports it as one pool.
+   */
+  grpc::Status GetStatus(grpc::ServerContext *context,
+                         const GetStatusRequest *request,
+                         GetStatusResponse *response) override final;
+
+  /**
+   * @brief Redistributes the budget assigned to the pool among the children.
+   */
+  grpc::Status Resize(grpc::ServerContext *context,
+                      const ResizeRequest *request,
+                      ResizeResponse *response) override final;
+
+public:
+  /**
+   * @brief Starts the agent gRPC server and connects to the root
+   * orchestrator.
+   *
+   * @param kChildren Caches to aggregate
+   * @param kAddress Address for the agent gRPC server
+   * @param kRootAddress Address of the root orchestrator
+   * @param kDomain Control domain declared to the root orchestrator
+   */
+  Aggregator(ProxyManager *const kChildren, std::string const &kAddress,
+             std::string const &kRootAddress, std::string const &kDomain);
+
+  /**
+   * @brief Disconnects from the root orchestrator and stops the server.
+   */
+  ~Aggregator();
+};
+
+} // namespace holpaca
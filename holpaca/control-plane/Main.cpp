@@ -1,10 +1,19 @@
+#include <holpaca/control-plane/Aggregator.h>
 #include <holpaca/control-plane/Orchestrator.h>
+#include <holpaca/control-plane/algorithms/BackendCapacity.h>
 #include <holpaca/control-plane/algorithms/ControlAlgorithm.h>
+#include <holpaca/control-plane/algorithms/FairnessBlend.h>
+#include <holpaca/control-plane/algorithms/IdleTax.h>
+#include <holpaca/control-plane/algorithms/LatencySLO.h>
 #include <holpaca/control-plane/algorithms/Motivation.h>
 #include <holpaca/control-plane/algorithms/PerformanceMaximization.h>
+#include <holpaca/control-plane/algorithms/QoSFloors.h>
+#include <holpaca/control-plane/algorithms/WeightedShare.h>
 
 #include <chrono>
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <sstream>
 #include <thread>
 
@@ -68,6 +77,66 @@ int main(int argc, char **argv) {
         << "      (Optional) Colon-separated arguments passed to the control "
            "algorithm.\n\n"
 
+        << "  Stabilizer <min gain:min delta:cooldown:max pools[:flips:"
+           "damping]>\n"
+        << "      (Optional) Filters the resizes of the control algorithms "
+           "that follow it.\n\n"
+
+        << "  Domain <name>\n"
+        << "      (Optional) Applies the stabilizers, pipelines and control "
+           "algorithms that\n"
+        << "      follow it to the agents of the given control domain only "
+           "(those preceding\n"
+        << "      any Domain apply to agents that declare no domain).\n\n"
+
+        << "  Workers <count>\n"
+        << "      (Optional) Maximum number of threads running the control "
+           "algorithms of all\n"
+        << "      domains (must precede them; defaults to the number of "
+           "cores).\n\n"
+
+        << "  Aggregate <root host:root port:host:port[:domain]>\n"
+        << "      (Optional) Joins the root orchestrator at root host:root "
+           "port as an agent\n"
+        << "      (serving on host:port) with a single pool, whose MRC "
+           "combines those of\n"
+        << "      the agents of this orchestrator and whose size is "
+           "redistributed among them.\n\n"
+
+        << "  Adaptive <min period:max period[:low change:high change:"
+           "shrink:growth]>\n"
+        << "      (Optional) Shortens the period of the control algorithms "
+           "that follow it\n"
+        << "      when the MRCs or throughputs change faster than high "
+           "change, and lengthens\n"
+        << "      it while they change slower than low change.\n\n"
+
+        << "  Prefetch <staleness>\n"
+        << "      (Optional) Collects the status of the control algorithms "
+           "that follow it\n"
+        << "      ahead of their loops, overlapping with the previous loop, "
+           "and discards it\n"
+        << "      if older than staleness (ms) when the loop starts.\n\n"
+
+        << "  Pipeline <periodicity>\n"
+        << "      (Optional) Runs the control algorithms that follow it as "
+           "stages of one\n"
+        << "      control round, in order, collecting the status and "
+           "enforcing the result\n"
+        << "      once. Place a Stabilizer before it to filter the combined "
+           "resizes. Only one\n"
+        << "      stage may run a QoS controller (QoSFloors, or "
+           "ThroughputMaximization\n"
+        << "      with QoS gains); later ones are rejected.\n\n"
+
+        << "  Forecast <sample period:season length[:horizon:alpha:beta:"
+           "gamma]>\n"
+        << "      (Optional) Lets the control algorithms plan for the "
+           "throughput forecast\n"
+        << "      by Holt-Winters over one sample per sample period (ms); the "
+           "season length\n"
+        << "      and horizon are in samples.\n\n"
+
         << "EXAMPLES\n"
         << "  " << argv[0]
         << " localhost:11110 ThroughputMaximization 1000:0.01\n\n"
@@ -80,6 +149,9 @@ int main(int argc, char **argv) {
   // Start the orchestrator server
   Orchestrator orchestrator(argv[1]);
 
+  // Tier joining a root orchestrator, if any
+  std::unique_ptr<Aggregator> aggregator;
+
   // Parse control algorithm arguments if any
   for (int i = 2; i < argc; i += 2) {
     if (i + 1 >= argc) {
@@ -98,15 +170,25 @@ int main(int argc, char **argv) {
             << "ThroughputMaximization requires 2 arguments: <periodicity "
                "(ms)> "
                "<max delta ([0,1])> [fake enforce?] "
-               "[print latencies on #entries]"
+               "[print latencies on #entries] [QoS kp] [QoS ki] [QoS kd]"
             << std::endl;
         return 1;
       }
 
+      // QoS controller, enabled by its proportional gain
+      std::optional<QoSController::Gains> qosGains;
+      if (args.size() > 4) {
+        qosGains = QoSController::Gains{
+            .m_kp = std::stod(args[4]),
+            .m_ki = std::stod(args.size() > 5 ? args[5] : "0"),
+            .m_kd = std::stod(args.size() > 6 ? args[6] : "0"),
+        };
+      }
+
       orchestrator.addAlgorithm<PerformanceMaximization>(
           std::chrono::milliseconds(std::stoul(args[0])), std::stod(args[1]),
           args.size() > 2 && args[2] == "true",
-          std::stol(args.size() > 3 ? args[3] : "0"));
+          std::stol(args.size() > 3 ? args[3] : "0"), qosGains);
 
       // Motivation algorithm
     } else if (std::string(argv[i]) == "Motivation") {
@@ -119,6 +201,224 @@ int main(int argc, char **argv) {
       orchestrator.addAlgorithm<Motivation>(
           std::chrono::milliseconds(std::stoul(args[0])));
 
+      // LatencySLO algorithm
+    } else if (std::string(argv[i]) == "LatencySLO") {
+      if (args.size() < 1) {
+        std::cerr << "LatencySLO requires 1 argument: <periodicity (ms)> "
+                     "[percentile ((0,1), default 0.99)]"
+                  << std::endl;
+        return 1;
+      }
+
+      orchestrator.addAlgorithm<LatencySLO>(
+          std::chrono::milliseconds(std::stoul(args[0])),
+          std::stod(args.size() > 1 ? args[1] : "0.99"));
+
+      // WeightedShare algorithm
+    } else if (std::string(argv[i]) == "WeightedShare") {
+      if (args.size() < 1) {
+        std::cerr << "WeightedShare requires 1 argument: <periodicity (ms)> "
+                     "[idle utilization threshold ((0,1], default 0.9)]"
+                  << std::endl;
+        return 1;
+      }
+
+      orchestrator.addAlgorithm<WeightedShare>(
+          std::chrono::milliseconds(std::stoul(args[0])),
+          std::stod(args.size() > 1 ? args[1] : "0.9"));
+
+      // IdleTax algorithm
+    } else if (std::string(argv[i]) == "IdleTax") {
+      if (args.size() < 2) {
+        std::cerr << "IdleTax requires 2 arguments: <periodicity (ms)> "
+                     "<tax rate ((0,1])>"
+                  << std::endl;
+        return 1;
+      }
+
+      orchestrator.addAlgorithm<IdleTax>(
+          std::chrono::milliseconds(std::stoul(args[0])), std::stod(args[1]));
+
+      // MaxMinFairness algorithm
+    } else if (std::string(argv[i]) == "MaxMinFairness") {
+      if (args.size() < 1) {
+        std::cerr << "MaxMinFairness requires 1 argument: <periodicity (ms)>"
+                  << std::endl;
+        return 1;
+      }
+
+      orchestrator.addAlgorithm<MaxMinFairness>(
+          std::chrono::milliseconds(std::stoul(args[0])));
+
+      // FairnessBlend algorithm
+    } else if (std::string(argv[i]) == "FairnessBlend") {
+      if (args.size() < 2) {
+        std::cerr << "FairnessBlend requires 2 arguments: <periodicity (ms)> "
+                     "<alpha ([0,1], 1 = max-min fair)>"
+                  << std::endl;
+        return 1;
+      }
+
+      orchestrator.addAlgorithm<FairnessBlend>(
+          std::chrono::milliseconds(std::stoul(args[0])), std::stod(args[1]));
+
+      // QoSFloors algorithm
+    } else if (std::string(argv[i]) == "QoSFloors") {
+      if (args.size() < 2) {
+        std::cerr << "QoSFloors requires 2 arguments: <periodicity (ms)> "
+                     "<QoS kp> [QoS ki] [QoS kd]"
+                  << std::endl;
+        return 1;
+      }
+
+      orchestrator.addAlgorithm<QoSFloors>(
+          std::chrono::milliseconds(std::stoul(args[0])),
+          QoSController::Gains{
+              .m_kp = std::stod(args[1]),
+              .m_ki = std::stod(args.size() > 2 ? args[2] : "0"),
+              .m_kd = std::stod(args.size() > 3 ? args[3] : "0"),
+          });
+
+      // Control domain (applies to everything that follows it)
+    } else if (std::string(argv[i]) == "Domain") {
+      if (args.size() < 1) {
+        std::cerr << "Domain requires 1 argument: <name>" << std::endl;
+        return 1;
+      }
+
+      orchestrator.addDomain(args[0]);
+
+      // Threads running the control algorithms
+    } else if (std::string(argv[i]) == "Workers") {
+      if (args.size() < 1) {
+        std::cerr << "Workers requires 1 argument: <count>" << std::endl;
+        return 1;
+      }
+
+      orchestrator.setWorkers(std::stoul(args[0]));
+
+      // Aggregator tier (joins a root orchestrator as a single agent)
+    } else if (std::string(argv[i]) == "Aggregate") {
+      if (args.size() < 4) {
+        std::cerr << "Aggregate requires 4 arguments: <root host> <root "
+                     "port> <host> <port> [domain]"
+                  << std::endl;
+        return 1;
+      }
+
+      aggregator = std::make_unique<Aggregator>(
+          static_cast<ProxyManager *>(&orchestrator), args[2] + ":" + args[3],
+          args[0] + ":" + args[1], args.size() > 4 ? args[4] : "");
+
+      // Control pipeline (the algorithms that follow it become its stages)
+    } else if (std::string(argv[i]) == "Pipeline") {
+      if (args.size() < 1) {
+        std::cerr << "Pipeline requires 1 argument: <periodicity (ms)>"
+                  << std::endl;
+        return 1;
+      }
+
+      orchestrator.addPipeline(std::chrono::milliseconds(std::stoul(args[0])));
+
+      // Resize stabilizer (applies to the algorithms that follow it)
+    } else if (std::string(argv[i]) == "Stabilizer") {
+      if (args.size() < 4) {
+        std::cerr << "Stabilizer requires 4 arguments: <min gain> <min delta "
+                     "(bytes)> <cooldown (ms)> <max pools per round> "
+                     "[oscillation flips] [damping ([0,1])]"
+                  << std::endl;
+        return 1;
+      }
+
+      ResizeStabilizer::Config config;
+      config.m_minGain = std::stod(args[0]);
+      config.m_minDelta = std::stoull(args[1]);
+      config.m_cooldown = std::chrono::milliseconds(std::stoul(args[2]));
+      config.m_maxPools = std::stoul(args[3]);
+      if (args.size() > 4) {
+        config.m_oscillationFlips = std::stoul(args[4]);
+      }
+      if (args.size() > 5) {
+        config.m_damping = std::stod(args[5]);
+      }
+      orchestrator.addStabilizer(config);
+
+      // Adaptive period (applies to the algorithms that follow it)
+    } else if (std::string(argv[i]) == "Adaptive") {
+      if (args.size() < 2) {
+        std::cerr << "Adaptive requires 2 arguments: <min period (ms)> <max "
+                     "period (ms)> [low change] [high change] [shrink "
+                     "([0,1])] [growth (>1)]"
+                  << std::endl;
+        return 1;
+      }
+
+      AdaptivePeriod::Config config;
+      config.m_minPeriod = std::chrono::milliseconds(std::stoul(args[0]));
+      config.m_maxPeriod = std::chrono::milliseconds(std::stoul(args[1]));
+      if (args.size() > 2) {
+        config.m_lowChange = std::stod(args[2]);
+      }
+      if (args.size() > 3) {
+        config.m_highChange = std::stod(args[3]);
+      }
+      if (args.size() > 4) {
+        config.m_shrink = std::stod(args[4]);
+      }
+      if (args.size() > 5) {
+        config.m_growth = std::stod(args[5]);
+      }
+      orchestrator.addAdaptivePeriod(config);
+
+      // Status prefetch (applies to the algorithms that follow it)
+    } else if (std::string(argv[i]) == "Prefetch") {
+      if (args.size() < 1) {
+        std::cerr << "Prefetch requires 1 argument: <staleness (ms)>"
+                  << std::endl;
+        return 1;
+      }
+
+      orchestrator.addPrefetch(std::chrono::milliseconds(std::stoul(args[0])));
+
+      // Throughput forecasting (reported to every algorithm)
+    } else if (std::string(argv[i]) == "Forecast") {
+      if (args.size() < 2) {
+        std::cerr << "Forecast requires 2 arguments: <sample period (ms)> "
+                     "<season length (samples, 0 = none)> [horizon "
+                     "(samples)] [alpha] [beta] [gamma]"
+                  << std::endl;
+        return 1;
+      }
+
+      ThroughputForecaster::Config config;
+      config.m_samplePeriod = std::chrono::milliseconds(std::stoul(args[0]));
+      config.m_seasonLength = std::stoul(args[1]);
+      if (args.size() > 2) {
+        config.m_horizon = std::stoul(args[2]);
+      }
+      if (args.size() > 3) {
+        config.m_alpha = std::stod(args[3]);
+      }
+      if (args.size() > 4) {
+        config.m_beta = std::stod(args[4]);
+      }
+      if (args.size() > 5) {
+        config.m_gamma = std::stod(args[5]);
+      }
+      orchestrator.addForecaster(config);
+
+      // BackendCapacity algorithm
+    } else if (std::string(argv[i]) == "BackendCapacity") {
+      if (args.size() < 2) {
+        std::cerr << "BackendCapacity requires 2 arguments: <periodicity "
+                     "(ms)> <backend capacity (IOPS)>"
+                  << std::endl;
+        return 1;
+      }
+
+      orchestrator.addAlgorithm<BackendCapacity>(
+          std::chrono::milliseconds(std::stoul(args[0])), std::stod(args[1]));
+
     } else {
       std::cerr << "Unknown control algorithm: " << argv[i] << std::endl;
       return 1;
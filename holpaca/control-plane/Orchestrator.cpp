@@ -3,24 +3,104 @@
 #include <grpcpp/server_context.h>
 #include <holpaca/control-plane/Orchestrator.h>
 
+#include <algorithm>
 #include <numeric>
 
 namespace holpaca {
 
 /**
- * @brief Collects status information from all connected agents.
+ * @brief Snapshot of the connected agents, so that RPCs are issued without
+ * blocking agents that connect or disconnect meanwhile.
  *
- * For each registered proxy, issues a GetStatus RPC and aggregates
- * cache- and pool-level statistics into a unified structure consumed
- * by control algorithms.
+ * @param kDomain Control domain of the agents (all domains if null)
+ * @return Cache address and stub of each agent
+ */
+Orchestrator::Proxies Orchestrator::proxies(std::string const *const kDomain) {
+  std::lock_guard<std::mutex> lock(m_proxiesMutex);
+  Proxies proxies;
+  for (const auto &[peer, proxy] : m_proxies) {
+    if (kDomain == nullptr || m_cacheDomains[peer] == *kDomain) {
+      proxies.emplace_back(peer, proxy);
+    }
+  }
+  return proxies;
+}
+
+/**
+ * @brief Status of all connected agents, as last collected by the control
+ * loops of their domains.
+ *
+ * Collecting the status drains the latency histograms and allocation
+ * failures of the agents, which the loops of the domains rely on, so the
+ * status they last collected is served instead. Agents no loop collected yet
+ * (e.g., in a domain without an algorithm) are collected, but their status
+ * is not kept.
  *
  * @return Map of cache names (address) to their CacheStatus
  */
 std::unordered_map<std::string, ProxyManager::CacheStatus>
 Orchestrator::getStatus() {
   std::unordered_map<std::string, ProxyManager::CacheStatus> cacheStatus;
+  Proxies uncollected;
+  Proxies connected = proxies(nullptr);
+  {
+    std::lock_guard<std::mutex> lock(m_lastStatusMutex);
+    for (auto &proxy : connected) {
+      auto const kLastStatus = m_lastStatus.find(proxy.first);
+      if (kLastStatus != m_lastStatus.end()) {
+        cacheStatus.insert(*kLastStatus);
+      } else {
+        uncollected.push_back(std::move(proxy));
+      }
+    }
+  }
+  cacheStatus.merge(collect(uncollected));
+  return cacheStatus;
+}
 
-  for (const auto &[peer, proxy] : m_proxies) {
+/**
+ * @brief Issues resize commands to all connected agents.
+ *
+ * @param cacheResize Vector of CacheResize instructions
+ */
+void Orchestrator::resize(
+    const std::vector<ProxyManager::CacheResize> &cacheResize) {
+  resize(proxies(nullptr), cacheResize);
+}
+
+/**
+ * @brief Collects status information from the given agents for a domain,
+ * and keeps it as their last status (see getStatus()).
+ *
+ * @param kProxies Caches to query
+ * @return Map of cache names (address) to their CacheStatus
+ */
+std::unordered_map<std::string, ProxyManager::CacheStatus>
+Orchestrator::getStatus(Proxies const &kProxies) {
+  auto cacheStatus = collect(kProxies);
+  std::lock_guard<std::mutex> lock(m_lastStatusMutex);
+  for (const auto &[peer, status] : cacheStatus) {
+    m_lastStatus[peer] = status;
+  }
+  return cacheStatus;
+}
+
+/**
+ * @brief Collects status information from the given agents.
+ *
+ * For each proxy, issues a GetStatus RPC and aggregates cache- and
+ * pool-level statistics into a unified structure consumed by control
+ * algorithms. When forecasting is enabled, the throughput of each pool is
+ * kept for the forecast sampler and its latest forecast is reported.
+ *
+ * @param kProxies Caches to query
+ * @return Map of cache names (address) to their CacheStatus
+ */
+std::unordered_map<std::string, ProxyManager::CacheStatus>
+Orchestrator::collect(Proxies const &kProxies) {
+  std::unordered_map<std::string, ProxyManager::CacheStatus> cacheStatus;
+
+  for (const auto &[peer, proxy] : kProxies) {
     ::grpc::ClientContext context;
     GetStatusRequest request;
     GetStatusResponse response;
@@ -46,7 +126,27 @@ Orchestrator::getStatus() {
           .m_qosLevel = ps.qos(),
           .m_proportion = ps.proportion(),
           .m_MRC = {ps.mrc().begin(), ps.mrc().end()},
+          .m_hitLatency = {ps.hitlatency().begin(), ps.hitlatency().end()},
+          .m_missLatency = {ps.misslatency().begin(), ps.misslatency().end()},
+          .m_latencySLO = ps.latencyslo(),
+          .m_reservation = ps.reservation(),
+          .m_limit = ps.limit(),
+          .m_allocFailures = ps.allocfailures(),
       };
+
+      // Keep the throughput for the sampler and report the forecast peak
+      if (m_forecasterConfig) {
+        std::lock_guard<std::mutex> lock(m_forecastersMutex);
+        m_observedThroughput[peer][poolId] = ps.throughput();
+        auto const kForecasters = m_forecasters.find(peer);
+        if (kForecasters != m_forecasters.end()) {
+          auto const kForecaster = kForecasters->second.find(poolId);
+          if (kForecaster != kForecasters->second.end()) {
+            cacheStatus[peer].m_pools[poolId].m_predictedThroughput =
+                kForecaster->second.peak();
+          }
+        }
+      }
     }
   }
 
@@ -54,24 +154,33 @@ Orchestrator::getStatus() {
 }
 
 /**
- * @brief Issues resize commands to all connected agents.
+ * @brief Issues resize commands to the given agents.
  *
- * Each CacheResize operation corresponds to one active proxy.
- * If the number of operations does not match the number of proxies,
- * resizing is skipped.
+ * Each CacheResize operation corresponds to one of the proxies.
+ * If the operations do not match the proxies (e.g., an agent connected
+ * since the status was collected), resizing is skipped.
  *
+ * @param kProxies Caches to resize
  * @param cacheResize Vector of CacheResize instructions
  */
 void Orchestrator::resize(
+    Proxies const &kProxies,
     const std::vector<ProxyManager::CacheResize> &cacheResize) {
 
-  // Ensure one resize operation per connected agent
-  if (cacheResize.size() != m_proxies.size()) {
+  // Ensure one resize operation per agent
+  if (cacheResize.size() != kProxies.size()) {
     return;
   }
+  std::unordered_map<std::string, std::shared_ptr<AgentRPC::Stub>> stubs(
+      kProxies.begin(), kProxies.end());
+  for (const auto &resizeOp : cacheResize) {
+    if (stubs.find(resizeOp.m_kName) == stubs.end()) {
+      return;
+    }
+  }
 
   for (const auto &resizeOp : cacheResize) {
-    auto proxy = m_proxies[resizeOp.m_kName];
+    auto proxy = stubs[resizeOp.m_kName];
     ::grpc::ClientContext context;
     ResizeRequest request;
     ResizeResponse response;
@@ -88,18 +197,22 @@ void Orchestrator::resize(
 }
 
 /**
- * @brief Registers a new agent and creates a gRPC stub for it.
+ * @brief Registers a new agent in its control domain and creates a gRPC stub
+ * for it.
  *
  * @param context gRPC server context
- * @param request ConnectRequest containing the cache address
+ * @param request ConnectRequest containing the cache address and domain
  * @param response ConnectResponse to fill
  * @return grpc::Status OK if successful
  */
 grpc::Status Orchestrator::Connect(grpc::ServerContext *context,
                                    const ConnectRequest *request,
                                    ConnectResponse *response) {
-  m_proxies[request->cacheaddress()] = AgentRPC::NewStub(grpc::CreateChannel(
+  std::shared_ptr<AgentRPC::Stub> stub = AgentRPC::NewStub(grpc::CreateChannel(
       request->cacheaddress(), grpc::InsecureChannelCredentials()));
+  std::lock_guard<std::mutex> lock(m_proxiesMutex);
+  m_proxies[request->cacheaddress()] = std::move(stub);
+  m_cacheDomains[request->cacheaddress()] = request->domain();
   return grpc::Status::OK;
 }
 
@@ -114,7 +227,108 @@ grpc::Status Orchestrator::Connect(grpc::ServerContext *context,
 grpc::Status Orchestrator::Disconnect(grpc::ServerContext *context,
                                       const DisconnectRequest *request,
                                       DisconnectResponse *response) {
-  m_proxies.erase(request->cacheaddress());
+  {
+    std::lock_guard<std::mutex> lock(m_proxiesMutex);
+    m_proxies.erase(request->cacheaddress());
+    m_cacheDomains.erase(request->cacheaddress());
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_lastStatusMutex);
+    m_lastStatus.erase(request->cacheaddress());
+  }
+  std::lock_guard<std::mutex> lock(m_forecastersMutex);
+  m_forecasters.erase(request->cacheaddress());
+  m_observedThroughput.erase(request->cacheaddress());
+  return grpc::Status::OK;
+}
+
+/**
+ * @brief Records the throughput last observed of each pool into its
+ * forecaster.
+ *
+ * Run once per sample period by the ForecastSampler, so each series gets
+ * exactly one sample per period, whatever the number of domains, consumers
+ * and collections. A pool not observed during the period repeats its last
+ * sample. Caches that disconnected while being collected are dropped.
+ */
+void Orchestrator::sampleThroughput() {
+  Proxies const kConnected = proxies(nullptr);
+  std::lock_guard<std::mutex> lock(m_forecastersMutex);
+  for (auto it = m_observedThroughput.begin();
+       it != m_observedThroughput.end();) {
+    if (std::none_of(kConnected.begin(), kConnected.end(),
+                     [&](auto const &kProxy) {
+                       return kProxy.first == it->first;
+                     })) {
+      m_forecasters.erase(it->first);
+      it = m_observedThroughput.erase(it);
+    } else {
+      it++;
+    }
+  }
+  for (const auto &[peer, pools] : m_observedThroughput) {
+    auto &forecasters = m_forecasters[peer];
+    for (const auto &[poolId, throughput] : pools) {
+      forecasters.try_emplace(poolId, *m_forecasterConfig)
+          .first->second.record(throughput);
+    }
+  }
+}
+
+/**
+ * @brief Enables throughput forecasting, sampled by a ForecastSampler
+ * scheduled with the control algorithms.
+ */
+Orchestrator &
+Orchestrator::addForecaster(ThroughputForecaster::Config const &kConfig) {
+  std::lock_guard<std::mutex> lock(m_domainsMutex);
+  if (m_forecastSampler) {
+    scheduler().remove(m_forecastSampler.get());
+  }
+  {
+    std::lock_guard<std::mutex> forecastersLock(m_forecastersMutex);
+    m_forecasterConfig = kConfig;
+    m_forecasters.clear();
+  }
+  m_forecastSampler =
+      std::make_unique<ForecastSampler>(this, kConfig.m_samplePeriod);
+  scheduler().add(m_forecastSampler.get());
+  return *this;
+}
+
+/**
+ * @brief Handles a change notification from an agent.
+ *
+ * The control algorithm of the agent's domain is made due immediately (see
+ * ControlScheduler::trigger); notifications of unknown agents or domains
+ * without an algorithm are ignored.
+ *
+ * @param context gRPC server context
+ * @param request NotifyRequest containing the agent address and its changes
+ * @param response NotifyResponse (unused)
+ * @return gRPC status OK
+ */
+grpc::Status Orchestrator::Notify(grpc::ServerContext *context,
+                                  const NotifyRequest *request,
+                                  NotifyResponse *response) {
+  std::string domain;
+  {
+    std::lock_guard<std::mutex> lock(m_proxiesMutex);
+    auto const kCacheDomain = m_cacheDomains.find(request->cacheaddress());
+    if (kCacheDomain == m_cacheDomains.end()) {
+      return grpc::Status::OK;
+    }
+    domain = kCacheDomain->second;
+  }
+
+  std::lock_guard<std::mutex> lock(m_domainsMutex);
+  auto const kDomain = m_domains.find(domain);
+  if (!m_scheduler || kDomain == m_domains.end() ||
+      !kDomain->second.m_controlAlgorithm) {
+    return grpc::Status::OK;
+  }
+
+  m_scheduler->trigger(kDomain->second.m_controlAlgorithm.get());
   return grpc::Status::OK;
 }
 
@@ -131,12 +345,65 @@ Orchestrator::Orchestrator(const std::string &kOrchestratorAddress)
                     .BuildAndStart()),
       m_serverThread([this] { m_kServer->Wait(); }) {}
 
+/**
+ * @brief Scheduler of the control loops, created on first use.
+ */
+ControlScheduler &Orchestrator::scheduler() {
+  if (!m_scheduler) {
+    m_scheduler = std::make_unique<ControlScheduler>(m_maxWorkers);
+  }
+  return *m_scheduler;
+}
+
+/**
+ * @brief Control state of the configured domain, created if missing.
+ */
+Orchestrator::Domain &Orchestrator::configuredDomain() {
+  std::lock_guard<std::mutex> lock(m_domainsMutex);
+  auto [it, inserted] = m_domains.try_emplace(m_configuredDomain);
+  if (inserted) {
+    it->second.m_proxy = std::make_unique<DomainProxy>(this, it->first);
+  }
+  return it->second;
+}
+
+/**
+ * @brief Replaces the control algorithm of a domain and schedules it.
+ *
+ * The previous algorithm is unscheduled (waiting for its running loop)
+ * before being destroyed.
+ *
+ * @param domain Control state of the domain
+ * @param algorithm New control algorithm
+ */
+void Orchestrator::install(Domain &domain,
+                           std::unique_ptr<ControlAlgorithm> algorithm) {
+  std::lock_guard<std::mutex> lock(m_domainsMutex);
+  if (domain.m_controlAlgorithm) {
+    scheduler().remove(domain.m_controlAlgorithm.get());
+  }
+  domain.m_pipeline = nullptr;
+  if (domain.m_prefetchStaleness) {
+    algorithm->setStatusPrefetch(*domain.m_prefetchStaleness);
+  }
+  if (domain.m_adaptivePeriod) {
+    algorithm->setAdaptivePeriod(*domain.m_adaptivePeriod);
+  }
+  domain.m_controlAlgorithm = std::move(algorithm);
+  scheduler().add(domain.m_controlAlgorithm.get());
+}
+
 /**
  * @brief Gracefully shuts down the orchestrator and stops all background
  * activity.
  */
 Orchestrator::~Orchestrator() {
-  m_controlAlgorithm.reset();
+  // Stop the loops before the algorithms they call into are destroyed
+  {
+    std::lock_guard<std::mutex> lock(m_domainsMutex);
+    m_scheduler.reset();
+    m_domains.clear();
+  }
   m_stop.exchange(true);
 
   if (m_kServer != nullptr) {
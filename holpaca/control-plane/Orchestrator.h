@@ -1,14 +1,27 @@
 #pragma once
 
 #include <grpcpp/server.h>
+#include <holpaca/control-plane/AdaptivePeriod.h>
 #include <holpaca/control-plane/ProxyManager.h>
+#include <holpaca/control-plane/ResizeStabilizer.h>
+#include <holpaca/control-plane/ThroughputForecaster.h>
 #include <holpaca/control-plane/algorithms/ControlAlgorithm.h>
+#include <holpaca/control-plane/algorithms/ControlPipeline.h>
+#include <holpaca/control-plane/algorithms/ControlScheduler.h>
+#include <holpaca/control-plane/algorithms/PipelineStage.h>
 #include <holpaca/protos/Holpaca.grpc.pb.h>
 #include <holpaca/protos/Holpaca.pb.h>
 
+#include <algorithm>
 #include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <thread>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace holpaca {
 
@@ -16,9 +29,95 @@ namespace holpaca {
  * @brief Orchestrator implements the control-plane gRPC service.
  * Coordinates multiple agents, manages cache status, and applies resizing
  * decisions.
+ *
+ * Agents declare a control domain when connecting (the default domain if
+ * none). Each domain has its own control algorithm, which only sees and
+ * resizes the caches of that domain, so its memory budget is the memory of
+ * those caches. The algorithms of all domains, each with its own period,
+ * run on a shared ControlScheduler thread pool. An agent that notifies a
+ * significant change of its workload gets its domain reallocated right away.
  */
 class Orchestrator : public OrchestratorRPC::Service, public ProxyManager {
 
+  /**
+   * @brief ProxyManager restricted to the caches of one control domain.
+   */
+  class DomainProxy : public ProxyManager {
+    /* Orchestrator owning the caches */
+    Orchestrator *const m_kOrchestrator;
+
+    /* Control domain of the caches */
+    std::string const m_kDomain;
+
+  public:
+    DomainProxy(Orchestrator *const kOrchestrator, std::string const &kDomain)
+        : m_kOrchestrator(kOrchestrator), m_kDomain(kDomain) {}
+
+    std::unordered_map<std::string, ProxyManager::CacheStatus>
+    getStatus() override final {
+      return m_kOrchestrator->getStatus(m_kOrchestrator->proxies(&m_kDomain));
+    }
+
+    void resize(const std::vector<ProxyManager::CacheResize> &cacheResize)
+        override final {
+      m_kOrchestrator->resize(m_kOrchestrator->proxies(&m_kDomain),
+                              cacheResize);
+    }
+  };
+
+  /**
+   * @brief Records one sample of each pool's throughput per sample period
+   * into its forecaster, scheduled alongside the control algorithms.
+   *
+   * The samples are the throughputs last observed by the status collections
+   * of the domains, so they neither depend on how often the status is
+   * collected nor trigger collections of their own.
+   */
+  class ForecastSampler : public ControlAlgorithm {
+    /* Orchestrator owning the forecasters */
+    Orchestrator *const m_kOrchestrator;
+
+  protected:
+    void loop(ProxyManager *const) override final {
+      m_kOrchestrator->sampleThroughput();
+    }
+
+  public:
+    ForecastSampler(Orchestrator *const kOrchestrator,
+                    std::chrono::milliseconds const kSamplePeriod)
+        : ControlAlgorithm(kOrchestrator, kSamplePeriod),
+          m_kOrchestrator(kOrchestrator) {}
+  };
+
+  /**
+   * @brief Control state of a domain.
+   */
+  struct Domain {
+    /* View of the caches of the domain */
+    std::unique_ptr<DomainProxy> m_proxy;
+
+    /* Filters applied to the decisions of the algorithms (last one active),
+     * kept alive for the algorithms installed before a newer one */
+    std::vector<std::unique_ptr<ResizeStabilizer>> m_stabilizers;
+
+    /* Active control algorithm of the domain */
+    std::unique_ptr<ControlAlgorithm> m_controlAlgorithm;
+
+    /* Active control algorithm if it is a pipeline taking stages, else null */
+    ControlPipeline *m_pipeline{nullptr};
+
+    /* Period adaptation of the algorithms installed next (fixed if empty) */
+    std::optional<AdaptivePeriod::Config> m_adaptivePeriod;
+
+    /* Staleness budget of the status prefetched for the algorithms installed
+     * next (collected in their loops if empty) */
+    std::optional<std::chrono::milliseconds> m_prefetchStaleness;
+  };
+
+  /* Cache address and stub of agents */
+  using Proxies =
+      std::vector<std::pair<std::string, std::shared_ptr<AgentRPC::Stub>>>;
+
   /* gRPC server instance for the orchestrator */
   std::shared_ptr<grpc::Server> const m_kServer;
 
@@ -31,8 +130,52 @@ class Orchestrator : public OrchestratorRPC::Service, public ProxyManager {
   /* Map of cache address to AgentRPC stubs for communicating with agents */
   std::unordered_map<std::string, std::shared_ptr<AgentRPC::Stub>> m_proxies;
 
-  /* Active control algorithm used to compute cache resizing decisions */
-  std::unique_ptr<ControlAlgorithm> m_controlAlgorithm;
+  /* Control domain of each connected agent, by cache address */
+  std::unordered_map<std::string, std::string> m_cacheDomains;
+
+  /* Protects the agents, which connect while the domains are controlled */
+  std::mutex m_proxiesMutex;
+
+  /* Throughput forecasting parameters (forecasting disabled if empty) */
+  std::optional<ThroughputForecaster::Config> m_forecasterConfig;
+
+  /* Throughput forecaster of each pool, per cache */
+  std::unordered_map<std::string,
+                     std::unordered_map<PoolId, ThroughputForecaster>>
+      m_forecasters;
+
+  /* Throughput last observed of each pool, per cache */
+  std::unordered_map<std::string, std::unordered_map<PoolId, double>>
+      m_observedThroughput;
+
+  /* Protects the forecasters and the observed throughputs, updated by the
+   * domains and the sampler concurrently */
+  std::mutex m_forecastersMutex;
+
+  /* Feeds the forecasters once per sample period (forecasting disabled if
+   * null) */
+  std::unique_ptr<ForecastSampler> m_forecastSampler;
+
+  /* Status of each cache at its last collection by a domain */
+  std::unordered_map<std::string, ProxyManager::CacheStatus> m_lastStatus;
+
+  /* Protects the last status, updated by the domains concurrently */
+  std::mutex m_lastStatusMutex;
+
+  /* Control state of each domain */
+  std::unordered_map<std::string, Domain> m_domains;
+
+  /* Protects the domains and the scheduler, looked up by notifications */
+  std::mutex m_domainsMutex;
+
+  /* Domain configured by the subsequent add* calls (default domain first) */
+  std::string m_configuredDomain;
+
+  /* Maximum number of threads running the control algorithms */
+  size_t m_maxWorkers{std::max(1u, std::thread::hardware_concurrency())};
+
+  /* Thread pool running the control algorithms of all domains */
+  std::unique_ptr<ControlScheduler> m_scheduler;
 
   /**
    * @brief Registers an agent with the orchestrator
@@ -57,7 +200,75 @@ class Orchestrator : public OrchestratorRPC::Service, public ProxyManager {
                           DisconnectResponse *response);
 
   /**
-   * @brief Retrieves the current status of all connected caches
+   * @brief Runs the control algorithm of an agent's domain out of band, as
+   * the workload of some of its pools changed significantly
+   * @param context gRPC server context
+   * @param request NotifyRequest from the agent
+   * @param response NotifyResponse to fill
+   * @return gRPC status of the operation
+   */
+  grpc::Status Notify(grpc::ServerContext *context,
+                      const NotifyRequest *request, NotifyResponse *response);
+
+  /**
+   * @brief Snapshot of the connected agents
+   * @param kDomain Control domain of the agents (all domains if null)
+   * @return Cache address and stub of each agent
+   */
+  Proxies proxies(std::string const *const kDomain);
+
+  /**
+   * @brief Retrieves the current status of the given caches
+   * @param kProxies Caches to query
+   * @return Map of cache names to their CacheStatus
+   */
+  std::unordered_map<std::string, ProxyManager::CacheStatus>
+  collect(Proxies const &kProxies);
+
+  /**
+   * @brief Retrieves the current status of the given caches for a domain,
+   * keeping it as their last status
+   * @param kProxies Caches to query
+   * @return Map of cache names to their CacheStatus
+   */
+  std::unordered_map<std::string, ProxyManager::CacheStatus>
+  getStatus(Proxies const &kProxies);
+
+  /**
+   * @brief Applies resize decisions to the given caches
+   * @param kProxies Caches to resize
+   * @param cacheResize Vector of CacheResize instructions
+   */
+  void resize(Proxies const &kProxies,
+              const std::vector<ProxyManager::CacheResize> &cacheResize);
+
+  /**
+   * @brief Records the throughput last observed of each pool into its
+   * forecaster (one sample per sample period)
+   */
+  void sampleThroughput();
+
+  /**
+   * @brief Scheduler of the control loops, created on first use (requires
+   * m_domainsMutex)
+   */
+  ControlScheduler &scheduler();
+
+  /**
+   * @brief Control state of the configured domain, created if missing
+   */
+  Domain &configuredDomain();
+
+  /**
+   * @brief Replaces the control algorithm of a domain and schedules it
+   * @param domain Control state of the domain
+   * @param algorithm New control algorithm
+   */
+  void install(Domain &domain, std::unique_ptr<ControlAlgorithm> algorithm);
+
+  /**
+   * @brief Retrieves the last status of all connected caches, without
+   * draining what the domains collect (e.g., for an Aggregator)
    * @return Map of cache names to their CacheStatus
    */
   std::unordered_map<std::string, ProxyManager::CacheStatus>
@@ -84,7 +295,9 @@ public:
   ~Orchestrator();
 
   /**
-   * @brief Installs a control algorithm
+   * @brief Installs a control algorithm for the configured domain, or
+   * appends it to the domain's pipeline as a stage if a pipeline is installed
+   * and the algorithm is a PipelineStage
    * @tparam T ControlAlgorithm type
    * @tparam Args Arguments for algorithm constructor
    * @param args Constructor arguments for the algorithm
@@ -92,8 +305,106 @@ public:
    */
   template <typename T, typename... Args>
   Orchestrator &addAlgorithm(Args... args) {
-    m_controlAlgorithm =
-        std::make_unique<T>(dynamic_cast<ProxyManager *const>(this), args...);
+    Domain &domain = configuredDomain();
+    ProxyManager *const kProxyManager =
+        domain.m_stabilizers.empty()
+            ? static_cast<ProxyManager *>(domain.m_proxy.get())
+            : static_cast<ProxyManager *>(domain.m_stabilizers.back().get());
+    if constexpr (std::is_base_of_v<PipelineStage, T>) {
+      if (domain.m_pipeline) {
+        domain.m_pipeline->addStage(
+            std::make_unique<T>(kProxyManager, args...));
+        return *this;
+      }
+    }
+    install(domain, std::make_unique<T>(kProxyManager, args...));
+    return *this;
+  }
+
+  /**
+   * @brief Installs a control pipeline for the configured domain: the
+   * algorithms installed next run as its stages, sharing one status
+   * collection and one enforcement per round
+   * @param kPeriodicity Time between control rounds
+   * @return Reference to this Orchestrator for chaining
+   */
+  Orchestrator &addPipeline(std::chrono::milliseconds const kPeriodicity) {
+    Domain &domain = configuredDomain();
+    ProxyManager *const kProxyManager =
+        domain.m_stabilizers.empty()
+            ? static_cast<ProxyManager *>(domain.m_proxy.get())
+            : static_cast<ProxyManager *>(domain.m_stabilizers.back().get());
+    auto pipeline =
+        std::make_unique<ControlPipeline>(kProxyManager, kPeriodicity);
+    ControlPipeline *const kPipeline = pipeline.get();
+    install(domain, std::move(pipeline));
+    domain.m_pipeline = kPipeline;
+    return *this;
+  }
+
+  /**
+   * @brief Selects the control domain that subsequently installed
+   * stabilizers, pipelines and algorithms apply to
+   * @param kDomain Name of the domain, as declared by its agents
+   * @return Reference to this Orchestrator for chaining
+   */
+  Orchestrator &addDomain(std::string const &kDomain) {
+    m_configuredDomain = kDomain;
+    return *this;
+  }
+
+  /**
+   * @brief Sets the maximum number of threads running the control
+   * algorithms (only before the first algorithm or forecaster is installed)
+   * @param kMaxWorkers Maximum number of threads (at least 1)
+   * @return Reference to this Orchestrator for chaining
+   */
+  Orchestrator &setWorkers(size_t const kMaxWorkers) {
+    m_maxWorkers = kMaxWorkers;
+    return *this;
+  }
+
+  /**
+   * @brief Enables throughput forecasting, reported to control algorithms
+   * through PoolStatus::m_predictedThroughput
+   * @param kConfig Forecasting parameters
+   * @return Reference to this Orchestrator for chaining
+   */
+  Orchestrator &addForecaster(ThroughputForecaster::Config const &kConfig);
+
+  /**
+   * @brief Adapts the period of the algorithms (or pipeline) subsequently
+   * installed for the configured domain to how fast its workloads change
+   * @param kConfig Adaptation parameters
+   * @return Reference to this Orchestrator for chaining
+   */
+  Orchestrator &addAdaptivePeriod(AdaptivePeriod::Config const &kConfig) {
+    configuredDomain().m_adaptivePeriod = kConfig;
+    return *this;
+  }
+
+  /**
+   * @brief Collects the status of the algorithms (or pipeline) subsequently
+   * installed for the configured domain ahead of their loops, overlapping
+   * with the computation and enforcement of the previous loop
+   * @param kStaleness Maximum age of a status collected ahead of time
+   * @return Reference to this Orchestrator for chaining
+   */
+  Orchestrator &addPrefetch(std::chrono::milliseconds const kStaleness) {
+    configuredDomain().m_prefetchStaleness = kStaleness;
+    return *this;
+  }
+
+  /**
+   * @brief Filters the decisions of algorithms subsequently installed for the
+   * configured domain through a ResizeStabilizer
+   * @param kConfig Stabilization parameters
+   * @return Reference to this Orchestrator for chaining
+   */
+  Orchestrator &addStabilizer(ResizeStabilizer::Config const &kConfig) {
+    Domain &domain = configuredDomain();
+    domain.m_stabilizers.push_back(
+        std::make_unique<ResizeStabilizer>(domain.m_proxy.get(), kConfig));
     return *this;
   }
 };
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <cachelib/allocator/memory/Slab.h>
+#include <cmath>
+#include <limits>
 #include <map>
 #include <string>
 #include <unordered_map>
@@ -28,6 +30,23 @@ public:
     double m_qosLevel{0.0};            /* Minimum throughput demand */
     double m_proportion{1.0};          /* MOTIVATION ONLY: pool proportion */
     std::map<uint64_t, float> m_MRC{}; /* Miss Ratio Curve */
+    std::map<uint64_t, uint64_t> m_hitLatency{};  /* Hit latency histogram */
+    std::map<uint64_t, uint64_t> m_missLatency{}; /* Miss latency histogram */
+    double m_latencySLO{0.0}; /* Target p99 read latency (us) */
+    uint64_t m_reservation{0}; /* Guaranteed memory (bytes) */
+    uint64_t m_limit{0};       /* Maximum memory (bytes, 0 = unlimited) */
+    uint64_t m_allocFailures{0}; /* Failed allocations since last status */
+    /* Forecast throughput for the upcoming periods (NaN if not forecast) */
+    double m_predictedThroughput{std::numeric_limits<double>::quiet_NaN()};
+
+    /**
+     * @brief Throughput to plan for: the forecast if available, otherwise
+     * the measured one.
+     */
+    double plannedThroughput() const {
+      return std::isnan(m_predictedThroughput) ? m_throughput
+                                               : m_predictedThroughput;
+    }
   };
 
   /**
@@ -45,6 +64,8 @@ public:
   struct PoolResize {
     PoolId m_kId;     /* Pool ID */
     uint64_t m_kSize; /* New size */
+    /* Predicted utility gain of the resize (NaN if unknown) */
+    double m_kGain{std::numeric_limits<double>::quiet_NaN()};
   };
 
   /**
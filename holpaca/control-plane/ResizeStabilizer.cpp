@@ -0,0 +1,153 @@
+#include <holpaca/control-plane/ResizeStabilizer.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace holpaca {
+
+/**
+ * @brief Constructs a stabilizer in front of the given ProxyManager.
+ */
+ResizeStabilizer::ResizeStabilizer(ProxyManager *const kProxyManager,
+                                   Config const &kConfig)
+    : m_kProxyManager(kProxyManager), m_kConfig(kConfig) {}
+
+/**
+ * @brief Forwards the status request to the underlying ProxyManager.
+ *
+ * Pool sizes are recorded so that resize decisions can be compared against
+ * the sizes the algorithm observed.
+ *
+ * @return Map of cache names (address) to their CacheStatus
+ */
+std::unordered_map<std::string, ProxyManager::CacheStatus>
+ResizeStabilizer::getStatus() {
+  auto cacheStatus = m_kProxyManager->getStatus();
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (const auto &[cacheId, status] : cacheStatus) {
+    auto &poolStates = m_poolStates[cacheId];
+    for (const auto &[poolId, poolStatus] : status.m_pools) {
+      poolStates[poolId].m_size = poolStatus.m_maxSize;
+    }
+  }
+
+  return cacheStatus;
+}
+
+/**
+ * @brief Filters the resize instructions and forwards the remainder.
+ *
+ * Pools not present in the last status are forwarded unchanged. Filtered
+ * pools keep their current size.
+ *
+ * @param cacheResize Vector of CacheResize instructions
+ */
+void ResizeStabilizer::resize(
+    const std::vector<ProxyManager::CacheResize> &cacheResize) {
+  auto const kNow = std::chrono::steady_clock::now();
+
+  // Dead band on the predicted gain of the whole round
+  double gain = 0.0;
+  bool gainKnown = false;
+  for (const auto &resizeOp : cacheResize) {
+    for (const auto &poolResize : resizeOp.m_kPoolResizes) {
+      if (!std::isnan(poolResize.m_kGain)) {
+        gain += poolResize.m_kGain;
+        gainKnown = true;
+      }
+    }
+  }
+  if (gainKnown && gain < m_kConfig.m_minGain) {
+    return;
+  }
+
+  /* A pool change that survived the per-pool filters */
+  struct Change {
+    PoolResize *m_poolResize;
+    PoolState *m_state;
+    int64_t m_delta;
+    uint32_t m_flips;
+  };
+
+  std::vector<ProxyManager::CacheResize> filtered(cacheResize);
+  std::vector<Change> changes;
+  int64_t originalNet = 0;
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  for (auto &resizeOp : filtered) {
+    auto &poolStates = m_poolStates[resizeOp.m_kName];
+    for (auto &poolResize : resizeOp.m_kPoolResizes) {
+      auto it = poolStates.find(poolResize.m_kId);
+      if (it == poolStates.end()) {
+        continue;
+      }
+      auto &state = it->second;
+      int64_t delta = static_cast<int64_t>(poolResize.m_kSize) -
+                      static_cast<int64_t>(state.m_size);
+      originalNet += delta;
+
+      // Keep the current size unless the change passes every filter
+      poolResize.m_kSize = state.m_size;
+
+      if (delta == 0 ||
+          static_cast<uint64_t>(std::abs(delta)) < m_kConfig.m_minDelta ||
+          kNow - state.m_lastResize < m_kConfig.m_cooldown) {
+        continue;
+      }
+
+      // Damp pools whose direction keeps flipping
+      int const kDirection = delta > 0 ? 1 : -1;
+      uint32_t const kFlips =
+          state.m_lastDirection != 0 && kDirection != state.m_lastDirection
+              ? state.m_flips + 1
+              : 0;
+      if (kFlips >= m_kConfig.m_oscillationFlips) {
+        delta = static_cast<int64_t>(
+            delta * std::pow(m_kConfig.m_damping,
+                             kFlips - m_kConfig.m_oscillationFlips + 1));
+      }
+
+      changes.push_back(Change{&poolResize, &state, delta, kFlips});
+    }
+  }
+
+  // Keep only the largest changes
+  if (m_kConfig.m_maxPools > 0 && changes.size() > m_kConfig.m_maxPools) {
+    std::nth_element(changes.begin(),
+                     changes.begin() + m_kConfig.m_maxPools, changes.end(),
+                     [](const Change &a, const Change &b) {
+                       return std::abs(a.m_delta) > std::abs(b.m_delta);
+                     });
+    changes.resize(m_kConfig.m_maxPools);
+  }
+
+  // Never grow by more than what remaining shrinks (and the original
+  // decision) free up
+  double grow = 0.0, shrink = 0.0;
+  for (const auto &change : changes) {
+    (change.m_delta > 0 ? grow : shrink) += std::abs(change.m_delta);
+  }
+  double const kAllowed = shrink + std::max<int64_t>(0, originalNet);
+  double const kScale = grow > kAllowed ? kAllowed / grow : 1.0;
+
+  for (const auto &change : changes) {
+    int64_t const kDelta =
+        change.m_delta > 0 ? static_cast<int64_t>(change.m_delta * kScale)
+                           : change.m_delta;
+    if (kDelta == 0) {
+      continue;
+    }
+    change.m_poolResize->m_kSize = change.m_state->m_size + kDelta;
+    change.m_state->m_size = change.m_poolResize->m_kSize;
+    change.m_state->m_lastResize = kNow;
+    change.m_state->m_lastDirection = kDelta > 0 ? 1 : -1;
+    change.m_state->m_flips = change.m_flips;
+  }
+  lock.unlock();
+
+  m_kProxyManager->resize(filtered);
+}
+
+} // namespace holpaca
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <holpaca/control-plane/ProxyManager.h>
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace holpaca {
+
+/**
+ * @brief ProxyManager decorator that filters out unprofitable resizes.
+ *
+ * Sits between a control algorithm and the ProxyManager that enforces its
+ * decisions. Every resize round goes through:
+ *   - a dead band: the round is dropped when the predicted gain reported by
+ *     the algorithm (PoolResize::m_kGain) is below a minimum, and pool
+ *     changes smaller than a minimum delta are ignored;
+ *   - per-pool cooldowns: a pool that was just resized keeps its size for a
+ *     while;
+ *   - a cap on the number of pools changed per round (largest changes first);
+ *   - an oscillation detector that damps pools whose direction keeps flipping.
+ * Growths are scaled down whenever filtered shrinks would no longer fund
+ * them, so the total memory handed out never exceeds the original decision.
+ *
+ * The status may be requested while a round is filtered (e.g., by a
+ * StatusPrefetcher collecting the next status), so the pool states are
+ * guarded by a mutex.
+ */
+class ResizeStabilizer : public ProxyManager {
+public:
+  /**
+   * @brief Stabilization parameters.
+   */
+  struct Config {
+    /* Minimum predicted gain of a round */
+    double m_minGain{0.0};
+
+    /* Minimum size change of a pool (bytes) */
+    uint64_t m_minDelta{0};
+
+    /* Time a pool keeps its size after being resized */
+    std::chrono::milliseconds m_cooldown{0};
+
+    /* Maximum number of pools changed per round (0 = unlimited) */
+    size_t m_maxPools{0};
+
+    /* Consecutive direction flips after which a pool is oscillating */
+    uint32_t m_oscillationFlips{2};
+
+    /* Factor applied to the change of an oscillating pool, per flip */
+    double m_damping{0.5};
+  };
+
+private:
+  /**
+   * @brief Stabilization state of a single pool.
+   */
+  struct PoolState {
+    /* Size observed in the last status (or last forwarded resize) */
+    uint64_t m_size{0};
+
+    /* Time of the last applied change */
+    std::chrono::steady_clock::time_point m_lastResize{};
+
+    /* Sign of the last applied change */
+    int m_lastDirection{0};
+
+    /* Consecutive direction flips */
+    uint32_t m_flips{0};
+  };
+
+  /* ProxyManager that enforces the filtered decisions */
+  ProxyManager *const m_kProxyManager;
+
+  /* Stabilization parameters */
+  Config const m_kConfig;
+
+  /* State of each pool, per cache */
+  std::unordered_map<std::string, std::unordered_map<PoolId, PoolState>>
+      m_poolStates;
+
+  /* Protects the pool states */
+  std::mutex m_mutex;
+
+public:
+  /**
+   * @brief Constructs a stabilizer in front of the given ProxyManager.
+   *
+   * @param kProxyManager ProxyManager that enforces the filtered decisions
+   * @param kConfig Stabilization parameters
+   */
+  ResizeStabilizer(ProxyManager *const kProxyManager, Config const &kConfig);
+
+  /**
+   * @brief Forwards the status request, recording current pool sizes.
+   * @return Map of cache names to their status
+   */
+  std::unordered_map<std::string, CacheStatus> getStatus() override final;
+
+  /**
+   * @brief Filters the resize instructions and forwards the remainder.
+   * @param cacheResize Vector of resize instructions
+   */
+  void resize(const std::vector<CacheResize> &cacheResize) override final;
+};
+
+} // namespace holpaca
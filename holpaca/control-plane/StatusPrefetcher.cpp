@@ -0,0 +1,168 @@
+#include <holpaca/control-plane/StatusPrefetcher.h>
+
+#include <iostream>
+
+namespace holpaca {
+
+/**
+ * @brief Adds the latency histograms and allocation failures of a discarded
+ * status to those of a newer one, as collecting the newer one drained them.
+ *
+ * Pools that are gone from the newer status are ignored.
+ *
+ * @param kDiscarded Status discarded
+ * @param cacheStatus Status served instead
+ */
+static void carryOver(
+    std::unordered_map<std::string, ProxyManager::CacheStatus> const
+        &kDiscarded,
+    std::unordered_map<std::string, ProxyManager::CacheStatus> &cacheStatus) {
+  for (const auto &[cacheId, discarded] : kDiscarded) {
+    auto const kCache = cacheStatus.find(cacheId);
+    if (kCache == cacheStatus.end()) {
+      continue;
+    }
+    for (const auto &[poolId, pool] : discarded.m_pools) {
+      auto const kPool = kCache->second.m_pools.find(poolId);
+      if (kPool == kCache->second.m_pools.end()) {
+        continue;
+      }
+      for (const auto &[bound, count] : pool.m_hitLatency) {
+        kPool->second.m_hitLatency[bound] += count;
+      }
+      for (const auto &[bound, count] : pool.m_missLatency) {
+        kPool->second.m_missLatency[bound] += count;
+      }
+      kPool->second.m_allocFailures += pool.m_allocFailures;
+    }
+  }
+}
+
+/**
+ * @brief Constructs the decorator and starts its collector thread.
+ */
+StatusPrefetcher::StatusPrefetcher(
+    ProxyManager *const kProxyManager,
+    std::function<std::chrono::milliseconds()> const &kPeriod,
+    std::chrono::milliseconds const kStaleness)
+    : m_kProxyManager(kProxyManager), m_kPeriod(kPeriod),
+      m_kStaleness(kStaleness) {
+  m_collector = std::thread([this] { prefetch(); });
+}
+
+/**
+ * @brief Stops and joins the collector thread, waiting for a collection in
+ * flight.
+ */
+StatusPrefetcher::~StatusPrefetcher() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_changed.notify_all();
+  m_collector.join();
+}
+
+/**
+ * @brief Collects the status, timing the collection.
+ *
+ * @return Map of cache names (address) to their CacheStatus
+ */
+std::unordered_map<std::string, ProxyManager::CacheStatus>
+StatusPrefetcher::collect() {
+  auto const kStart = std::chrono::steady_clock::now();
+  auto cacheStatus = m_kProxyManager->getStatus();
+  std::chrono::duration<double, std::milli> const kElapsed =
+      std::chrono::steady_clock::now() - kStart;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_collectTime = m_collectTime.count() == 0.0
+                      ? kElapsed
+                      : 0.8 * m_collectTime + 0.2 * kElapsed;
+  return cacheStatus;
+}
+
+/**
+ * @brief Loop of the collector thread.
+ *
+ * Waits for the next collection to be due, one collection time before the
+ * algorithm's next loop, and collects it without holding the lock.
+ */
+void StatusPrefetcher::prefetch() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (!m_stop) {
+    if (!m_due) {
+      m_changed.wait(lock);
+      continue;
+    }
+    auto const kStart =
+        *m_due - std::chrono::duration_cast<std::chrono::milliseconds>(
+                     m_collectTime);
+    if (kStart > std::chrono::steady_clock::now()) {
+      m_changed.wait_until(lock, kStart);
+      continue;
+    }
+
+    m_due.reset();
+    m_collecting = true;
+    lock.unlock();
+    auto cacheStatus = collect();
+    lock.lock();
+    m_prefetched = std::move(cacheStatus);
+    m_collectedAt = std::chrono::steady_clock::now();
+    m_collecting = false;
+    m_changed.notify_all();
+  }
+}
+
+/**
+ * @brief Serves the prefetched status if fresh enough, otherwise collects it,
+ * and schedules the collection for the next round.
+ *
+ * A collection in flight is awaited, as it was started for this request. A
+ * stale status is not lost entirely: what collecting drained from the caches
+ * is carried over into the new one. The next collection is due one period
+ * after this request.
+ *
+ * @return Map of cache names (address) to their CacheStatus
+ */
+std::unordered_map<std::string, ProxyManager::CacheStatus>
+StatusPrefetcher::getStatus() {
+  auto const kRequested = std::chrono::steady_clock::now();
+  std::optional<std::unordered_map<std::string, CacheStatus>> cacheStatus;
+  std::optional<std::unordered_map<std::string, CacheStatus>> discarded;
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_due.reset();
+    m_changed.wait(lock, [this] { return !m_collecting; });
+    if (m_prefetched && kRequested - m_collectedAt <= m_kStaleness) {
+      cacheStatus = std::move(m_prefetched);
+      m_hits++;
+    } else {
+      m_misses++;
+      if (m_prefetched) {
+        std::cout << "StatusPrefetcher: prefetched status exceeded the "
+                     "staleness budget ("
+                  << m_misses << " of " << m_hits + m_misses << " requests)"
+                  << std::endl;
+        discarded = std::move(m_prefetched);
+      }
+    }
+    m_prefetched.reset();
+  }
+  if (!cacheStatus) {
+    cacheStatus = collect();
+    if (discarded) {
+      carryOver(*discarded, *cacheStatus);
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_due = kRequested + m_kPeriod();
+  }
+  m_changed.notify_all();
+  return std::move(*cacheStatus);
+}
+
+} // namespace holpaca
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <holpaca/control-plane/ProxyManager.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace holpaca {
+
+/**
+ * @brief ProxyManager decorator that collects the status of the next control
+ * round ahead of time.
+ *
+ * After serving a status, a background thread collects the next one so that
+ * it completes when the algorithm's next loop is due: it starts one period
+ * after the previous request, minus the (smoothed) time a collection takes.
+ * The collection of round N+1 thus leaves the loop and overlaps with the
+ * computation and enforcement of round N whenever these run long, so a loop
+ * only computes and enforces.
+ *
+ * A prefetched status older than the staleness budget when requested is
+ * discarded and collected again synchronously. Collecting drains the latency
+ * histograms and allocation failures of the caches, so those of the
+ * discarded status are carried over into the new one.
+ */
+class StatusPrefetcher : public ProxyManager {
+  /* ProxyManager that collects the status and enforces the decisions */
+  ProxyManager *const m_kProxyManager;
+
+  /* Current period of the algorithm served */
+  std::function<std::chrono::milliseconds()> const m_kPeriod;
+
+  /* Maximum age of a prefetched status */
+  std::chrono::milliseconds const m_kStaleness;
+
+  /* Status collected ahead of the next request, if any */
+  std::optional<std::unordered_map<std::string, CacheStatus>> m_prefetched;
+
+  /* Time the prefetched status was collected */
+  std::chrono::steady_clock::time_point m_collectedAt;
+
+  /* Time the next collection is due (none before the first request) */
+  std::optional<std::chrono::steady_clock::time_point> m_due;
+
+  /* Whether a collection is in flight */
+  bool m_collecting{false};
+
+  /* Smoothed duration of a collection */
+  std::chrono::duration<double, std::milli> m_collectTime{0.0};
+
+  /* Number of requests served by a prefetched status */
+  uint64_t m_hits{0};
+
+  /* Number of requests that had to collect synchronously */
+  uint64_t m_misses{0};
+
+  /* Flag to signal the collector to stop */
+  bool m_stop{false};
+
+  /* Protects the state above */
+  std::mutex m_mutex;
+
+  /* Signaled when a collection is due, completes, or on stop */
+  std::condition_variable m_changed;
+
+  /* Background thread collecting ahead of time */
+  std::thread m_collector;
+
+  /**
+   * @brief Collects the status, timing the collection.
+   */
+  std::unordered_map<std::string, CacheStatus> collect();
+
+  /* Loop of the collector thread */
+  void prefetch();
+
+public:
+  /**
+   * @brief Constructs the decorator in front of the given ProxyManager and
+   * starts its collector thread.
+   *
+   * @param kProxyManager ProxyManager that collects and enforces
+   * @param kPeriod Current period of the algorithm served
+   * @param kStaleness Maximum age of a prefetched status
+   */
+  StatusPrefetcher(ProxyManager *const kProxyManager,
+                   std::function<std::chrono::milliseconds()> const &kPeriod,
+                   std::chrono::milliseconds const kStaleness);
+
+  /**
+   * @brief Stops and joins the collector thread.
+   */
+  ~StatusPrefetcher();
+
+  /**
+   * @brief Serves the prefetched status if fresh enough, otherwise collects
+   * it, and schedules the collection for the next round.
+   * @return Map of cache names to their status
+   */
+  std::unordered_map<std::string, CacheStatus> getStatus() override final;
+
+  /**
+   * @brief Forwards the resize instructions unchanged.
+   * @param cacheResize Vector of resize instructions
+   */
+  void resize(const std::vector<CacheResize> &cacheResize) override final {
+    m_kProxyManager->resize(cacheResize);
+  }
+};
+
+} // namespace holpaca
@@ -0,0 +1,118 @@
+#include <holpaca/control-plane/ThroughputForecaster.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace holpaca {
+
+/**
+ * @brief Constructs a forecaster with the given parameters.
+ *
+ * The ring buffer holds two seasons, enough to initialize the seasonal
+ * components, or a single sample when no season is configured.
+ */
+ThroughputForecaster::ThroughputForecaster(Config const &kConfig)
+    : m_config(kConfig),
+      m_samples(std::max<size_t>(2 * kConfig.m_seasonLength, 1)) {
+  m_config.m_horizon = std::max<size_t>(m_config.m_horizon, 1);
+}
+
+double ThroughputForecaster::sample(size_t const kAge) const {
+  return m_samples[(m_next + m_samples.size() - 1 - kAge) % m_samples.size()];
+}
+
+/**
+ * @brief Initializes the seasonal model from the last two seasons.
+ *
+ * The level is the mean of the most recent season, the trend the per-sample
+ * change between the means of both seasons, and each seasonal component the
+ * average deviation of its position from the mean of its season.
+ */
+void ThroughputForecaster::initializeSeason() {
+  size_t const kLength = m_config.m_seasonLength;
+
+  double firstMean = 0.0, secondMean = 0.0;
+  for (size_t i = 0; i < kLength; i++) {
+    firstMean += sample(2 * kLength - 1 - i);
+    secondMean += sample(kLength - 1 - i);
+  }
+  firstMean /= kLength;
+  secondMean /= kLength;
+
+  m_seasonal.assign(kLength, 0.0);
+  for (size_t i = 0; i < kLength; i++) {
+    m_seasonal[i] = ((sample(2 * kLength - 1 - i) - firstMean) +
+                     (sample(kLength - 1 - i) - secondMean)) /
+                    2;
+  }
+
+  // The level refers to the last sample, halfway through the second season
+  m_trend = (secondMean - firstMean) / kLength;
+  m_level = secondMean + m_trend * (kLength - 1) / 2.0;
+  m_phase = 0;
+}
+
+/**
+ * @brief Feeds the throughput observed in the last period.
+ *
+ * @param kValue Throughput (ops/s)
+ */
+void ThroughputForecaster::record(double const kValue) {
+  m_samples[m_next] = kValue;
+  m_next = (m_next + 1) % m_samples.size();
+  m_count++;
+
+  if (m_count == 1) {
+    m_level = kValue;
+    m_trend = 0.0;
+    return;
+  }
+
+  double const kSeasonal = seasonal() ? m_seasonal[m_phase] : 0.0;
+  double const kPreviousLevel = m_level;
+  m_level = m_config.m_alpha * (kValue - kSeasonal) +
+            (1 - m_config.m_alpha) * (m_level + m_trend);
+  m_trend = m_config.m_beta * (m_level - kPreviousLevel) +
+            (1 - m_config.m_beta) * m_trend;
+
+  if (seasonal()) {
+    m_seasonal[m_phase] = m_config.m_gamma * (kValue - m_level) +
+                          (1 - m_config.m_gamma) * kSeasonal;
+    m_phase = (m_phase + 1) % m_seasonal.size();
+  } else if (m_config.m_seasonLength > 0 &&
+             m_count == 2 * m_config.m_seasonLength) {
+    initializeSeason();
+  }
+}
+
+/**
+ * @brief Predicted throughput kSteps periods ahead.
+ *
+ * @param kSteps Number of periods ahead (1 = next period)
+ * @return Non-negative forecast, NaN when nothing has been recorded
+ */
+double ThroughputForecaster::forecast(size_t const kSteps) const {
+  if (m_count == 0) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+
+  double value = m_level + kSteps * m_trend;
+  if (seasonal()) {
+    value += m_seasonal[(m_phase + kSteps - 1) % m_seasonal.size()];
+  }
+  return std::max(0.0, value);
+}
+
+/**
+ * @brief Largest predicted throughput within the configured horizon.
+ */
+double ThroughputForecaster::peak() const {
+  double value = forecast(1);
+  for (size_t step = 2; step <= m_config.m_horizon; step++) {
+    value = std::max(value, forecast(step));
+  }
+  return value;
+}
+
+} // namespace holpaca
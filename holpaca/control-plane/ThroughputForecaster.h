@@ -0,0 +1,119 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace holpaca {
+
+/**
+ * @brief Additive Holt-Winters forecaster over a pool's throughput series.
+ *
+ * Keeps the most recent samples in a bounded ring buffer and maintains a
+ * level, a trend and one seasonal component per position of the season. The
+ * seasonal components are initialized once two full seasons have been
+ * observed; until then (or when no season is configured) the forecaster
+ * degrades to Holt's linear trend method.
+ *
+ * One sample is recorded per sample period, however often the status is
+ * collected, so the season length is given in sample periods (e.g., 24h /
+ * sample period for diurnal cycles).
+ */
+class ThroughputForecaster {
+public:
+  /**
+   * @brief Forecasting parameters.
+   */
+  struct Config {
+    /* Time between consecutive samples */
+    std::chrono::milliseconds m_samplePeriod{1000};
+
+    /* Number of samples in a season (0 = no seasonality) */
+    size_t m_seasonLength{0};
+
+    /* Number of sample periods ahead the allocation should be prepared for */
+    size_t m_horizon{1};
+
+    /* Smoothing factor of the level */
+    double m_alpha{0.3};
+
+    /* Smoothing factor of the trend */
+    double m_beta{0.05};
+
+    /* Smoothing factor of the seasonal components */
+    double m_gamma{0.1};
+  };
+
+private:
+  /* Forecasting parameters */
+  Config m_config;
+
+  /* Most recent samples, oldest overwritten first */
+  std::vector<double> m_samples;
+
+  /* Position of the next sample within m_samples */
+  size_t m_next{0};
+
+  /* Number of samples recorded so far */
+  uint64_t m_count{0};
+
+  /* Smoothed level */
+  double m_level{0.0};
+
+  /* Smoothed trend (per sample) */
+  double m_trend{0.0};
+
+  /* Seasonal components, empty until initialized */
+  std::vector<double> m_seasonal;
+
+  /* Position of the next sample within the season */
+  size_t m_phase{0};
+
+  /**
+   * @brief Sample recorded kAge samples ago (0 = most recent).
+   */
+  double sample(size_t const kAge) const;
+
+  /**
+   * @brief Initializes level, trend and seasonal components from the two
+   * seasons held by the ring buffer.
+   */
+  void initializeSeason();
+
+public:
+  /**
+   * @brief Constructs a forecaster with the given parameters.
+   * @param kConfig Forecasting parameters
+   */
+  explicit ThroughputForecaster(Config const &kConfig);
+
+  /**
+   * @brief Feeds the throughput observed in the last sample period.
+   * @param kValue Throughput (ops/s)
+   */
+  void record(double const kValue);
+
+  /**
+   * @brief Predicted throughput kSteps sample periods ahead (1 = next one).
+   * @return Non-negative forecast, NaN when nothing has been recorded
+   */
+  double forecast(size_t const kSteps = 1) const;
+
+  /**
+   * @brief Largest predicted throughput within the configured horizon.
+   *
+   * Allocating against the peak of the horizon grows pools ahead of a rise
+   * in demand instead of reacting to it.
+   *
+   * @return Non-negative forecast, NaN when nothing has been recorded
+   */
+  double peak() const;
+
+  /**
+   * @brief Whether the seasonal components have been initialized.
+   */
+  bool seasonal() const { return !m_seasonal.empty(); }
+};
+
+} // namespace holpaca
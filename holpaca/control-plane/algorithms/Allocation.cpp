@@ -0,0 +1,78 @@
+#include <holpaca/control-plane/algorithms/Allocation.h>
+
+#include <algorithm>
+
+namespace holpaca {
+
+/**
+ * @brief Starts from the current size of every pool in the status.
+ */
+Allocation::Allocation(
+    std::unordered_map<std::string, ProxyManager::CacheStatus> const
+        &kAllCacheStatus) {
+  for (const auto &[cacheId, cacheStatus] : kAllCacheStatus) {
+    auto &pools = m_pools[cacheId];
+    for (const auto &[poolId, poolStatus] : cacheStatus.m_pools) {
+      pools[poolId].m_size = poolStatus.m_maxSize;
+    }
+  }
+}
+
+uint64_t Allocation::size(std::string const &kCacheId,
+                          PoolId const kPoolId) const {
+  auto const kCache = m_pools.find(kCacheId);
+  if (kCache == m_pools.end()) {
+    return 0;
+  }
+  auto const kPool = kCache->second.find(kPoolId);
+  return kPool == kCache->second.end() ? 0 : kPool->second.m_size;
+}
+
+uint64_t Allocation::floor(std::string const &kCacheId,
+                           PoolId const kPoolId) const {
+  auto const kCache = m_pools.find(kCacheId);
+  if (kCache == m_pools.end()) {
+    return 0;
+  }
+  auto const kPool = kCache->second.find(kPoolId);
+  return kPool == kCache->second.end() ? 0 : kPool->second.m_floor;
+}
+
+/**
+ * @brief Proposes a new size for a pool, raised to its floor if below.
+ */
+void Allocation::propose(std::string const &kCacheId, PoolId const kPoolId,
+                         uint64_t const kSize, double const kGain) {
+  auto &pool = m_pools[kCacheId][kPoolId];
+  pool.m_size = std::max(kSize, pool.m_floor);
+  pool.m_gain = kGain;
+  m_proposed = true;
+}
+
+/**
+ * @brief Raises the floor of a pool (lower floors are ignored).
+ */
+void Allocation::raiseFloor(std::string const &kCacheId, PoolId const kPoolId,
+                            uint64_t const kFloor) {
+  auto &pool = m_pools[kCacheId][kPoolId];
+  pool.m_floor = std::max(pool.m_floor, kFloor);
+}
+
+/**
+ * @brief Resize instructions enforcing the proposal, one per cache.
+ */
+std::vector<ProxyManager::CacheResize> Allocation::resizes() const {
+  std::vector<ProxyManager::CacheResize> cacheResizes;
+  for (const auto &[cacheId, pools] : m_pools) {
+    std::vector<ProxyManager::PoolResize> poolResizes;
+    for (const auto &[poolId, pool] : pools) {
+      poolResizes.emplace_back(ProxyManager::PoolResize{
+          .m_kId = poolId, .m_kSize = pool.m_size, .m_kGain = pool.m_gain});
+    }
+    cacheResizes.emplace_back(ProxyManager::CacheResize{
+        .m_kName = cacheId, .m_kPoolResizes = poolResizes});
+  }
+  return cacheResizes;
+}
+
+} // namespace holpaca
@@ -0,0 +1,102 @@
+#pragma once
+#include <holpaca/control-plane/ProxyManager.h>
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace holpaca {
+
+/**
+ * @brief Proposed pool sizes shared by the stages of a control round.
+ *
+ * Starts from the current size of every pool. Each stage reads the sizes and
+ * floors proposed so far and overwrites the sizes it decides on. Floors
+ * raised by a stage (e.g., the memory a QoS level requires) bind every later
+ * stage: proposals below a pool's floor are raised to it.
+ */
+class Allocation {
+public:
+  /**
+   * @brief Proposal for a single pool.
+   */
+  struct PoolAllocation {
+    /* Proposed size (bytes) */
+    uint64_t m_size{0};
+
+    /* Size later proposals may not go below (bytes) */
+    uint64_t m_floor{0};
+
+    /* Predicted utility gain of the proposal (NaN if unknown) */
+    double m_gain{std::numeric_limits<double>::quiet_NaN()};
+  };
+
+private:
+  /* Proposal of each pool, per cache */
+  std::unordered_map<std::string, std::unordered_map<PoolId, PoolAllocation>>
+      m_pools;
+
+  /* Whether any stage proposed a size */
+  bool m_proposed{false};
+
+public:
+  /**
+   * @brief Starts from the current size of every pool in the status.
+   *
+   * @param kAllCacheStatus Status of all caches
+   */
+  explicit Allocation(
+      std::unordered_map<std::string, ProxyManager::CacheStatus> const
+          &kAllCacheStatus);
+
+  /**
+   * @brief Proposals of every pool, per cache.
+   */
+  std::unordered_map<std::string,
+                     std::unordered_map<PoolId, PoolAllocation>> const &
+  pools() const {
+    return m_pools;
+  }
+
+  /**
+   * @brief Size proposed so far for a pool (0 if unknown).
+   */
+  uint64_t size(std::string const &kCacheId, PoolId const kPoolId) const;
+
+  /**
+   * @brief Floor of a pool (0 if unknown).
+   */
+  uint64_t floor(std::string const &kCacheId, PoolId const kPoolId) const;
+
+  /**
+   * @brief Proposes a new size for a pool, raised to its floor if below.
+   *
+   * @param kCacheId Cache of the pool
+   * @param kPoolId Pool ID
+   * @param kSize Proposed size (bytes)
+   * @param kGain Predicted utility gain of the proposal (NaN if unknown)
+   */
+  void propose(std::string const &kCacheId, PoolId const kPoolId,
+               uint64_t const kSize,
+               double const kGain = std::numeric_limits<double>::quiet_NaN());
+
+  /**
+   * @brief Raises the floor of a pool (lower floors are ignored).
+   */
+  void raiseFloor(std::string const &kCacheId, PoolId const kPoolId,
+                  uint64_t const kFloor);
+
+  /**
+   * @brief Whether any size was proposed.
+   */
+  bool proposed() const { return m_proposed; }
+
+  /**
+   * @brief Resize instructions enforcing the proposal, one per cache.
+   */
+  std::vector<ProxyManager::CacheResize> resizes() const;
+};
+
+} // namespace holpaca
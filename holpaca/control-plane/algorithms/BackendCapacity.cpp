@@ -0,0 +1,166 @@
+#include <holpaca/control-plane/algorithms/BackendCapacity.h>
+#include <holpaca/control-plane/algorithms/GreedyAllocation.h>
+#include <holpaca/control-plane/algorithms/MissRatioCurve.h>
+#include <holpaca/control-plane/algorithms/UtilityTable.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace holpaca {
+
+/**
+ * @brief Constructs the BackendCapacity algorithm instance.
+ */
+BackendCapacity::BackendCapacity(ProxyManager *const kProxyManager,
+                                 std::chrono::milliseconds const kPeriodicity,
+                                 double const kCapacity)
+    : StagedAlgorithm(kProxyManager, kPeriodicity), m_kCapacity(kCapacity) {}
+
+/**
+ * @brief Proposes the allocation keeping the backend below its capacity.
+ *
+ * Backend operations are priced with a multiplier lambda: every pool's
+ * utility is its hit throughput minus lambda times its predicted backend
+ * load. With lambda = 0 the allocation maximizes hit throughput; larger
+ * multipliers trade hits for backend load. The smallest multiplier whose
+ * allocation fits the capacity is found by bisection. Floors raised by
+ * earlier stages are kept.
+ *
+ * @param kAllCacheStatus Status of all caches, collected for the round
+ * @param allocation Sizes and floors proposed by the previous stages
+ */
+void BackendCapacity::apply(
+    std::unordered_map<std::string, ProxyManager::CacheStatus> const
+        &kAllCacheStatus,
+    Allocation &allocation) {
+  uint64_t totalSize = 0;
+  int pools = 0;
+  int newPools = 0;
+  double unmodeledLoad = 0.0;
+  for (const auto &[cacheId, cacheStatus] : kAllCacheStatus) {
+    totalSize += cacheStatus.m_maxSize;
+    for (const auto &[poolId, poolStatus] : cacheStatus.m_pools) {
+      if (poolStatus.m_MRC.size() < m_kMRCMinLength) {
+        newPools++;
+        unmodeledLoad += poolStatus.m_diskIOPS;
+      }
+      pools++;
+    }
+  }
+  if (pools == 0) {
+    return;
+  }
+
+  // Pools without a meaningful MRC yet get an even share of the memory
+  uint64_t const kNewPoolSize = totalSize / pools;
+  uint64_t const kBudget = totalSize - newPools * kNewPoolSize;
+
+  // Per-pool request rate, backend cost per miss, and sampled miss ratio
+  std::vector<std::pair<std::string, PoolId>> ids;
+  std::vector<double> throughputs, missCosts;
+  std::vector<uint64_t> floors, ceilings;
+  UtilityTable missRatios;
+
+  for (const auto &[cacheId, cacheStatus] : kAllCacheStatus) {
+    for (const auto &[poolId, poolStatus] : cacheStatus.m_pools) {
+      if (poolStatus.m_MRC.size() < m_kMRCMinLength) {
+        continue;
+      }
+
+      // Moving average of the backend operations issued per miss
+      double const kMisses = poolStatus.m_throughput * poolStatus.m_missRatio;
+      auto &history = m_missCostHistory[cacheId];
+      auto [it, inserted] = history.try_emplace(poolId, 1.0);
+      if (kMisses > 0) {
+        double const kCost = poolStatus.m_diskIOPS / kMisses;
+        it->second = inserted ? kCost
+                              : it->second * m_kMovingAverageParam +
+                                    kCost * (1 - m_kMovingAverageParam);
+      }
+
+      ids.emplace_back(cacheId, poolId);
+      throughputs.push_back(poolStatus.plannedThroughput());
+      missCosts.push_back(it->second);
+      ceilings.push_back(std::min(cacheStatus.m_maxSize, kBudget));
+      floors.push_back(
+          std::min(allocation.floor(cacheId, poolId), ceilings.back()));
+      missRatios.add(MissRatioCurve(poolStatus.m_MRC), 0, ceilings.back());
+    }
+  }
+
+  // Allocation maximizing hits minus lambda times the backend load
+  auto allocate = [&](double const kLambda) {
+    UtilityTable utilityTable;
+    for (size_t i = 0; i < ids.size(); i++) {
+      utilityTable.add(
+          [&](double size) {
+            double const kMissRatio = missRatios(i, size);
+            return throughputs[i] * ((1.0 - kMissRatio) -
+                                     kLambda * missCosts[i] * kMissRatio);
+          },
+          floors[i], ceilings[i]);
+    }
+    return greedyAllocation(utilityTable, floors, ceilings, kBudget,
+                            UtilityTable::kStep);
+  };
+
+  // Predicted backend load of an allocation
+  auto load = [&](std::vector<uint64_t> const &kSizes) {
+    double total = unmodeledLoad;
+    for (size_t i = 0; i < ids.size(); i++) {
+      total += throughputs[i] * missCosts[i] * missRatios(i, kSizes[i]);
+    }
+    return total;
+  };
+
+  // Bisect (in log space) for the cheapest multiplier that fits the capacity
+  double lo = 1e-3, hi = 1e6;
+  auto sizes = allocate(0.0);
+  if (load(sizes) > m_kCapacity) {
+    auto best = allocate(hi);
+    double const kMinLoad = load(best);
+    m_saturated = kMinLoad > m_kCapacity;
+
+    if (m_saturated) {
+      std::cerr << "BackendCapacity: backend saturated, predicted load "
+                << kMinLoad << " IOPS exceeds capacity " << m_kCapacity
+                << " IOPS" << std::endl;
+    } else {
+      for (uint32_t step = 0; step < m_kBisectionSteps; step++) {
+        double const kMid = std::sqrt(lo * hi);
+        auto candidate = allocate(kMid);
+        if (load(candidate) <= m_kCapacity) {
+          hi = kMid;
+          best = std::move(candidate);
+        } else {
+          lo = kMid;
+        }
+      }
+    }
+    sizes = std::move(best);
+  } else {
+    m_saturated = false;
+  }
+
+  // Propose the sizes and their predicted gains
+  for (const auto &[cacheId, cacheStatus] : kAllCacheStatus) {
+    for (const auto &[poolId, poolStatus] : cacheStatus.m_pools) {
+      if (poolStatus.m_MRC.size() < m_kMRCMinLength) {
+        allocation.propose(cacheId, poolId, kNewPoolSize);
+      }
+    }
+  }
+  for (size_t i = 0; i < ids.size(); i++) {
+    auto const &[cacheId, poolId] = ids[i];
+    uint64_t const kCurrentSize =
+        kAllCacheStatus.at(cacheId).m_pools.at(poolId).m_maxSize;
+    allocation.propose(
+        cacheId, poolId, sizes[i],
+        throughputs[i] *
+            (missRatios(i, kCurrentSize) - missRatios(i, sizes[i])));
+  }
+}
+
+} // namespace holpaca
@@ -0,0 +1,81 @@
+#pragma once
+#include <holpaca/control-plane/ProxyManager.h>
+#include <holpaca/control-plane/algorithms/PipelineStage.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace holpaca {
+
+/**
+ * @brief Control algorithm that keeps a shared storage backend below its
+ * IOPS capacity.
+ *
+ * All pools are assumed to miss into the same backend. Each pool's predicted
+ * backend load is its request rate times the miss ratio predicted by its MRC,
+ * weighted by the backend operations it has been observed to issue per miss.
+ * The algorithm maximizes the aggregated hit throughput subject to the total
+ * predicted backend load staying under the configured capacity, and flags
+ * the backend as saturated when no allocation can achieve that.
+ */
+class BackendCapacity : public StagedAlgorithm {
+
+  /* Minimum MRC length to consider a pool for optimization */
+  const uint32_t m_kMRCMinLength{3};
+
+  /* Backend capacity (operations per second) */
+  double const m_kCapacity;
+
+  /* Number of bisection steps used to price backend operations */
+  const uint32_t m_kBisectionSteps{20};
+
+  /* Parameter for moving average of the per-miss backend cost */
+  const double m_kMovingAverageParam{0.3};
+
+  /* Average backend operations issued per miss, for each cache and pool */
+  std::unordered_map<std::string, std::unordered_map<PoolId, double>>
+      m_missCostHistory;
+
+  /* Whether the last loop found no allocation below the capacity */
+  std::atomic_bool m_saturated{false};
+
+public:
+  /**
+   * @brief Constructs a BackendCapacity algorithm instance.
+   *
+   * @param kProxyManager Pointer to ProxyManager for resizing pools
+   * @param kPeriodicity Time between optimization iterations
+   * @param kCapacity Backend capacity in operations per second
+   */
+  BackendCapacity(ProxyManager *const kProxyManager,
+                  std::chrono::milliseconds const kPeriodicity,
+                  double const kCapacity);
+
+  /**
+   * @brief Whether the backend is predicted to be saturated.
+   *
+   * @return True if the last loop found no allocation keeping the predicted
+   *    backend load below the capacity
+   */
+  bool saturated() const { return m_saturated; }
+
+  /**
+   * @brief Name of the stage, used when reporting.
+   */
+  std::string name() const override final { return "BackendCapacity"; }
+
+  /**
+   * @brief Proposes the allocation keeping the backend below its capacity.
+   *
+   * @param kAllCacheStatus Status of all caches, collected for the round
+   * @param allocation Sizes and floors proposed by the previous stages
+   */
+  void apply(std::unordered_map<std::string, ProxyManager::CacheStatus> const
+                 &kAllCacheStatus,
+             Allocation &allocation) override final;
+};
+
+} // namespace holpaca
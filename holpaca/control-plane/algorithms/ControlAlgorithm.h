@@ -1,9 +1,14 @@
 #pragma once
 
+#include <holpaca/control-plane/AdaptivePeriod.h>
 #include <holpaca/control-plane/ProxyManager.h>
+#include <holpaca/control-plane/StatusPrefetcher.h>
 
 #include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
 #include <thread>
 #include <unordered_map>
 
@@ -15,6 +20,19 @@ namespace holpaca {
  * This class handles periodic execution of the algorithm's main loop
  * in a separate thread and provides access to the ProxyManager for
  * interacting with caches.
+ *
+ * The thread is only started by start(), once the derived algorithm is fully
+ * constructed, and must be stopped with stop() before the derived algorithm
+ * is destroyed. An algorithm that is never started (e.g., a pipeline stage,
+ * or one run by a ControlScheduler through iterate()) has no thread at all.
+ *
+ * Loops run at a fixed rate: each one is due one period after the deadline
+ * of the previous one, regardless of how long the loop took. A loop that
+ * ends past the next deadline is an overrun; the missed periods are skipped
+ * rather than run back to back. With an AdaptivePeriod, the period follows
+ * how fast the workloads change. With a StatusPrefetcher, the status of a
+ * loop is collected ahead of its deadline, so the loop only computes and
+ * enforces.
  */
 class ControlAlgorithm {
   /* Period between consecutive loop executions */
@@ -29,6 +47,18 @@ class ControlAlgorithm {
   /* Pointer to the ProxyManager used to query and resize caches */
   ProxyManager *const m_kProxyManager;
 
+  /* Collects the status ahead of each loop (collected in it if null) */
+  std::unique_ptr<StatusPrefetcher> m_statusPrefetcher;
+
+  /* Adapts the period to the workloads (fixed period if null) */
+  std::unique_ptr<AdaptivePeriod> m_adaptivePeriod;
+
+  /* Number of loops executed */
+  std::atomic<uint64_t> m_loops{0};
+
+  /* Number of loops that ended past the deadline of the next one */
+  std::atomic<uint64_t> m_overruns{0};
+
 protected:
   /**
    * @brief Main loop of the algorithm, executed periodically.
@@ -42,29 +72,127 @@ protected:
 
 public:
   /**
-   * @brief Constructs a ControlAlgorithm instance and starts its background
-   * thread.
+   * @brief Constructs a ControlAlgorithm instance (without starting it).
    *
    * @param kProxyManager Pointer to the ProxyManager managing caches
    * @param kPeriodicity Time interval between consecutive loop executions
    */
   ControlAlgorithm(ProxyManager *const kProxyManager,
                    std::chrono::milliseconds const kPeriodicity)
-      : m_kProxyManager(kProxyManager), m_kPeriodicity(kPeriodicity) {
+      : m_kPeriodicity(kPeriodicity), m_kProxyManager(kProxyManager) {}
+
+  /**
+   * @brief Stops the background thread and cleans up resources.
+   */
+  virtual ~ControlAlgorithm() { stop(); }
+
+  /**
+   * @brief Time between consecutive loop executions (current one, if
+   * adaptive).
+   */
+  std::chrono::milliseconds periodicity() const {
+    return m_adaptivePeriod ? m_adaptivePeriod->period() : m_kPeriodicity;
+  }
+
+  /**
+   * @brief Adapts the period to how fast the workloads change, starting from
+   * the configured one.
+   *
+   * Must be called before the algorithm is started or scheduled, and after
+   * setStatusPrefetch.
+   *
+   * @param kConfig Adaptation parameters
+   */
+  void setAdaptivePeriod(AdaptivePeriod::Config const &kConfig) {
+    m_adaptivePeriod = std::make_unique<AdaptivePeriod>(
+        m_statusPrefetcher ? m_statusPrefetcher.get() : m_kProxyManager,
+        m_kPeriodicity, kConfig);
+  }
+
+  /**
+   * @brief Collects the status of each loop ahead of its deadline, in the
+   * background, overlapping with the previous loop.
+   *
+   * Must be called before the algorithm is started or scheduled.
+   *
+   * @param kStaleness Maximum age of a status collected ahead of time
+   */
+  void setStatusPrefetch(std::chrono::milliseconds const kStaleness) {
+    m_statusPrefetcher = std::make_unique<StatusPrefetcher>(
+        m_kProxyManager, [this] { return periodicity(); }, kStaleness);
+  }
+
+  /**
+   * @brief Number of loops executed.
+   */
+  uint64_t loops() const { return m_loops; }
+
+  /**
+   * @brief Number of loops that overran their period.
+   */
+  uint64_t overruns() const { return m_overruns; }
+
+  /**
+   * @brief Runs a single execution of the loop in the calling thread.
+   */
+  void iterate() {
+    if (m_adaptivePeriod) {
+      loop(m_adaptivePeriod.get());
+    } else if (m_statusPrefetcher) {
+      loop(m_statusPrefetcher.get());
+    } else {
+      loop(m_kProxyManager);
+    }
+  }
+
+  /**
+   * @brief Accounts for a finished loop and computes when the next is due.
+   *
+   * @param kDeadline Time the finished loop was due
+   * @return Deadline of the next loop, one period after kDeadline, or now if
+   * that is already past (an overrun)
+   */
+  std::chrono::steady_clock::time_point
+  advance(std::chrono::steady_clock::time_point const kDeadline) {
+    m_loops++;
+    auto const kNow = std::chrono::steady_clock::now();
+    auto const kNext = kDeadline + periodicity();
+    if (kNext >= kNow) {
+      return kNext;
+    }
+    m_overruns++;
+    std::chrono::duration<double, std::milli> const kLate = kNow - kNext;
+    std::cout << "ControlAlgorithm: loop overran its period by "
+              << kLate.count() << " ms (" << m_overruns << " of " << m_loops
+              << " loops)" << std::endl;
+    return kNow;
+  }
+
+  /**
+   * @brief Starts running the loop periodically in a background thread.
+   *
+   * Does nothing if the thread is already running.
+   */
+  void start() {
+    if (m_thread.joinable()) {
+      return;
+    }
+    m_stop = false;
     m_thread = std::thread([this]() {
+      auto deadline = std::chrono::steady_clock::now();
       while (!m_stop) {
-        loop(m_kProxyManager);
-        std::this_thread::sleep_for(m_kPeriodicity);
+        iterate();
+        deadline = advance(deadline);
+        std::this_thread::sleep_until(deadline);
       }
     });
   }
 
   /**
-   * @brief Stops the background thread and cleans up resources.
-   *
-   * Signals the thread to stop and joins it if still running.
+   * @brief Signals the background thread to stop and joins it if still
+   * running.
    */
-  ~ControlAlgorithm() {
+  void stop() {
     m_stop = true;
     if (m_thread.joinable()) {
       m_thread.join();
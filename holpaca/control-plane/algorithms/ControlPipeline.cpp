@@ -0,0 +1,79 @@
+#include <holpaca/control-plane/algorithms/ControlPipeline.h>
+
+#include <iostream>
+#include <sstream>
+
+namespace holpaca {
+
+/**
+ * @brief Constructs an empty pipeline.
+ */
+ControlPipeline::ControlPipeline(ProxyManager *const kProxyManager,
+                                 std::chrono::milliseconds const kPeriodicity)
+    : ControlAlgorithm(kProxyManager, kPeriodicity) {}
+
+/**
+ * @brief Appends a stage, run after every stage added before it, unless both
+ * it and an earlier stage run a QoS controller.
+ */
+bool ControlPipeline::addStage(std::unique_ptr<PipelineStage> stage) {
+  std::lock_guard<std::mutex> lock(m_stagesMutex);
+  if (stage->controlsQoS()) {
+    for (auto const &kStage : m_stages) {
+      if (kStage->controlsQoS()) {
+        std::cerr << "ControlPipeline: " << stage->name()
+                  << " rejected, its QoS controller would fight the one of "
+                  << kStage->name() << std::endl;
+        return false;
+      }
+    }
+  }
+  m_stages.push_back(std::move(stage));
+  return true;
+}
+
+/**
+ * @brief Main loop of the pipeline executed periodically.
+ *
+ * Collects cache status, runs every stage over a shared allocation, and
+ * enforces it if any stage proposed a size.
+ *
+ * @param kProxyManager ProxyManager instance used to query and resize caches
+ */
+void ControlPipeline::loop(ProxyManager *const kProxyManager) {
+  std::lock_guard<std::mutex> lock(m_stagesMutex);
+  if (m_stages.empty()) {
+    return;
+  }
+
+  std::ostringstream report;
+  report << "ControlPipeline:";
+
+  // Collect status from all caches
+  auto start = std::chrono::high_resolution_clock::now();
+  auto const kAllCacheStatus = kProxyManager->getStatus();
+  std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::high_resolution_clock::now() - start;
+  report << " collect " << elapsed.count() << " ms";
+
+  // Run the stages over the shared allocation
+  Allocation allocation(kAllCacheStatus);
+  for (auto const &stage : m_stages) {
+    start = std::chrono::high_resolution_clock::now();
+    stage->apply(kAllCacheStatus, allocation);
+    elapsed = std::chrono::high_resolution_clock::now() - start;
+    report << ", " << stage->name() << " " << elapsed.count() << " ms";
+  }
+
+  // Apply new sizes to ProxyManager
+  if (allocation.proposed()) {
+    start = std::chrono::high_resolution_clock::now();
+    kProxyManager->resize(allocation.resizes());
+    elapsed = std::chrono::high_resolution_clock::now() - start;
+    report << ", enforce " << elapsed.count() << " ms";
+  }
+
+  std::cout << report.str() << std::endl;
+}
+
+} // namespace holpaca
@@ -0,0 +1,58 @@
+#pragma once
+#include <holpaca/control-plane/ProxyManager.h>
+#include <holpaca/control-plane/algorithms/ControlAlgorithm.h>
+#include <holpaca/control-plane/algorithms/PipelineStage.h>
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace holpaca {
+
+/**
+ * @brief Control algorithm running several stages in one control round.
+ *
+ * Every round collects the status once, runs the stages in the order they
+ * were added over a shared Allocation (e.g., QoS floors, then fairness, then
+ * throughput optimization), and enforces the result once. Hysteresis is
+ * applied at enforcement, by placing a ResizeStabilizer in front of the
+ * pipeline's ProxyManager.
+ *
+ * Every round reports the time spent collecting, in each stage, and
+ * enforcing.
+ */
+class ControlPipeline : public ControlAlgorithm {
+
+  /* Stages, in execution order */
+  std::vector<std::unique_ptr<PipelineStage>> m_stages;
+
+  /* Protects the stages, which may be added while the pipeline runs */
+  std::mutex m_stagesMutex;
+
+  /* Main algorithm loop executed periodically */
+  void loop(ProxyManager *const kProxyManager) override final;
+
+public:
+  /**
+   * @brief Constructs an empty pipeline.
+   *
+   * @param kProxyManager Pointer to ProxyManager for resizing pools
+   * @param kPeriodicity Time between control rounds
+   */
+  ControlPipeline(ProxyManager *const kProxyManager,
+                  std::chrono::milliseconds const kPeriodicity);
+
+  /**
+   * @brief Appends a stage, run after every stage added before it.
+   *
+   * A stage running its own QoS controller is rejected if an earlier stage
+   * already does, since both would size the same pools.
+   *
+   * @param stage Stage to append
+   * @return False if the stage was rejected
+   */
+  bool addStage(std::unique_ptr<PipelineStage> stage);
+};
+
+} // namespace holpaca
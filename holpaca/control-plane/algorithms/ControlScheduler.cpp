@@ -0,0 +1,131 @@
+#include <holpaca/control-plane/algorithms/ControlScheduler.h>
+
+#include <algorithm>
+
+namespace holpaca {
+
+/**
+ * @brief Constructs a scheduler without any algorithm.
+ */
+ControlScheduler::ControlScheduler(size_t const kMaxWorkers)
+    : m_kMaxWorkers(std::max<size_t>(kMaxWorkers, 1)) {}
+
+/**
+ * @brief Stops and joins the workers, waiting for the running loops.
+ */
+ControlScheduler::~ControlScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_changed.notify_all();
+  for (auto &worker : m_workers) {
+    worker.join();
+  }
+}
+
+/**
+ * @brief Schedules an algorithm, due immediately.
+ */
+void ControlScheduler::add(ControlAlgorithm *const kAlgorithm) {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.push_back(Entry{.m_algorithm = kAlgorithm,
+                              .m_due = std::chrono::steady_clock::now()});
+    if (m_workers.size() < std::min(m_entries.size(), m_kMaxWorkers)) {
+      m_workers.emplace_back([this] { work(); });
+    }
+  }
+  m_changed.notify_one();
+}
+
+/**
+ * @brief Unschedules an algorithm, waiting for its running loop if any.
+ */
+void ControlScheduler::remove(ControlAlgorithm *const kAlgorithm) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  auto const kFind = [&] {
+    return std::find_if(m_entries.begin(), m_entries.end(),
+                        [&](Entry const &kEntry) {
+                          return kEntry.m_algorithm == kAlgorithm;
+                        });
+  };
+  m_changed.wait(lock, [&] {
+    auto const kEntry = kFind();
+    return kEntry == m_entries.end() || !kEntry->m_running;
+  });
+  auto const kEntry = kFind();
+  if (kEntry != m_entries.end()) {
+    m_entries.erase(kEntry);
+  }
+}
+
+/**
+ * @brief Makes an algorithm due immediately, out of its period.
+ */
+void ControlScheduler::trigger(ControlAlgorithm *const kAlgorithm) {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto &entry : m_entries) {
+      if (entry.m_algorithm != kAlgorithm) {
+        continue;
+      }
+      if (entry.m_running) {
+        entry.m_triggered = true;
+      } else {
+        entry.m_due = std::chrono::steady_clock::now();
+      }
+    }
+  }
+  m_changed.notify_all();
+}
+
+/**
+ * @brief Loop of a worker thread.
+ *
+ * Waits for the idle algorithm due the earliest, runs one loop of it without
+ * holding the lock, and makes it due again one period after its deadline
+ * (see ControlAlgorithm::advance).
+ */
+void ControlScheduler::work() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (!m_stop) {
+    auto next = m_entries.end();
+    for (auto it = m_entries.begin(); it != m_entries.end(); it++) {
+      if (!it->m_running &&
+          (next == m_entries.end() || it->m_due < next->m_due)) {
+        next = it;
+      }
+    }
+
+    if (next == m_entries.end()) {
+      m_changed.wait(lock);
+      continue;
+    }
+    if (next->m_due > std::chrono::steady_clock::now()) {
+      m_changed.wait_until(lock, next->m_due);
+      continue;
+    }
+
+    ControlAlgorithm *const kAlgorithm = next->m_algorithm;
+    auto const kDeadline = next->m_due;
+    next->m_running = true;
+    lock.unlock();
+    kAlgorithm->iterate();
+    auto const kNext = kAlgorithm->advance(kDeadline);
+    lock.lock();
+
+    // Entries may have moved while unlocked, but this one was not removed
+    for (auto &entry : m_entries) {
+      if (entry.m_algorithm == kAlgorithm) {
+        entry.m_running = false;
+        entry.m_due =
+            entry.m_triggered ? std::chrono::steady_clock::now() : kNext;
+        entry.m_triggered = false;
+      }
+    }
+    m_changed.notify_all();
+  }
+}
+
+} // namespace holpaca
@@ -0,0 +1,95 @@
+#pragma once
+#include <holpaca/control-plane/algorithms/ControlAlgorithm.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace holpaca {
+
+/**
+ * @brief Runs the loops of many control algorithms on a shared thread pool.
+ *
+ * Each algorithm is due one period after the deadline of its previous loop,
+ * as if it ran on a thread of its own. Idle workers take the algorithm that has
+ * been due the longest, so a slow algorithm only occupies the worker running
+ * it and never delays the others while some worker is free. A single loop of
+ * an algorithm runs at a time.
+ *
+ * Workers are spawned on demand, up to one per algorithm and at most the
+ * configured maximum.
+ */
+class ControlScheduler {
+  /**
+   * @brief Scheduling state of an algorithm.
+   */
+  struct Entry {
+    ControlAlgorithm *m_algorithm;               /* Scheduled algorithm */
+    std::chrono::steady_clock::time_point m_due; /* Start of its next loop */
+    bool m_running{false};                       /* Whether a loop runs */
+    bool m_triggered{false}; /* Whether due again as soon as the loop ends */
+  };
+
+  /* Maximum number of workers */
+  size_t const m_kMaxWorkers;
+
+  /* Scheduled algorithms */
+  std::vector<Entry> m_entries;
+
+  /* Worker threads */
+  std::vector<std::thread> m_workers;
+
+  /* Flag to signal the workers to stop */
+  bool m_stop{false};
+
+  /* Protects the entries and the stop flag */
+  std::mutex m_mutex;
+
+  /* Signaled when an algorithm is added, becomes idle, or on stop */
+  std::condition_variable m_changed;
+
+  /* Loop of a worker thread */
+  void work();
+
+public:
+  /**
+   * @brief Constructs a scheduler without any algorithm.
+   *
+   * @param kMaxWorkers Maximum number of worker threads (at least 1)
+   */
+  explicit ControlScheduler(size_t const kMaxWorkers);
+
+  /**
+   * @brief Stops and joins the workers, waiting for the running loops.
+   */
+  ~ControlScheduler();
+
+  /**
+   * @brief Schedules an algorithm, due immediately.
+   *
+   * The algorithm must not be started on its own thread.
+   *
+   * @param kAlgorithm Algorithm to schedule (not owned)
+   */
+  void add(ControlAlgorithm *const kAlgorithm);
+
+  /**
+   * @brief Unschedules an algorithm, waiting for its running loop if any.
+   *
+   * @param kAlgorithm Algorithm to unschedule
+   */
+  void remove(ControlAlgorithm *const kAlgorithm);
+
+  /**
+   * @brief Makes an algorithm due immediately, out of its period (or as soon
+   * as its running loop ends). Its next periodic loop is one period later.
+   *
+   * @param kAlgorithm Algorithm to run (ignored if not scheduled)
+   */
+  void trigger(ControlAlgorithm *const kAlgorithm);
+};
+
+} // namespace holpaca
@@ -0,0 +1,408 @@
+#include <holpaca/control-plane/algorithms/FairAllocation.h>
+
+#include <cachelib/allocator/memory/Slab.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace holpaca {
+
+/* Memory the max-min allocation may leave unassigned (one slab) */
+static constexpr double kTolerance = ::facebook::cachelib::Slab::kSize;
+
+/* Maximum evaluations, and smallest bracket, of the max-min level search */
+static constexpr int kMaxSteps = 64;
+static constexpr double kMinBracket = 1e-9;
+
+/* Slope buckets: exponent and leading 3 mantissa bits of a positive double */
+static constexpr unsigned kBucketShift = 49;
+
+/**
+ * @brief Bucket of a positive slope; larger slopes get larger buckets.
+ */
+static uint32_t bucket(double const kSlope) {
+  uint64_t bits;
+  std::memcpy(&bits, &kSlope, sizeof(bits));
+  return static_cast<uint32_t>(bits >> kBucketShift);
+}
+
+void FairAllocation::clear() {
+  m_sizes.clear();
+  m_hitRatios.clear();
+  m_offsets.assign(1, 0);
+  m_throughputs.clear();
+  m_ceilings.clear();
+  m_segments.clear();
+  m_lowestBucket = UINT32_MAX;
+  m_highestBucket = 0;
+}
+
+/**
+ * @brief Adds the hit ratio curve of a pool.
+ *
+ * Sizes below the first MRC point are interpolated from a zero hit ratio at
+ * size zero, and the curve is cut (and interpolated) at the ceiling. Drops
+ * in the hit ratio, which an LRU cache cannot exhibit, are flattened.
+ */
+size_t FairAllocation::add(std::map<uint64_t, float> const &kMRC,
+                           double const kThroughput, uint64_t const kCeiling) {
+  double const kLimit = kCeiling;
+  double previousSize = 0.0, previousHitRatio = 0.0;
+  m_sizes.push_back(0.0);
+  m_hitRatios.push_back(0.0);
+
+  for (const auto &[size, missRatio] : kMRC) {
+    double const kHitRatio = std::max(previousHitRatio, 1.0 - missRatio);
+    if (size >= kLimit) {
+      if (kLimit > previousSize) {
+        m_sizes.push_back(kLimit);
+        m_hitRatios.push_back(previousHitRatio +
+                              (kHitRatio - previousHitRatio) *
+                                  (kLimit - previousSize) /
+                                  (size - previousSize));
+        previousSize = kLimit;
+      }
+      break;
+    }
+    if (size > previousSize) {
+      m_sizes.push_back(size);
+      m_hitRatios.push_back(kHitRatio);
+    } else {
+      m_hitRatios.back() = kHitRatio;
+    }
+    previousSize = size;
+    previousHitRatio = kHitRatio;
+  }
+  if (previousSize < kLimit) {
+    m_sizes.push_back(kLimit);
+    m_hitRatios.push_back(previousHitRatio);
+  }
+
+  m_offsets.push_back(m_sizes.size());
+  m_throughputs.push_back(kThroughput);
+  m_ceilings.push_back(kCeiling);
+  addSegments();
+  return m_throughputs.size() - 1;
+}
+
+double FairAllocation::hitRatio(size_t const kCurve,
+                                double const kSize) const {
+  auto const kBegin = m_sizes.begin() + m_offsets[kCurve];
+  auto const kEnd = m_sizes.begin() + m_offsets[kCurve + 1];
+  auto const kNext = std::upper_bound(kBegin, kEnd, kSize);
+  if (kNext == kBegin) {
+    return m_hitRatios[m_offsets[kCurve]];
+  }
+  size_t const kJ = kNext - m_sizes.begin();
+  if (kNext == kEnd) {
+    return m_hitRatios[kJ - 1];
+  }
+  return m_hitRatios[kJ - 1] + (m_hitRatios[kJ] - m_hitRatios[kJ - 1]) *
+                                   (kSize - m_sizes[kJ - 1]) /
+                                   (m_sizes[kJ] - m_sizes[kJ - 1]);
+}
+
+double FairAllocation::normalizedHitRatio(size_t const kCurve,
+                                          double const kSize) const {
+  double const kBest = m_hitRatios[m_offsets[kCurve + 1] - 1];
+  return kBest > 0.0 ? hitRatio(kCurve, kSize) / kBest : 1.0;
+}
+
+/**
+ * @brief Smallest size at which a pool reaches a hit ratio.
+ */
+double FairAllocation::sizeFor(size_t const kCurve,
+                               double const kHitRatio) const {
+  auto const kBegin = m_hitRatios.begin() + m_offsets[kCurve];
+  auto const kEnd = m_hitRatios.begin() + m_offsets[kCurve + 1];
+  auto const kNext = std::lower_bound(kBegin, kEnd, kHitRatio);
+  if (kNext == kBegin) {
+    return m_sizes[m_offsets[kCurve]];
+  }
+  size_t const kJ = kNext - m_hitRatios.begin();
+  if (kNext == kEnd) {
+    return m_sizes[kJ - 1];
+  }
+  return m_sizes[kJ - 1] + (m_sizes[kJ] - m_sizes[kJ - 1]) *
+                               (kHitRatio - m_hitRatios[kJ - 1]) /
+                               (m_hitRatios[kJ] - m_hitRatios[kJ - 1]);
+}
+
+/**
+ * @brief Max-min fair allocation of the normalized hit ratio.
+ *
+ * The memory needed to bring every pool to a normalized level grows
+ * piecewise linearly with the level, so the highest affordable level is
+ * found by regula falsi (with the Illinois modification, which keeps both
+ * ends of the bracket moving).
+ */
+std::vector<uint64_t> FairAllocation::maxMin(uint64_t const kBudget) const {
+  auto const kBest = [&](size_t const kCurve) {
+    return m_hitRatios[m_offsets[kCurve + 1] - 1];
+  };
+  auto const kExcess = [&](double const kLevel) {
+    double total = 0.0;
+    for (size_t i = 0; i < size(); i++) {
+      total += sizeFor(i, kLevel * kBest(i));
+    }
+    return total - kBudget;
+  };
+
+  double low = 0.0, high = 1.0;
+  double lowExcess = kExcess(low), highExcess = kExcess(high);
+  if (highExcess <= 0.0) {
+    low = high;
+  } else {
+    int side = 0;
+    for (int step = 0; step < kMaxSteps && high - low > kMinBracket;
+         step++) {
+      double const kLevel =
+          (low * highExcess - high * lowExcess) / (highExcess - lowExcess);
+      double const kExcessAtLevel = kExcess(kLevel);
+      if (kExcessAtLevel <= 0.0) {
+        low = kLevel;
+        lowExcess = kExcessAtLevel;
+        if (kExcessAtLevel > -kTolerance) {
+          break;
+        }
+        if (side < 0) {
+          highExcess /= 2;
+        }
+        side = -1;
+      } else {
+        high = kLevel;
+        highExcess = kExcessAtLevel;
+        if (side > 0) {
+          lowExcess /= 2;
+        }
+        side = 1;
+      }
+    }
+  }
+
+  std::vector<uint64_t> sizes(size());
+  for (size_t i = 0; i < size(); i++) {
+    sizes[i] = static_cast<uint64_t>(sizeFor(i, low * kBest(i)));
+  }
+  return sizes;
+}
+
+/**
+ * @brief Appends the concave hull segments of the last curve added.
+ *
+ * Uses the monotone chain over the curve's points, so its segments have
+ * strictly decreasing gains per byte. Segments gaining nothing are left
+ * out.
+ */
+void FairAllocation::addSegments() {
+  size_t const kCurve = size() - 1;
+  double const kThroughput = m_throughputs[kCurve];
+
+  m_hull.clear();
+  for (size_t j = m_offsets[kCurve]; j < m_offsets[kCurve + 1]; j++) {
+    double const kX = m_sizes[j], kY = kThroughput * m_hitRatios[j];
+    while (m_hull.size() >= 2) {
+      auto const &[kAX, kAY] = m_hull[m_hull.size() - 2];
+      auto const &[kBX, kBY] = m_hull.back();
+      if ((kBY - kAY) * (kX - kAX) > (kY - kAY) * (kBX - kAX)) {
+        break;
+      }
+      m_hull.pop_back();
+    }
+    m_hull.emplace_back(kX, kY);
+  }
+
+  for (size_t k = 1; k < m_hull.size(); k++) {
+    double const kLength = m_hull[k].first - m_hull[k - 1].first;
+    double const kSlope = (m_hull[k].second - m_hull[k - 1].second) / kLength;
+    if (kSlope <= 0.0) {
+      break;
+    }
+    uint32_t const kBucket = bucket(kSlope);
+    m_lowestBucket = std::min(m_lowestBucket, kBucket);
+    m_highestBucket = std::max(m_highestBucket, kBucket);
+    m_segments.push_back(Segment{.m_slope = kSlope,
+                                 .m_start = m_hull[k - 1].first,
+                                 .m_length = kLength,
+                                 .m_pool = static_cast<uint32_t>(kCurve),
+                                 .m_bucket = kBucket});
+  }
+}
+
+/**
+ * @brief Allocation maximizing the aggregated hit throughput.
+ *
+ * On concave curves, the optimum takes (beyond the floors) every segment
+ * steeper than some threshold and part of the segment at it. The bucket
+ * holding the threshold is found with one pass over the segments; within
+ * it, the threshold is located by quickselect weighted by the segment
+ * lengths.
+ */
+std::vector<uint64_t>
+FairAllocation::efficient(std::vector<uint64_t> const &kFloors,
+                          uint64_t const kBudget) {
+  size_t const kPools = size();
+  std::vector<double> sizes(kPools);
+  std::vector<uint64_t> result(kPools);
+
+  double floorsTotal = 0.0;
+  for (size_t i = 0; i < kPools; i++) {
+    sizes[i] = std::min(kFloors[i], m_ceilings[i]);
+    floorsTotal += sizes[i];
+  }
+  if (floorsTotal >= kBudget) {
+    double const kScale = floorsTotal > 0 ? kBudget / floorsTotal : 0.0;
+    for (size_t i = 0; i < kPools; i++) {
+      result[i] = static_cast<uint64_t>(sizes[i] * kScale);
+    }
+    return result;
+  }
+
+  // Part of a segment beyond the floor of its pool
+  auto const kBeyondFloor = [&](Segment const &kSegment) {
+    double const kFloor = std::min(kFloors[kSegment.m_pool],
+                                   m_ceilings[kSegment.m_pool]);
+    return std::min(kSegment.m_length,
+                    kSegment.m_start + kSegment.m_length - kFloor);
+  };
+
+  // Count the segments by slope, steepest bucket last
+  double remaining = kBudget - floorsTotal;
+  m_bucketLengths.assign(
+      m_segments.empty() ? 0 : m_highestBucket - m_lowestBucket + 1, 0.0);
+  for (auto const &segment : m_segments) {
+    double const kLength = kBeyondFloor(segment);
+    if (kLength > 0.0) {
+      m_bucketLengths[segment.m_bucket - m_lowestBucket] += kLength;
+    }
+  }
+
+  // Everything steeper than the bucket where the budget runs out is taken
+  uint32_t threshold = m_highestBucket + 1;
+  for (size_t b = m_bucketLengths.size(); b-- > 0;) {
+    if (m_bucketLengths[b] > remaining) {
+      threshold = m_lowestBucket + b;
+      break;
+    }
+    remaining -= m_bucketLengths[b];
+  }
+  m_candidates.clear();
+  for (auto const &segment : m_segments) {
+    double const kLength = kBeyondFloor(segment);
+    if (kLength <= 0.0 || segment.m_bucket < threshold) {
+      continue;
+    }
+    if (segment.m_bucket > threshold) {
+      sizes[segment.m_pool] += kLength;
+    } else {
+      m_candidates.push_back(segment);
+      m_candidates.back().m_length = kLength;
+    }
+  }
+
+  // Weighted quickselect within that bucket
+  auto first = m_candidates.begin(), last = m_candidates.end();
+  while (first != last && remaining > 0.0) {
+    auto const kPivot = first + (last - first) / 2;
+    std::nth_element(first, kPivot, last,
+                     [](Segment const &a, Segment const &b) {
+                       return a.m_slope > b.m_slope;
+                     });
+    double steeper = 0.0;
+    for (auto it = first; it != kPivot; ++it) {
+      steeper += it->m_length;
+    }
+    if (steeper > remaining) {
+      last = kPivot;
+      continue;
+    }
+
+    for (auto it = first; it != kPivot; ++it) {
+      sizes[it->m_pool] += it->m_length;
+    }
+    double const kTaken = std::min(kPivot->m_length, remaining - steeper);
+    sizes[kPivot->m_pool] += kTaken;
+    remaining -= steeper + kTaken;
+    first = kPivot + 1;
+  }
+
+  // Spread the memory that improves no pool by the room each has left
+  double room = 0.0;
+  for (size_t i = 0; i < kPools; i++) {
+    room += m_ceilings[i] - sizes[i];
+  }
+  double const kFill = room > 0.0 ? std::min(1.0, remaining / room) : 0.0;
+  for (size_t i = 0; i < kPools; i++) {
+    if (kFill > 0.0) {
+      sizes[i] += (m_ceilings[i] - sizes[i]) * kFill;
+    }
+    result[i] = std::min(static_cast<uint64_t>(sizes[i]), m_ceilings[i]);
+  }
+  return result;
+}
+
+/**
+ * @brief MRC of all pools together, as if they were a single pool.
+ *
+ * Walks the hull segments of every pool from the steepest one: the combined
+ * hit throughput grows by each segment's gain over its length.
+ */
+std::map<uint64_t, float>
+FairAllocation::combinedMRC(size_t const kMaxPoints) const {
+  std::map<uint64_t, float> mrc;
+  double totalThroughput = 0.0, totalSize = 0.0;
+  for (size_t i = 0; i < size(); i++) {
+    totalThroughput += m_throughputs[i];
+  }
+  for (auto const &segment : m_segments) {
+    totalSize += segment.m_length;
+  }
+  if (totalThroughput <= 0.0 || kMaxPoints == 0) {
+    return mrc;
+  }
+
+  std::vector<Segment> segments(m_segments);
+  std::sort(segments.begin(), segments.end(),
+            [](Segment const &a, Segment const &b) {
+              return a.m_slope > b.m_slope;
+            });
+
+  // Sample the (concave) combined hit curve every step
+  double const kStep = totalSize / kMaxPoints;
+  double size = 0.0, hits = 0.0, next = kStep;
+  for (auto const &segment : segments) {
+    double const kEnd = size + segment.m_length;
+    while (next < kEnd && mrc.size() + 1 < kMaxPoints) {
+      mrc[static_cast<uint64_t>(next)] = static_cast<float>(
+          1.0 - (hits + segment.m_slope * (next - size)) / totalThroughput);
+      next += kStep;
+    }
+    hits += segment.m_slope * segment.m_length;
+    size = kEnd;
+  }
+  mrc[static_cast<uint64_t>(size)] =
+      static_cast<float>(std::max(0.0, 1.0 - hits / totalThroughput));
+  return mrc;
+}
+
+double
+FairAllocation::hitThroughput(std::vector<uint64_t> const &kSizes) const {
+  double total = 0.0;
+  for (size_t i = 0; i < size(); i++) {
+    total += hitThroughput(i, kSizes[i]);
+  }
+  return total;
+}
+
+double FairAllocation::jainIndex(std::vector<uint64_t> const &kSizes) const {
+  double sum = 0.0, squares = 0.0;
+  for (size_t i = 0; i < size(); i++) {
+    double const kX = normalizedHitRatio(i, kSizes[i]);
+    sum += kX;
+    squares += kX * kX;
+  }
+  return squares > 0.0 ? sum * sum / (size() * squares) : 1.0;
+}
+
+} // namespace holpaca
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace holpaca {
+
+/**
+ * @brief Fair and efficient memory allocations over pool hit-ratio curves.
+ *
+ * Each pool's MRC is turned into a non-decreasing, piecewise-linear hit
+ * ratio curve over [0, ceiling]. A pool's normalized hit ratio is its hit
+ * ratio divided by the one it would reach at its ceiling, so pools with very
+ * different working sets are compared by how far they are from their best.
+ *
+ * Both allocations work directly on the MRC points (rather than on a
+ * slab-granular UtilityTable), so that a solve stays well below a
+ * millisecond for a thousand pools:
+ * - maxMin finds the highest normalized hit ratio every pool can reach
+ *   together. The memory this takes is piecewise linear in the level, so
+ *   regula falsi converges to within a slab in a few evaluations.
+ * - efficient maximizes the aggregated hit throughput on the concave hull of
+ *   each pool's curve (built once, when the curve is added): beyond the
+ *   floors, it takes the hull segments with the largest gain per byte until
+ *   the budget is spent. Rather than sorting them, segments are
+ *   counted into buckets by the leading bits of their gain, and only the
+ *   bucket where the budget runs out is searched exactly.
+ *
+ * Buffers are kept between control loops to avoid reallocations.
+ */
+class FairAllocation {
+  /* Sizes of the points of every curve, stored back to back */
+  std::vector<double> m_sizes;
+
+  /* Hit ratio at each point (non-decreasing within a curve) */
+  std::vector<double> m_hitRatios;
+
+  /* Offset of the first point of each curve (plus one past the last) */
+  std::vector<size_t> m_offsets{0};
+
+  /* Request throughput of each pool (Ops/sec) */
+  std::vector<double> m_throughputs;
+
+  /* Largest size of each pool */
+  std::vector<uint64_t> m_ceilings;
+
+  /**
+   * @brief Segment of the concave hull of a pool's hit throughput curve.
+   */
+  struct Segment {
+    double m_slope;    /* Hit throughput gained per byte */
+    double m_start;    /* Size at which the segment starts */
+    double m_length;   /* Bytes spanned */
+    uint32_t m_pool;   /* Curve the segment belongs to */
+    uint32_t m_bucket; /* Slope bucket (steeper segments, larger buckets) */
+  };
+
+  /* Hull segments of every curve that gain something */
+  std::vector<Segment> m_segments;
+
+  /* Range of slope buckets the segments fall in */
+  uint32_t m_lowestBucket{UINT32_MAX}, m_highestBucket{0};
+
+  /* Vertices of the hull being built (size, hit throughput) */
+  std::vector<std::pair<double, double>> m_hull;
+
+  /* Total length of the segments in each slope bucket of the range */
+  std::vector<double> m_bucketLengths;
+
+  /* Segments in the bucket where the budget runs out */
+  std::vector<Segment> m_candidates;
+
+  /**
+   * @brief Smallest size at which a pool reaches a hit ratio.
+   */
+  double sizeFor(size_t const kCurve, double const kHitRatio) const;
+
+  /**
+   * @brief Appends the concave hull segments of the last curve added.
+   */
+  void addSegments();
+
+public:
+  /**
+   * @brief Removes all curves, keeping the allocated memory for reuse.
+   */
+  void clear();
+
+  /**
+   * @brief Adds the hit ratio curve of a pool.
+   *
+   * @param kMRC MRC points of the pool (size -> miss ratio)
+   * @param kThroughput Request throughput of the pool (Ops/sec)
+   * @param kCeiling Largest size the pool may take
+   * @return Index of the new curve
+   */
+  size_t add(std::map<uint64_t, float> const &kMRC, double const kThroughput,
+             uint64_t const kCeiling);
+
+  /**
+   * @brief Number of curves.
+   */
+  size_t size() const { return m_throughputs.size(); }
+
+  /**
+   * @brief Predicted hit ratio of a pool at the given size.
+   */
+  double hitRatio(size_t const kCurve, double const kSize) const;
+
+  /**
+   * @brief Predicted hit ratio of a pool relative to the one at its ceiling.
+   *
+   * Pools that cannot hit at all are considered fully served.
+   */
+  double normalizedHitRatio(size_t const kCurve, double const kSize) const;
+
+  /**
+   * @brief Predicted hit throughput of a pool at the given size.
+   */
+  double hitThroughput(size_t const kCurve, double const kSize) const {
+    return m_throughputs[kCurve] * hitRatio(kCurve, kSize);
+  }
+
+  /**
+   * @brief Max-min fair allocation of the normalized hit ratio.
+   *
+   * Only the memory needed to reach the common level is assigned; the rest
+   * of the budget is left for a subsequent efficient allocation.
+   *
+   * @param kBudget Memory to distribute
+   * @return Size of each pool, in insertion order
+   */
+  std::vector<uint64_t> maxMin(uint64_t const kBudget) const;
+
+  /**
+   * @brief Allocation maximizing the aggregated hit throughput.
+   *
+   * Memory that improves no pool is spread in proportion to the room each
+   * pool has left, so the whole budget is assigned if the ceilings allow.
+   * Floors exceeding the budget are scaled down proportionally.
+   *
+   * @param kFloors Minimum size of each pool
+   * @param kBudget Memory to distribute, floors included
+   * @return Size of each pool, in insertion order
+   */
+  std::vector<uint64_t> efficient(std::vector<uint64_t> const &kFloors,
+                                  uint64_t const kBudget);
+
+  /**
+   * @brief MRC of all pools together, as if they were a single pool.
+   *
+   * At every total size, the memory is split among the pools as efficient()
+   * would (i.e., along the concave hulls of their curves, steepest segments
+   * first), and the miss ratio is that of their combined requests.
+   *
+   * @param kMaxPoints Maximum number of points, evenly spaced in size
+   * @return Combined MRC (size -> miss ratio), empty if no pool has requests
+   */
+  std::map<uint64_t, float> combinedMRC(size_t const kMaxPoints) const;
+
+  /**
+   * @brief Aggregated predicted hit throughput of an allocation.
+   */
+  double hitThroughput(std::vector<uint64_t> const &kSizes) const;
+
+  /**
+   * @brief Jain's fairness index of the normalized hit ratios of an
+   * allocation, in [1/n, 1] (1 when every pool is equally served).
+   */
+  double jainIndex(std::vector<uint64_t> const &kSizes) const;
+};
+
+} // namespace holpaca
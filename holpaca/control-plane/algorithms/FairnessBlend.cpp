@@ -0,0 +1,122 @@
+#include <holpaca/control-plane/algorithms/FairnessBlend.h>
+
+#include <algorithm>
+#include <iostream>
+
+namespace holpaca {
+
+/**
+ * @brief Constructs the FairnessBlend algorithm instance.
+ */
+FairnessBlend::FairnessBlend(ProxyManager *const kProxyManager,
+                             std::chrono::milliseconds const kPeriodicity,
+                             double const kAlpha, std::string const &kName)
+    : StagedAlgorithm(kProxyManager, kPeriodicity), m_kName(kName),
+      m_kAlpha(std::clamp(kAlpha, 0.0, 1.0)) {}
+
+FairnessBlend::FairnessBlend(ProxyManager *const kProxyManager,
+                             std::chrono::milliseconds const kPeriodicity,
+                             double const kAlpha)
+    : FairnessBlend(kProxyManager, kPeriodicity, kAlpha, "FairnessBlend") {}
+
+/**
+ * @brief Constructs the MaxMinFairness algorithm instance.
+ */
+MaxMinFairness::MaxMinFairness(ProxyManager *const kProxyManager,
+                               std::chrono::milliseconds const kPeriodicity)
+    : FairnessBlend(kProxyManager, kPeriodicity, 1.0, "MaxMinFairness") {}
+
+/**
+ * @brief Blends the fair and the efficient allocations, reports their
+ * fairness and efficiency, and proposes the new sizes.
+ *
+ * @param kAllCacheStatus Status of all caches, collected for the round
+ * @param allocation Sizes and floors proposed by the previous stages
+ */
+void FairnessBlend::apply(
+    std::unordered_map<std::string, ProxyManager::CacheStatus> const
+        &kAllCacheStatus,
+    Allocation &allocation) {
+  auto const kStart = std::chrono::high_resolution_clock::now();
+
+  uint64_t totalSize = 0;
+  int pools = 0;
+  int newPools = 0;
+  for (const auto &[cacheId, cacheStatus] : kAllCacheStatus) {
+    totalSize += cacheStatus.m_maxSize;
+    for (const auto &[poolId, poolStatus] : cacheStatus.m_pools) {
+      if (poolStatus.m_MRC.size() < m_kMRCMinLength) {
+        newPools++;
+      }
+      pools++;
+    }
+  }
+  if (pools == 0) {
+    return;
+  }
+
+  // Pools without a meaningful MRC yet get an even share of the memory
+  uint64_t const kNewPoolSize = totalSize / pools;
+  uint64_t const kBudget = totalSize - newPools * kNewPoolSize;
+
+  // Hit ratio curve of every modeled pool
+  std::vector<std::pair<std::string, PoolId>> ids;
+  m_allocation.clear();
+  for (const auto &[cacheId, cacheStatus] : kAllCacheStatus) {
+    for (const auto &[poolId, poolStatus] : cacheStatus.m_pools) {
+      if (poolStatus.m_MRC.size() < m_kMRCMinLength) {
+        continue;
+      }
+      ids.emplace_back(cacheId, poolId);
+      m_allocation.add(poolStatus.m_MRC, poolStatus.plannedThroughput(),
+                       std::min(cacheStatus.m_maxSize, kBudget));
+    }
+  }
+
+  // Guarantee a share of the fair allocation, then maximize hits
+  std::vector<uint64_t> floors = m_allocation.maxMin(kBudget);
+  for (size_t i = 0; i < ids.size(); i++) {
+    auto const &[cacheId, poolId] = ids[i];
+    uint64_t const kCeiling =
+        std::min(kAllCacheStatus.at(cacheId).m_maxSize, kBudget);
+    floors[i] = std::max(static_cast<uint64_t>(floors[i] * m_kAlpha),
+                         std::min(allocation.floor(cacheId, poolId), kCeiling));
+  }
+  auto const kSizes = m_allocation.efficient(floors, kBudget);
+
+  // Fairness and efficiency of the allocation
+  if (!ids.empty()) {
+    std::fill(floors.begin(), floors.end(), 0);
+    double const kBest =
+        m_allocation.hitThroughput(m_allocation.efficient(floors, kBudget));
+    double const kLoss =
+        kBest > 0.0
+            ? std::max(0.0, 1.0 - m_allocation.hitThroughput(kSizes) / kBest)
+            : 0.0;
+    std::chrono::duration<double, std::micro> const kCompute =
+        std::chrono::high_resolution_clock::now() - kStart;
+    std::cout << m_kName << ": alpha " << m_kAlpha << ", fairness index "
+              << m_allocation.jainIndex(kSizes) << ", efficiency loss "
+              << kLoss << ", compute " << kCompute.count() << " us"
+              << std::endl;
+  }
+
+  // Propose the sizes and their predicted gains
+  for (const auto &[cacheId, cacheStatus] : kAllCacheStatus) {
+    for (const auto &[poolId, poolStatus] : cacheStatus.m_pools) {
+      if (poolStatus.m_MRC.size() < m_kMRCMinLength) {
+        allocation.propose(cacheId, poolId, kNewPoolSize);
+      }
+    }
+  }
+  for (size_t i = 0; i < ids.size(); i++) {
+    auto const &[cacheId, poolId] = ids[i];
+    uint64_t const kCurrentSize =
+        kAllCacheStatus.at(cacheId).m_pools.at(poolId).m_maxSize;
+    allocation.propose(cacheId, poolId, kSizes[i],
+                       m_allocation.hitThroughput(i, kSizes[i]) -
+                           m_allocation.hitThroughput(i, kCurrentSize));
+  }
+}
+
+} // namespace holpaca
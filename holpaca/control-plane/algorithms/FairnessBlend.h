@@ -0,0 +1,101 @@
+#pragma once
+#include <holpaca/control-plane/ProxyManager.h>
+#include <holpaca/control-plane/algorithms/FairAllocation.h>
+#include <holpaca/control-plane/algorithms/PipelineStage.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace holpaca {
+
+/**
+ * @brief Control algorithm trading fairness for efficiency with a knob.
+ *
+ * Computes the max-min fair allocation of the normalized hit ratio (see
+ * FairAllocation) and guarantees every pool a fraction alpha of its fair
+ * size. The remaining memory is distributed to maximize the aggregated hit
+ * throughput. With alpha = 1 the result is max-min fair (and work-conserving);
+ * with alpha = 0 it only maximizes the hit throughput.
+ *
+ * Every loop reports Jain's fairness index of the normalized hit ratios and
+ * the efficiency loss, i.e., the fraction of the maximum achievable hit
+ * throughput given up for fairness.
+ *
+ * Floors raised by earlier stages are kept on top of the fair share.
+ */
+class FairnessBlend : public StagedAlgorithm {
+
+  /* Minimum MRC length to consider a pool for optimization */
+  const uint32_t m_kMRCMinLength{3};
+
+  /* Name used when reporting */
+  std::string const m_kName;
+
+  /* Fraction of the fair allocation guaranteed to every pool, in [0, 1] */
+  double const m_kAlpha;
+
+  /* Hit ratio curves of the modeled pools */
+  FairAllocation m_allocation;
+
+protected:
+  /**
+   * @brief Constructs a named FairnessBlend algorithm instance.
+   *
+   * @param kProxyManager Pointer to ProxyManager for resizing pools
+   * @param kPeriodicity Time between optimization iterations
+   * @param kAlpha Fraction of the fair allocation guaranteed, in [0, 1]
+   * @param kName Name used when reporting
+   */
+  FairnessBlend(ProxyManager *const kProxyManager,
+                std::chrono::milliseconds const kPeriodicity,
+                double const kAlpha, std::string const &kName);
+
+public:
+  /**
+   * @brief Constructs a FairnessBlend algorithm instance.
+   *
+   * @param kProxyManager Pointer to ProxyManager for resizing pools
+   * @param kPeriodicity Time between optimization iterations
+   * @param kAlpha Fraction of the fair allocation guaranteed, in [0, 1]
+   */
+  FairnessBlend(ProxyManager *const kProxyManager,
+                std::chrono::milliseconds const kPeriodicity,
+                double const kAlpha);
+
+  /**
+   * @brief Name of the stage, used when reporting.
+   */
+  std::string name() const override final { return m_kName; }
+
+  /**
+   * @brief Blends the fair and the efficient allocations, reports their
+   * fairness and efficiency, and proposes the new sizes.
+   *
+   * @param kAllCacheStatus Status of all caches, collected for the round
+   * @param allocation Sizes and floors proposed by the previous stages
+   */
+  void apply(std::unordered_map<std::string, ProxyManager::CacheStatus> const
+                 &kAllCacheStatus,
+             Allocation &allocation) override final;
+};
+
+/**
+ * @brief Control algorithm enforcing max-min fairness of the normalized hit
+ * ratio; memory beyond the fair allocation goes where it yields most hits.
+ */
+class MaxMinFairness : public FairnessBlend {
+public:
+  /**
+   * @brief Constructs a MaxMinFairness algorithm instance.
+   *
+   * @param kProxyManager Pointer to ProxyManager for resizing pools
+   * @param kPeriodicity Time between optimization iterations
+   */
+  MaxMinFairness(ProxyManager *const kProxyManager,
+                 std::chrono::milliseconds const kPeriodicity);
+};
+
+} // namespace holpaca
@@ -0,0 +1,60 @@
+#include <holpaca/control-plane/algorithms/GreedyAllocation.h>
+
+#include <algorithm>
+#include <numeric>
+#include <queue>
+
+namespace holpaca {
+
+/**
+ * @brief Distributes a memory budget among pools by marginal utility.
+ *
+ * Uses a max-heap keyed by the gain of each pool's next chunk, so every
+ * chunk costs O(log n) regardless of the number of pools.
+ */
+std::vector<uint64_t> greedyAllocation(UtilityTable const &kUtilityTable,
+                                       std::vector<uint64_t> const &kFloors,
+                                       std::vector<uint64_t> const &kCeilings,
+                                       uint64_t const kBudget,
+                                       uint64_t const kStep) {
+  std::vector<uint64_t> sizes(kFloors);
+  uint64_t const kAssigned =
+      std::accumulate(sizes.begin(), sizes.end(), uint64_t{0});
+  if (kAssigned >= kBudget || kStep == 0) {
+    return sizes;
+  }
+  uint64_t remaining = kBudget - kAssigned;
+
+  // Gain of granting the next chunk to a pool (nothing if it is full)
+  auto nextChunk = [&](size_t const kPool) -> std::pair<double, size_t> {
+    uint64_t const kChunk =
+        std::min({kStep, remaining, kCeilings[kPool] - sizes[kPool]});
+    return {kUtilityTable.delta(kPool, sizes[kPool], sizes[kPool] + kChunk),
+            kPool};
+  };
+
+  std::priority_queue<std::pair<double, size_t>> heap;
+  for (size_t i = 0; i < sizes.size(); i++) {
+    if (sizes[i] < kCeilings[i]) {
+      heap.push(nextChunk(i));
+    }
+  }
+
+  while (remaining > 0 && !heap.empty()) {
+    size_t const kPool = heap.top().second;
+    heap.pop();
+
+    uint64_t const kChunk =
+        std::min({kStep, remaining, kCeilings[kPool] - sizes[kPool]});
+    sizes[kPool] += kChunk;
+    remaining -= kChunk;
+
+    if (sizes[kPool] < kCeilings[kPool]) {
+      heap.push(nextChunk(kPool));
+    }
+  }
+
+  return sizes;
+}
+
+} // namespace holpaca
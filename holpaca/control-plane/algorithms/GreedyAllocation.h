@@ -0,0 +1,31 @@
+#pragma once
+
+#include <holpaca/control-plane/algorithms/UtilityTable.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace holpaca {
+
+/**
+ * @brief Distributes a memory budget among pools by marginal utility.
+ *
+ * Every pool starts at its floor. The remaining budget is then handed out in
+ * chunks of kStep bytes, each to the pool whose utility grows the most with
+ * it, until the budget is exhausted or every pool reached its ceiling.
+ *
+ * @param kUtilityTable Utility curve of each pool, sampled over at least
+ *    [floor, ceiling]
+ * @param kFloors Minimum size of each pool
+ * @param kCeilings Maximum size of each pool
+ * @param kBudget Total memory to distribute, floors included
+ * @param kStep Granularity of the distribution (at least one slab)
+ * @return Size of each pool, in the same order as the curves
+ */
+std::vector<uint64_t> greedyAllocation(UtilityTable const &kUtilityTable,
+                                       std::vector<uint64_t> const &kFloors,
+                                       std::vector<uint64_t> const &kCeilings,
+                                       uint64_t const kBudget,
+                                       uint64_t const kStep);
+
+} // namespace holpaca
@@ -0,0 +1,118 @@
+#include <holpaca/control-plane/algorithms/GreedyAllocation.h>
+#include <holpaca/control-plane/algorithms/IdleMemoryTax.h>
+#include <holpaca/control-plane/algorithms/MissRatioCurve.h>
+#include <holpaca/control-plane/algorithms/UtilityTable.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace holpaca {
+
+/**
+ * @brief Constructs an idle memory tax.
+ */
+IdleMemoryTax::IdleMemoryTax(double const kRate, double const kHeadroom,
+                             uint32_t const kMRCMinLength)
+    : m_kRate(kRate), m_kHeadroom(kHeadroom), m_kMRCMinLength(kMRCMinLength) {
+}
+
+/**
+ * @brief Moves taxed memory from idle pools to the pools gaining most.
+ *
+ * Taxes are collected only when some pool can take them; whatever the
+ * recipients cannot take (e.g., because they reached their cache capacity)
+ * is left with the taxed pools, proportionally to their tax.
+ *
+ * @param kAllCacheStatus Status of all caches
+ * @param sizes Size of each pool, per cache; updated in place
+ * @param kFloors Size no pool is taxed below, per cache (0 if missing)
+ * @return Number of bytes moved
+ */
+uint64_t IdleMemoryTax::apply(
+    std::unordered_map<std::string, ProxyManager::CacheStatus> const
+        &kAllCacheStatus,
+    std::unordered_map<std::string, std::unordered_map<PoolId, uint64_t>>
+        &sizes,
+    std::unordered_map<std::string,
+                       std::unordered_map<PoolId, uint64_t>> const &kFloors)
+    const {
+  // Tax of every idle pool
+  std::vector<std::pair<uint64_t *, uint64_t>> taxes;
+  uint64_t collected = 0;
+
+  // Hit throughput of every recipient as a function of its size
+  std::vector<uint64_t *> recipients;
+  std::vector<uint64_t> floors, ceilings;
+  UtilityTable utilityTable;
+
+  for (const auto &[cacheId, cacheStatus] : kAllCacheStatus) {
+    auto &cacheSizes = sizes[cacheId];
+    auto const kCacheFloors = kFloors.find(cacheId);
+    for (const auto &[poolId, poolStatus] : cacheStatus.m_pools) {
+      auto const kSize = cacheSizes.find(poolId);
+      if (kSize == cacheSizes.end()) {
+        continue;
+      }
+
+      uint64_t needed =
+          static_cast<uint64_t>(poolStatus.m_usedSize * (1 + m_kHeadroom));
+      if (kCacheFloors != kFloors.end()) {
+        auto const kFloor = kCacheFloors->second.find(poolId);
+        if (kFloor != kCacheFloors->second.end()) {
+          needed = std::max(needed, kFloor->second);
+        }
+      }
+      if (poolStatus.m_allocFailures == 0 && needed < kSize->second) {
+        uint64_t const kTax =
+            static_cast<uint64_t>((kSize->second - needed) * m_kRate);
+        if (kTax >= UtilityTable::kStep) {
+          taxes.emplace_back(&kSize->second, kTax);
+          collected += kTax;
+        }
+      } else if (poolStatus.m_MRC.size() >= m_kMRCMinLength &&
+                 kSize->second < cacheStatus.m_maxSize) {
+        MissRatioCurve const kMRC(poolStatus.m_MRC);
+        double const kThroughput = poolStatus.m_throughput;
+        recipients.push_back(&kSize->second);
+        floors.push_back(kSize->second);
+        ceilings.push_back(cacheStatus.m_maxSize);
+        utilityTable.add(
+            [&](double size) { return kThroughput * (1.0 - kMRC(size)); },
+            floors.back(), ceilings.back());
+      }
+    }
+  }
+
+  if (collected == 0 || recipients.empty()) {
+    return 0;
+  }
+
+  // Hand the taxes to the steepest MRCs
+  uint64_t budget = collected;
+  for (auto const kFloor : floors) {
+    budget += kFloor;
+  }
+  auto const kGranted = greedyAllocation(utilityTable, floors, ceilings,
+                                         budget, UtilityTable::kStep);
+  uint64_t moved = 0;
+  for (size_t i = 0; i < recipients.size(); i++) {
+    moved += kGranted[i] - floors[i];
+    *recipients[i] = kGranted[i];
+  }
+
+  // Only collect what was actually handed out
+  double const kShare = moved / static_cast<double>(collected);
+  uint64_t taken = 0;
+  for (size_t i = 0; i < taxes.size(); i++) {
+    auto &[size, tax] = taxes[i];
+    uint64_t const kTaken = i + 1 < taxes.size()
+                                ? static_cast<uint64_t>(tax * kShare)
+                                : moved - taken;
+    *size -= kTaken;
+    taken += kTaken;
+  }
+
+  return moved;
+}
+
+} // namespace holpaca
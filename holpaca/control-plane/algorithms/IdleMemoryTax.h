@@ -0,0 +1,63 @@
+#pragma once
+#include <holpaca/control-plane/ProxyManager.h>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace holpaca {
+
+/**
+ * @brief Progressive reclamation of memory that pools do not use.
+ *
+ * A pool is idle when it had no allocation failures since the last status
+ * and its used size (plus some headroom) is below its size. Every round, a
+ * fraction (the tax rate) of each idle pool's unused memory is reclaimed, so
+ * a pool that stopped using memory gives it back geometrically rather than
+ * all at once. The reclaimed memory goes to the non-idle pools whose MRCs
+ * promise the largest hit throughput gain per byte.
+ *
+ * Operates on a map of pool sizes, so it can run stand-alone (starting from
+ * the current sizes, see IdleTax) or as a pre-pass of another algorithm.
+ */
+class IdleMemoryTax {
+  /* Fraction of a pool's unused memory reclaimed per round */
+  double const m_kRate;
+
+  /* Unused memory a pool keeps, as a fraction of its used size */
+  double const m_kHeadroom;
+
+  /* Minimum MRC length to consider a pool as a recipient */
+  uint32_t const m_kMRCMinLength;
+
+public:
+  /**
+   * @brief Constructs an idle memory tax.
+   *
+   * @param kRate Fraction of the unused memory reclaimed per round, in (0, 1]
+   * @param kHeadroom Unused memory a pool keeps, as a fraction of its used
+   *    size
+   * @param kMRCMinLength Minimum MRC length to consider a pool as a recipient
+   */
+  IdleMemoryTax(double const kRate, double const kHeadroom,
+                uint32_t const kMRCMinLength);
+
+  /**
+   * @brief Moves taxed memory from idle pools to the pools gaining most.
+   *
+   * @param kAllCacheStatus Status of all caches
+   * @param sizes Size of each pool, per cache; updated in place
+   * @param kFloors Size no pool is taxed below, per cache (0 if missing)
+   * @return Number of bytes moved
+   */
+  uint64_t apply(
+      std::unordered_map<std::string, ProxyManager::CacheStatus> const
+          &kAllCacheStatus,
+      std::unordered_map<std::string, std::unordered_map<PoolId, uint64_t>>
+          &sizes,
+      std::unordered_map<std::string,
+                         std::unordered_map<PoolId, uint64_t>> const &kFloors =
+          {}) const;
+};
+
+} // namespace holpaca
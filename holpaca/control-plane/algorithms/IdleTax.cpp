@@ -0,0 +1,47 @@
+#include <holpaca/control-plane/algorithms/IdleTax.h>
+
+namespace holpaca {
+
+/**
+ * @brief Constructs the IdleTax algorithm instance.
+ */
+IdleTax::IdleTax(ProxyManager *const kProxyManager,
+                 std::chrono::milliseconds const kPeriodicity,
+                 double const kRate)
+    : StagedAlgorithm(kProxyManager, kPeriodicity),
+      m_kTax(kRate, m_kHeadroom, m_kMRCMinLength) {}
+
+/**
+ * @brief Taxes idle pools and proposes the new sizes if any memory moved.
+ *
+ * @param kAllCacheStatus Status of all caches, collected for the round
+ * @param allocation Sizes and floors proposed by the previous stages
+ */
+void IdleTax::apply(
+    std::unordered_map<std::string, ProxyManager::CacheStatus> const
+        &kAllCacheStatus,
+    Allocation &allocation) {
+  std::unordered_map<std::string, std::unordered_map<PoolId, uint64_t>>
+      newPoolSizePerCache, floorPerCache;
+  for (const auto &[cacheId, pools] : allocation.pools()) {
+    for (const auto &[poolId, pool] : pools) {
+      newPoolSizePerCache[cacheId][poolId] = pool.m_size;
+      floorPerCache[cacheId][poolId] = pool.m_floor;
+    }
+  }
+
+  if (m_kTax.apply(kAllCacheStatus, newPoolSizePerCache, floorPerCache) ==
+      0) {
+    return;
+  }
+
+  for (const auto &[cacheId, pools] : newPoolSizePerCache) {
+    for (const auto &[poolId, size] : pools) {
+      if (size != allocation.size(cacheId, poolId)) {
+        allocation.propose(cacheId, poolId, size);
+      }
+    }
+  }
+}
+
+} // namespace holpaca
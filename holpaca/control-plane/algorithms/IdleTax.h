@@ -0,0 +1,58 @@
+#pragma once
+#include <holpaca/control-plane/ProxyManager.h>
+#include <holpaca/control-plane/algorithms/IdleMemoryTax.h>
+#include <holpaca/control-plane/algorithms/PipelineStage.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace holpaca {
+
+/**
+ * @brief Control algorithm that only reclaims idle memory.
+ *
+ * Starts every round from the proposed pool sizes (the current ones when
+ * run stand-alone) and applies an IdleMemoryTax, leaving every other pool
+ * untouched. Pools are never taxed below their floor.
+ */
+class IdleTax : public StagedAlgorithm {
+
+  /* Minimum MRC length to consider a pool as a recipient */
+  const uint32_t m_kMRCMinLength{3};
+
+  /* Unused memory a pool keeps, as a fraction of its used size */
+  double const m_kHeadroom{0.05};
+
+  /* Reclamation of idle memory */
+  IdleMemoryTax const m_kTax;
+
+public:
+  /**
+   * @brief Constructs an IdleTax algorithm instance.
+   *
+   * @param kProxyManager Pointer to ProxyManager for resizing pools
+   * @param kPeriodicity Time between reclamation rounds
+   * @param kRate Fraction of the unused memory reclaimed per round, in (0, 1]
+   */
+  IdleTax(ProxyManager *const kProxyManager,
+          std::chrono::milliseconds const kPeriodicity, double const kRate);
+
+  /**
+   * @brief Name of the stage, used when reporting.
+   */
+  std::string name() const override final { return "IdleTax"; }
+
+  /**
+   * @brief Taxes idle pools and proposes the new sizes if any memory moved.
+   *
+   * @param kAllCacheStatus Status of all caches, collected for the round
+   * @param allocation Sizes and floors proposed by the previous stages
+   */
+  void apply(std::unordered_map<std::string, ProxyManager::CacheStatus> const
+                 &kAllCacheStatus,
+             Allocation &allocation) override final;
+};
+
+} // namespace holpaca
@@ -0,0 +1,188 @@
+#include <holpaca/control-plane/algorithms/GreedyAllocation.h>
+#include <holpaca/control-plane/algorithms/LatencySLO.h>
+#include <holpaca/control-plane/algorithms/MissRatioCurve.h>
+#include <holpaca/control-plane/algorithms/UtilityTable.h>
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <numeric>
+
+namespace holpaca {
+
+/**
+ * @brief Fraction of the operations of a histogram at or below a latency.
+ *
+ * Operations are assumed to be uniformly spread within each bucket.
+ *
+ * @param kHistogram Map from bucket upper bound (us) to number of operations
+ * @param kLatency Latency in microseconds
+ * @param kEmpty Value returned when the histogram has no operations
+ * @return Cumulative fraction in [0, 1]
+ */
+static double cdf(std::map<uint64_t, uint64_t> const &kHistogram,
+                  double const kLatency, double const kEmpty) {
+  double total = 0.0, below = 0.0;
+  uint64_t lowerBound = 0;
+  for (const auto &[upperBound, count] : kHistogram) {
+    total += count;
+    if (upperBound <= kLatency) {
+      below += count;
+    } else if (lowerBound < kLatency) {
+      below += count * (kLatency - lowerBound) / (upperBound - lowerBound);
+    }
+    lowerBound = upperBound;
+  }
+  return total > 0 ? below / total : kEmpty;
+}
+
+/**
+ * @brief Constructs the LatencySLO algorithm instance.
+ */
+LatencySLO::LatencySLO(ProxyManager *const kProxyManager,
+                       std::chrono::milliseconds const kPeriodicity,
+                       double const kPercentile)
+    : StagedAlgorithm(kProxyManager, kPeriodicity),
+      m_kPercentile(kPercentile) {}
+
+/**
+ * @brief Minimum size for which a pool meets its latency SLO.
+ *
+ * With a miss ratio r, the fraction of reads below the target latency t is
+ * (1 - r) * H(t) + r * M(t), where H and M are the hit and miss latency CDFs.
+ * Meeting the percentile q therefore requires r <= (H(t) - q) / (H(t) - M(t)),
+ * and the MRC gives the smallest size achieving that miss ratio.
+ */
+uint64_t
+LatencySLO::minimumSize(ProxyManager::PoolStatus const &kPoolStatus) const {
+  if (kPoolStatus.m_latencySLO <= 0.0) {
+    return 0;
+  }
+
+  // Without samples, assume hits always and misses never meet the target
+  double const kHit = cdf(kPoolStatus.m_hitLatency, kPoolStatus.m_latencySLO,
+                          /*kEmpty=*/1.0);
+  double const kMiss = cdf(kPoolStatus.m_missLatency,
+                           kPoolStatus.m_latencySLO, /*kEmpty=*/0.0);
+
+  double maxMissRatio;
+  if (kMiss >= m_kPercentile) {
+    maxMissRatio = 1.0; // even misses meet the target
+  } else if (kHit < m_kPercentile) {
+    return std::numeric_limits<uint64_t>::max(); // not even hits meet it
+  } else {
+    maxMissRatio = (kHit - m_kPercentile) / (kHit - kMiss);
+  }
+
+  return MissRatioCurve(kPoolStatus.m_MRC).minSizeFor(maxMissRatio);
+}
+
+/**
+ * @brief Proposes new pool sizes.
+ *
+ * Reserves the memory each SLO requires (or the pool's floor, if larger) and
+ * distributes the remainder by marginal hit throughput.
+ *
+ * @param kAllCacheStatus Status of all caches
+ * @param allocation Proposed allocation, updated in place
+ */
+void LatencySLO::apply(
+    std::unordered_map<std::string, ProxyManager::CacheStatus> const
+        &kAllCacheStatus,
+    Allocation &allocation) {
+  uint64_t totalSize = 0;
+  int pools = 0;
+  int newPools = 0;
+  for (const auto &[cacheId, cacheStatus] : kAllCacheStatus) {
+    totalSize += cacheStatus.m_maxSize;
+    for (const auto &[poolId, poolStatus] : cacheStatus.m_pools) {
+      if (poolStatus.m_MRC.size() < m_kMRCMinLength) {
+        newPools++;
+      }
+      pools++;
+    }
+  }
+  if (pools == 0) {
+    return;
+  }
+
+  // Pools without a meaningful MRC yet get an even share of the memory
+  uint64_t const kNewPoolSize = totalSize / pools;
+  uint64_t const kBudget = totalSize - newPools * kNewPoolSize;
+
+  // Reserve the memory each SLO requires
+  std::vector<std::pair<std::string, PoolId>> ids;
+  std::vector<uint64_t> minimums, floors, ceilings;
+  UtilityTable utilityTable;
+  uint64_t reserved = 0;
+
+  for (const auto &[cacheId, cacheStatus] : kAllCacheStatus) {
+    for (const auto &[poolId, poolStatus] : cacheStatus.m_pools) {
+      if (poolStatus.m_MRC.size() < m_kMRCMinLength) {
+        continue;
+      }
+      uint64_t const kCeiling = std::min(cacheStatus.m_maxSize, kBudget);
+      uint64_t const kMinimum = minimumSize(poolStatus);
+      uint64_t const kFloor =
+          std::max(kMinimum, allocation.floor(cacheId, poolId));
+
+      ids.emplace_back(cacheId, poolId);
+      minimums.push_back(kMinimum);
+      floors.push_back(std::min(kFloor, kCeiling));
+      ceilings.push_back(kCeiling);
+      reserved += floors.back();
+    }
+  }
+
+  // Shrink reservations proportionally when they do not fit together
+  if (reserved > kBudget) {
+    double const kScale = kBudget / static_cast<double>(reserved);
+    for (auto &floor : floors) {
+      floor = static_cast<uint64_t>(floor * kScale);
+    }
+  }
+
+  // Pools whose reservation falls short of what their SLO requires
+  int violations = 0;
+  for (size_t i = 0; i < ids.size(); i++) {
+    if (floors[i] < minimums[i]) {
+      violations++;
+    }
+  }
+  if (violations > 0) {
+    std::cerr << "LatencySLO: " << violations
+              << " pool(s) cannot meet their latency SLO" << std::endl;
+  }
+
+  // Hit throughput of each pool as a function of its size
+  for (size_t i = 0; i < ids.size(); i++) {
+    auto const &poolStatus =
+        kAllCacheStatus.at(ids[i].first).m_pools.at(ids[i].second);
+    MissRatioCurve const kMRC(poolStatus.m_MRC);
+    double const kThroughput = poolStatus.plannedThroughput();
+    utilityTable.add(
+        [&](double size) { return kThroughput * (1.0 - kMRC(size)); },
+        floors[i], ceilings[i]);
+  }
+
+  auto const kSizes = greedyAllocation(utilityTable, floors, ceilings,
+                                       kBudget, UtilityTable::kStep);
+
+  // Propose the new sizes (and their predicted gains)
+  for (const auto &[cacheId, cacheStatus] : kAllCacheStatus) {
+    for (const auto &[poolId, poolStatus] : cacheStatus.m_pools) {
+      if (poolStatus.m_MRC.size() < m_kMRCMinLength) {
+        allocation.propose(cacheId, poolId, kNewPoolSize);
+      }
+    }
+  }
+  for (size_t i = 0; i < ids.size(); i++) {
+    auto const &[cacheId, poolId] = ids[i];
+    uint64_t const kCurrentSize =
+        kAllCacheStatus.at(cacheId).m_pools.at(poolId).m_maxSize;
+    allocation.propose(cacheId, poolId, kSizes[i],
+                       utilityTable.delta(i, kCurrentSize, kSizes[i]));
+  }
+}
+
+} // namespace holpaca
@@ -0,0 +1,61 @@
+#pragma once
+#include <holpaca/control-plane/ProxyManager.h>
+#include <holpaca/control-plane/algorithms/PipelineStage.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace holpaca {
+
+/**
+ * @brief Control algorithm that enforces per-pool tail-latency SLOs.
+ *
+ * Models each pool's read latency as a mixture of its hit and miss latency
+ * distributions, weighted by the miss ratio predicted by its MRC. Each pool
+ * with an SLO first receives the minimum memory for which the mixture meets
+ * its target percentile; the remaining memory is then distributed to maximize
+ * the aggregated hit throughput.
+ */
+class LatencySLO : public StagedAlgorithm {
+
+  /* Minimum MRC length to consider a pool for optimization */
+  const uint32_t m_kMRCMinLength{3};
+
+  /* Percentile the SLOs refer to (e.g., 0.99 for p99) */
+  double const m_kPercentile{0.99};
+
+  /**
+   * @brief Minimum size for which a pool meets its latency SLO.
+   *
+   * @param kPoolStatus Status of the pool, including its latency histograms
+   * @return Size in bytes (0 if the pool has no SLO), or UINT64_MAX if the
+   *    SLO cannot be met even with a zero miss ratio
+   */
+  uint64_t minimumSize(ProxyManager::PoolStatus const &kPoolStatus) const;
+
+public:
+  /**
+   * @brief Constructs a LatencySLO algorithm instance.
+   *
+   * @param kProxyManager Pointer to ProxyManager for resizing pools
+   * @param kPeriodicity Time between optimization iterations
+   * @param kPercentile Percentile the SLOs refer to, in (0, 1)
+   */
+  LatencySLO(ProxyManager *const kProxyManager,
+             std::chrono::milliseconds const kPeriodicity,
+             double const kPercentile);
+
+  std::string name() const override final { return "LatencySLO"; }
+
+  /**
+   * @brief Reserves the memory each SLO requires and distributes the
+   * remainder by marginal hit throughput.
+   */
+  void apply(std::unordered_map<std::string, ProxyManager::CacheStatus> const
+                 &kAllCacheStatus,
+             Allocation &allocation) override final;
+};
+
+} // namespace holpaca
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <map>
+
+namespace holpaca {
+
+/**
+ * @brief Piecewise-linear view over a pool's Miss Ratio Curve (MRC).
+ *
+ * Wraps the MRC points reported by an agent (size -> miss ratio) and
+ * interpolates between them. Sizes below the first point are interpolated
+ * from (0, 1.0) and sizes beyond the last point keep its miss ratio.
+ *
+ * Consecutive evaluations at increasing sizes (e.g., when materializing a
+ * UtilityTable) reuse the previous segment instead of searching the map.
+ */
+class MissRatioCurve {
+  /* MRC points reported by the agent */
+  std::map<uint64_t, float> const &m_kPoints;
+
+  /* First point not below the previously evaluated size */
+  mutable std::map<uint64_t, float>::const_iterator m_hint;
+
+public:
+  /**
+   * @brief Constructs a view over the given MRC points.
+   *
+   * @param kPoints MRC points, which must outlive this view
+   */
+  explicit MissRatioCurve(std::map<uint64_t, float> const &kPoints)
+      : m_kPoints(kPoints), m_hint(kPoints.begin()) {}
+
+  /**
+   * @brief Predicted miss ratio for a pool of the given size.
+   */
+  double operator()(double const kSize) const {
+    if (m_kPoints.empty()) {
+      return 1.0;
+    }
+    auto next = m_hint;
+    if (next != m_kPoints.begin() && std::prev(next)->first >= kSize) {
+      next = m_kPoints.lower_bound(static_cast<uint64_t>(kSize));
+    }
+    while (next != m_kPoints.end() && next->first < kSize) {
+      ++next;
+    }
+    m_hint = next;
+    if (next == m_kPoints.end()) {
+      return std::prev(next)->second;
+    }
+    double const kX0 =
+        next == m_kPoints.begin() ? 0.0 : std::prev(next)->first;
+    double const kY0 =
+        next == m_kPoints.begin() ? 1.0 : std::prev(next)->second;
+    if (next->first <= kX0) {
+      return next->second;
+    }
+    return kY0 + (next->second - kY0) * (kSize - kX0) / (next->first - kX0);
+  }
+
+  /**
+   * @brief Smallest size whose predicted miss ratio is at most the target.
+   *
+   * @param kMissRatio Target miss ratio
+   * @return Size in bytes, or UINT64_MAX if no point reaches the target
+   */
+  uint64_t minSizeFor(double const kMissRatio) const {
+    if (kMissRatio >= 1.0) {
+      return 0;
+    }
+    double x0 = 0.0, y0 = 1.0;
+    for (const auto &[size, missRatio] : m_kPoints) {
+      if (missRatio <= kMissRatio) {
+        return static_cast<uint64_t>(
+            y0 == missRatio ? size
+                            : x0 + (size - x0) * (y0 - kMissRatio) /
+                                       (y0 - missRatio));
+      }
+      x0 = size;
+      y0 = missRatio;
+    }
+    return std::numeric_limits<uint64_t>::max();
+  }
+};
+
+} // namespace holpaca
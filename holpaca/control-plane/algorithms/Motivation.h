@@ -1,5 +1,7 @@
 #pragma once
-#include <holpaca/control-plane/algorithms/ControlAlgorithm.h>
+#include <holpaca/control-plane/algorithms/PipelineStage.h>
+#include <string>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace holpaca {
@@ -10,18 +12,7 @@ namespace holpaca {
  * This algorithm allocates cache pool sizes based on predefined proportions.
  *
  */
-class Motivation : public ControlAlgorithm {
-
-  /**
-   * @brief Main loop executed periodically by the algorithm.
-   *
-   * This function is called by the ControlAlgorithm base class and
-   * interacts with the ProxyManager to observe or adjust cache pools.
-   *
-   * @param kProxyManager ProxyManager used to query or modify caches
-   */
-  void loop(ProxyManager *const kProxyManager) override final;
-
+class Motivation : public StagedAlgorithm {
 public:
   /**
    * @brief Constructs a Motivation algorithm instance.
@@ -31,6 +22,21 @@ public:
    */
   Motivation(ProxyManager *const kProxyManager,
              std::chrono::milliseconds const kPeriodicity);
+
+  /**
+   * @brief Name of the stage, used when reporting.
+   */
+  std::string name() const override final { return "Motivation"; }
+
+  /**
+   * @brief Proposes pool sizes proportional to the configured proportions.
+   *
+   * @param kAllCacheStatus Status of all caches, collected for the round
+   * @param allocation Sizes and floors proposed by the previous stages
+   */
+  void apply(std::unordered_map<std::string, ProxyManager::CacheStatus> const
+                 &kAllCacheStatus,
+             Allocation &allocation) override final;
 };
 
 } // namespace holpaca
@@ -1,45 +1,35 @@
 #include <holpaca/control-plane/algorithms/PerformanceMaximization.h>
 
+#include <algorithm>
 #include <cmath>
+#include <iostream>
 #include <istream>
+#include <limits>
 #include <numeric>
 
 namespace holpaca {
 
-/**
- * @brief Helper to access the nth element of a map.
- *
- * @tparam Map Map type
- * @param m Map reference
- * @param n Index of element
- * @return Reference to the nth key-value pair
- * @throws std::out_of_range if n >= m.size()
- */
-template <typename Map>
-auto getNth(Map &m, size_t n) -> typename Map::value_type & {
-  if (n >= m.size()) {
-    throw std::out_of_range("Index out of range");
-  }
-  auto it = m.begin();
-  std::advance(it, n);
-  return *it;
-}
-
 /**
  * @brief Constructs the PerformanceMaximization algorithm instance.
  */
 PerformanceMaximization::PerformanceMaximization(
     ProxyManager *const kProxyManager,
     std::chrono::milliseconds const kPeriodicity, double const kDelta,
-    bool const kFakeEnforce, uint64_t const kPrintLatenciesOnEntries)
-    : ControlAlgorithm(kProxyManager, kPeriodicity), m_kDelta(kDelta),
+    bool const kFakeEnforce, uint64_t const kPrintLatenciesOnEntries,
+    std::optional<QoSController::Gains> const &kQoSGains)
+    : StagedAlgorithm(kProxyManager, kPeriodicity), m_kDelta(kDelta),
       m_kFakeEnforce(kFakeEnforce),
-      m_printLatenciesOnEntries(kPrintLatenciesOnEntries) {}
+      m_printLatenciesOnEntries(kPrintLatenciesOnEntries) {
+  if (kQoSGains) {
+    m_qosController.emplace(*kQoSGains, m_kQoSMargin, m_kMRCMinLength);
+  }
+}
 
 /**
  * @brief Main loop of the algorithm executed periodically.
  *
- * Collects cache status, computes optimal pool sizes, and enforces resizing.
+ * Collects cache status, computes optimal pool sizes, and enforces resizing,
+ * timing each phase.
  *
  * @param kProxyManager ProxyManager instance used to query and resize caches
  */
@@ -61,161 +51,20 @@ void PerformanceMaximization::loop(ProxyManager *const kProxyManager) {
   // Compute new pool sizes
   {
     auto start = std::chrono::high_resolution_clock::now();
-
-    uint64_t totalSize = 0;
-    int pools = 0;
-    int newPools = 0;
-    uint64_t usedSpace = 0;
-    std::unordered_map<std::string, std::unordered_map<PoolId, uint64_t>>
-        newPoolSizePerCache;
-
-    // Step 1: update metrics history
-    for (const auto &[cacheId, cacheStatus] : allCacheStatus) {
-      newPoolSizePerCache[cacheId] = {};
-      totalSize += cacheStatus.m_maxSize;
-      for (const auto &[poolId, poolStatus] : cacheStatus.m_pools) {
-        if (poolStatus.m_MRC.size() < m_kMRCMinLength) {
-          newPools++;
-        }
-        pools++;
-
-        // Initialize metrics history if missing
-        if (m_poolAvgMetricsHistory[cacheId].find(poolId) ==
-            m_poolAvgMetricsHistory[cacheId].end()) {
-          m_poolAvgMetricsHistory[cacheId][poolId] =
-              PoolAvgMetrics{poolStatus.m_missRatio, poolStatus.m_diskIOPS,
-                             poolStatus.m_throughput};
-        }
-
-        // Moving average for pool metrics
-        auto &poolAvg = m_poolAvgMetricsHistory[cacheId][poolId];
-        poolAvg.m_diskIOPS =
-            poolAvg.m_diskIOPS * m_kMovingAverageParam +
-            poolStatus.m_diskIOPS * (1 - m_kMovingAverageParam);
-        poolAvg.m_missRatio =
-            poolAvg.m_missRatio * m_kMovingAverageParam +
-            poolStatus.m_missRatio * (1 - m_kMovingAverageParam);
-        poolAvg.m_throughput =
-            poolAvg.m_throughput * m_kMovingAverageParam +
-            poolStatus.m_throughput * (1 - m_kMovingAverageParam);
-      }
-    }
-
-    // Step 2: compute adjustment factors and preliminary new sizes
-    for (const auto &[cacheId, cacheStatus] : allCacheStatus) {
-      for (const auto &[poolId, poolStatus] : cacheStatus.m_pools) {
-        if (poolStatus.m_MRC.size() >= m_kMRCMinLength) {
-          usedSpace += poolStatus.m_usedSize;
-          atLeastOnePoolActive = true;
-        } else {
-          newPoolSizePerCache[cacheId][poolId] =
-              totalSize / static_cast<double>(pools);
-        }
-      }
-    }
-
-    double kAdjustmentFactor =
-        usedSpace
-            ? (totalSize - newPools * totalSize / static_cast<double>(pools)) /
-                  static_cast<double>(usedSpace)
-            : 0.0;
-    double kAdjustmentDelta =
-        (totalSize - newPools * totalSize / static_cast<double>(pools) -
-         kAdjustmentFactor * usedSpace) /
-        (pools - newPools);
-
-    // Step 3: adjust sizes for active pools
-    for (const auto &[cacheId, cacheStatus] : allCacheStatus) {
-      for (const auto &[poolId, poolStatus] : cacheStatus.m_pools) {
-        if (poolStatus.m_MRC.size() >= m_kMRCMinLength) {
-          newPoolSizePerCache[cacheId][poolId] =
-              std::max(0.0, poolStatus.m_usedSize * kAdjustmentFactor +
-                                kAdjustmentDelta);
-        }
-      }
-    }
-
-    // Step 4: build optimization context
-    Context context;
-    double aggregatedMetrics = 0.0;
-
-    for (const auto &[cacheId, cacheStatus] : allCacheStatus) {
-      std::unordered_map<PoolId, PoolConfig> poolConfigs;
-      for (const auto &[poolId, poolStatus] : cacheStatus.m_pools) {
-        if (poolStatus.m_MRC.size() >= m_kMRCMinLength) {
-          uint64_t kSize = newPoolSizePerCache[cacheId][poolId];
-          uint64_t lowerBound = static_cast<uint64_t>(
-              std::max(0.0, kSize - (totalSize * m_kDelta)));
-
-          double kAvgDiskIOPS =
-              m_poolAvgMetricsHistory[cacheId][poolId].m_diskIOPS;
-          double kAvgThroughput =
-              m_poolAvgMetricsHistory[cacheId][poolId].m_throughput;
-
-          std::vector<double> sizes, metrics;
-          for (const auto &[s, mr] : poolStatus.m_MRC) {
-            if (mr > 0.0) {
-              sizes.push_back(s);
-              metrics.push_back(-kAvgDiskIOPS / mr);
-            }
-          }
-
-          tk::spline spline(sizes, metrics, tk::spline::cspline_hermite, true);
-          double adjustment = spline(poolStatus.m_usedSize) + kAvgThroughput;
-          for (auto &m : metrics)
-            m += adjustment;
-          spline =
-              tk::spline(sizes, metrics, tk::spline::cspline_hermite, true);
-
-          if (poolStatus.m_qosLevel > 0 &&
-              poolStatus.m_qosLevel * (1 + m_kQoSMargin) > kAvgThroughput) {
-            lowerBound = kSize;
-          }
-
-          aggregatedMetrics += spline(kSize);
-
-          poolConfigs.emplace(poolId, PoolConfig{
-                                          .m_optimalSize = kSize,
-                                          .m_lowerBound = lowerBound,
-                                          .m_upperBound = static_cast<uint64_t>(
-                                              kSize + (totalSize * m_kDelta)),
-                                          .m_utilityCurve = std::move(spline),
-                                      });
+    Allocation allocation(allCacheStatus);
+    apply(allCacheStatus, allocation);
+    cacheResizes = allocation.resizes();
+
+    for (auto &cacheResize : cacheResizes) {
+      auto const &kPools = allCacheStatus[cacheResize.m_kName].m_pools;
+      for (auto &poolResize : cacheResize.m_kPoolResizes) {
+        auto const &kPoolStatus = kPools.at(poolResize.m_kId);
+        atLeastOnePoolActive |= kPoolStatus.m_MRC.size() >= m_kMRCMinLength;
+        if (m_kFakeEnforce) {
+          poolResize.m_kSize = kPoolStatus.m_maxSize;
         }
       }
-      if (!poolConfigs.empty()) {
-        context.m_cacheConfigs.emplace(cacheId, CacheConfig{poolConfigs});
-      }
     }
-
-    // Run optimization
-    double avgMetrics = context.m_cacheConfigs.empty()
-                            ? 0.0
-                            : aggregatedMetrics / context.m_cacheConfigs.size();
-    context.run(2000, 250, 0 /*ignored*/, avgMetrics, 90, 0.1, 1.003);
-
-    // Update new pool sizes after optimization
-    for (auto const &[cacheId, cacheConfig] : context.m_cacheConfigs) {
-      for (auto const &[poolId, poolConfig] : cacheConfig.m_poolConfigs) {
-        newPoolSizePerCache[cacheId][poolId] = poolConfig.m_optimalSize;
-      }
-    }
-
-    // Prepare CacheResize instructions
-    for (const auto &[cacheId, pools] : newPoolSizePerCache) {
-      std::vector<ProxyManager::PoolResize> poolResizes;
-      for (const auto &[poolId, size] : pools) {
-        poolResizes.emplace_back(ProxyManager::PoolResize{
-            .m_kId = poolId,
-            .m_kSize =
-                m_kFakeEnforce
-                    ? allCacheStatus[cacheId].m_pools.at(poolId).m_maxSize
-                    : size});
-      }
-      cacheResizes.emplace_back(ProxyManager::CacheResize{
-          .m_kName = cacheId, .m_kPoolResizes = poolResizes});
-    }
-
     compute = std::chrono::high_resolution_clock::now() - start;
   }
 
@@ -242,16 +91,224 @@ void PerformanceMaximization::loop(ProxyManager *const kProxyManager) {
   }
 }
 
+/**
+ * @brief Computes the optimal pool sizes and proposes them.
+ *
+ * Floors raised by earlier stages are treated like QoS floors: pools below
+ * them are grown first, and the optimizer never shrinks them back.
+ *
+ * @param kAllCacheStatus Status of all caches, collected for the round
+ * @param allocation Sizes and floors proposed by the previous stages
+ */
+void PerformanceMaximization::apply(
+    std::unordered_map<std::string, ProxyManager::CacheStatus> const
+        &kAllCacheStatus,
+    Allocation &allocation) {
+  uint64_t totalSize = 0;
+  int pools = 0;
+  int newPools = 0;
+  uint64_t usedSpace = 0;
+  std::unordered_map<std::string, std::unordered_map<PoolId, uint64_t>>
+      newPoolSizePerCache;
+
+  // Step 1: update metrics history
+  for (const auto &[cacheId, cacheStatus] : kAllCacheStatus) {
+    newPoolSizePerCache[cacheId] = {};
+    totalSize += cacheStatus.m_maxSize;
+    for (const auto &[poolId, poolStatus] : cacheStatus.m_pools) {
+      if (poolStatus.m_MRC.size() < m_kMRCMinLength) {
+        newPools++;
+      }
+      pools++;
+
+      // Initialize metrics history if missing
+      if (m_poolAvgMetricsHistory[cacheId].find(poolId) ==
+          m_poolAvgMetricsHistory[cacheId].end()) {
+        m_poolAvgMetricsHistory[cacheId][poolId] =
+            PoolAvgMetrics{poolStatus.m_missRatio, poolStatus.m_diskIOPS,
+                           poolStatus.m_throughput};
+      }
+
+      // Moving average for pool metrics
+      auto &poolAvg = m_poolAvgMetricsHistory[cacheId][poolId];
+      poolAvg.m_diskIOPS =
+          poolAvg.m_diskIOPS * m_kMovingAverageParam +
+          poolStatus.m_diskIOPS * (1 - m_kMovingAverageParam);
+      poolAvg.m_missRatio =
+          poolAvg.m_missRatio * m_kMovingAverageParam +
+          poolStatus.m_missRatio * (1 - m_kMovingAverageParam);
+      poolAvg.m_throughput =
+          poolAvg.m_throughput * m_kMovingAverageParam +
+          poolStatus.m_throughput * (1 - m_kMovingAverageParam);
+    }
+  }
+
+  // Step 2: compute adjustment factors and preliminary new sizes
+  for (const auto &[cacheId, cacheStatus] : kAllCacheStatus) {
+    for (const auto &[poolId, poolStatus] : cacheStatus.m_pools) {
+      if (poolStatus.m_MRC.size() >= m_kMRCMinLength) {
+        usedSpace += poolStatus.m_usedSize;
+      } else {
+        newPoolSizePerCache[cacheId][poolId] =
+            totalSize / static_cast<double>(pools);
+      }
+    }
+  }
+
+  double kAdjustmentFactor =
+      usedSpace
+          ? (totalSize - newPools * totalSize / static_cast<double>(pools)) /
+                static_cast<double>(usedSpace)
+          : 0.0;
+  double kAdjustmentDelta =
+      (totalSize - newPools * totalSize / static_cast<double>(pools) -
+       kAdjustmentFactor * usedSpace) /
+      (pools - newPools);
+
+  // Step 3: adjust sizes for active pools
+  for (const auto &[cacheId, cacheStatus] : kAllCacheStatus) {
+    for (const auto &[poolId, poolStatus] : cacheStatus.m_pools) {
+      if (poolStatus.m_MRC.size() >= m_kMRCMinLength) {
+        newPoolSizePerCache[cacheId][poolId] =
+            std::max(0.0, poolStatus.m_usedSize * kAdjustmentFactor +
+                              kAdjustmentDelta);
+      }
+    }
+  }
+
+  // Step 3b: grow pools below their QoS level (or below the floor set by an
+  // earlier stage), funded by everyone else
+  QoSController::Sizes floors, activeSizes;
+  if (m_qosController) {
+    floors = m_qosController->floors(kAllCacheStatus);
+  }
+  for (const auto &[cacheId, cacheStatus] : kAllCacheStatus) {
+    for (const auto &[poolId, poolStatus] : cacheStatus.m_pools) {
+      if (poolStatus.m_MRC.size() >= m_kMRCMinLength) {
+        activeSizes[cacheId][poolId] = newPoolSizePerCache[cacheId][poolId];
+        auto &floor = floors[cacheId][poolId];
+        floor = std::max(floor, allocation.floor(cacheId, poolId));
+      }
+    }
+  }
+  if (!QoSController::fund(activeSizes, floors)) {
+    std::cerr << "PerformanceMaximization: QoS floors exceed the "
+                 "available memory"
+              << std::endl;
+  }
+  for (const auto &[cacheId, pools] : activeSizes) {
+    for (const auto &[poolId, size] : pools) {
+      newPoolSizePerCache[cacheId][poolId] = size;
+    }
+  }
+
+  // Step 4: build optimization context
+  Context context;
+  double aggregatedMetrics = 0.0;
+
+  for (const auto &[cacheId, cacheStatus] : kAllCacheStatus) {
+    CacheConfig cacheConfig{.m_id = cacheId,
+                            .m_firstPool = context.m_poolConfigs.size()};
+    for (const auto &[poolId, poolStatus] : cacheStatus.m_pools) {
+      if (poolStatus.m_MRC.size() >= m_kMRCMinLength) {
+        uint64_t kSize = newPoolSizePerCache[cacheId][poolId];
+        uint64_t lowerBound = static_cast<uint64_t>(
+            std::max(0.0, kSize - (totalSize * m_kDelta)));
+        uint64_t const kUpperBound =
+            static_cast<uint64_t>(kSize + (totalSize * m_kDelta));
+
+        double kAvgDiskIOPS =
+            m_poolAvgMetricsHistory[cacheId][poolId].m_diskIOPS;
+        double kAvgThroughput =
+            m_poolAvgMetricsHistory[cacheId][poolId].m_throughput;
+
+        // Plan for the forecast load, scaling the backend load alike
+        double kPlannedThroughput = kAvgThroughput;
+        if (!std::isnan(poolStatus.m_predictedThroughput)) {
+          kPlannedThroughput = poolStatus.m_predictedThroughput;
+          if (kAvgThroughput > 0) {
+            kAvgDiskIOPS *= kPlannedThroughput / kAvgThroughput;
+          }
+        }
+
+        std::vector<double> sizes, metrics;
+        for (const auto &[s, mr] : poolStatus.m_MRC) {
+          if (mr > 0.0) {
+            sizes.push_back(s);
+            metrics.push_back(-kAvgDiskIOPS / mr);
+          }
+        }
+
+        tk::spline spline(sizes, metrics, tk::spline::cspline_hermite, true);
+        double adjustment =
+            spline(poolStatus.m_usedSize) + kPlannedThroughput;
+        for (auto &m : metrics)
+          m += adjustment;
+        spline =
+            tk::spline(sizes, metrics, tk::spline::cspline_hermite, true);
+
+        if (poolStatus.m_qosLevel > 0 &&
+            poolStatus.m_qosLevel * (1 + m_kQoSMargin) > kAvgThroughput) {
+          lowerBound = kSize;
+        }
+
+        // Never let the optimizer (nor later stages) take back what the QoS
+        // controller granted
+        uint64_t const kGranted = std::min(kSize, floors[cacheId][poolId]);
+        lowerBound = std::max(lowerBound, kGranted);
+        allocation.raiseFloor(cacheId, poolId, kGranted);
+
+        // Materialize the utility curve over the pool's feasible range
+        size_t const kCurve =
+            context.m_utilityTable.add(spline, lowerBound, kUpperBound);
+        aggregatedMetrics += context.m_utilityTable(kCurve, kSize);
+
+        context.m_poolConfigs.emplace_back(PoolConfig{
+            .m_id = poolId,
+            .m_lowerBound = lowerBound,
+            .m_upperBound = kUpperBound,
+        });
+        context.m_optimalSizes.push_back(kSize);
+        cacheConfig.m_numPools++;
+      }
+    }
+    if (cacheConfig.m_numPools > 0) {
+      context.m_cacheConfigs.emplace_back(std::move(cacheConfig));
+    }
+  }
+
+  // Run optimization
+  double avgMetrics = context.m_cacheConfigs.empty()
+                          ? 0.0
+                          : aggregatedMetrics / context.m_cacheConfigs.size();
+  context.run(2000, 250, 0 /*ignored*/, avgMetrics, 90, 0.1, 1.003);
+
+  // Propose the new pool sizes (and their predicted gains)
+  for (const auto &[cacheId, pools] : newPoolSizePerCache) {
+    for (const auto &[poolId, size] : pools) {
+      allocation.propose(cacheId, poolId, size);
+    }
+  }
+  for (auto const &cacheConfig : context.m_cacheConfigs) {
+    for (size_t i = cacheConfig.m_firstPool;
+         i < cacheConfig.m_firstPool + cacheConfig.m_numPools; i++) {
+      PoolId const kPoolId = context.m_poolConfigs[i].m_id;
+      uint64_t const kCurrentSize =
+          kAllCacheStatus.at(cacheConfig.m_id).m_pools.at(kPoolId).m_maxSize;
+      allocation.propose(cacheConfig.m_id, kPoolId, context.m_optimalSizes[i],
+                         context.m_utilityTable.delta(
+                             i, kCurrentSize, context.m_optimalSizes[i]));
+    }
+  }
+}
+
 /**
  * @brief Determines if the context should skip optimization.
  *
  * @return True if there are no pools to optimize
  */
 bool PerformanceMaximization::Context::skip() const {
-  return std::accumulate(m_cacheConfigs.begin(), m_cacheConfigs.end(), 0,
-                         [](int acc, const auto &ccit) {
-                           return acc + ccit.second.m_poolConfigs.size();
-                         }) == 0;
+  return m_poolConfigs.empty();
 }
 
 /**
@@ -262,28 +319,30 @@ void PerformanceMaximization::Context::step(
   // Pick two random caches
   int cacheIdx1 = randomUniformInt(m_cacheConfigs.size());
   int cacheIdx2 = randomUniformInt(m_cacheConfigs.size());
-  auto &[cache1Id, cache1] = getNth(m_cacheConfigs, cacheIdx1);
-  auto &[cache2Id, cache2] = getNth(m_cacheConfigs, cacheIdx2);
+  auto const &cache1 = m_cacheConfigs[cacheIdx1];
+  auto const &cache2 = m_cacheConfigs[cacheIdx2];
 
   // Pick pools within caches
-  int poolIdx1 = randomUniformInt(cache1.m_poolConfigs.size());
+  int poolIdx1 = randomUniformInt(cache1.m_numPools);
   int poolIdx2 =
       (cacheIdx1 != cacheIdx2)
-          ? randomUniformInt(cache2.m_poolConfigs.size())
-          : (poolIdx1 + 1 + randomUniformInt(cache2.m_poolConfigs.size() - 1)) %
-                cache2.m_poolConfigs.size();
+          ? randomUniformInt(cache2.m_numPools)
+          : (poolIdx1 + 1 + randomUniformInt(cache2.m_numPools - 1)) %
+                cache2.m_numPools;
 
-  auto &[pool1Id, pool1] = getNth(cache1.m_poolConfigs, poolIdx1);
-  auto &[pool2Id, pool2] = getNth(cache2.m_poolConfigs, poolIdx2);
+  size_t const kPool1 = cache1.m_firstPool + poolIdx1;
+  size_t const kPool2 = cache2.m_firstPool + poolIdx2;
+  auto &pool1Size = m_optimalSizes[kPool1];
+  auto &pool2Size = m_optimalSizes[kPool2];
 
   // Trade a random amount of space within bounds
-  int maxDelta = std::min({pool1.m_optimalSize - pool1.m_lowerBound,
-                           pool2.m_upperBound - pool2.m_optimalSize});
+  int maxDelta = std::min({pool1Size - m_poolConfigs[kPool1].m_lowerBound,
+                           m_poolConfigs[kPool2].m_upperBound - pool2Size});
 
   if (maxDelta > 0) {
     int delta = randomUniformInt(maxDelta);
-    pool1.m_optimalSize -= delta;
-    pool2.m_optimalSize += delta;
+    pool1Size -= delta;
+    pool2Size += delta;
   }
 }
 
@@ -293,15 +352,7 @@ void PerformanceMaximization::Context::step(
  * @return Energy value
  */
 double PerformanceMaximization::Context::energy() const {
-  return std::accumulate(
-      m_cacheConfigs.begin(), m_cacheConfigs.end(), 0.0,
-      [](double acc, const auto &ccit) {
-        return acc + std::accumulate(ccit.second.m_poolConfigs.begin(),
-                                     ccit.second.m_poolConfigs.end(), 0.0,
-                                     [](double acc, const auto &pcit) {
-                                       return acc + pcit.second.getMetric();
-                                     });
-      });
+  return m_utilityTable.sum(m_optimalSizes.data());
 }
 
 /**
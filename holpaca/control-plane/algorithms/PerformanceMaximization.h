@@ -1,13 +1,16 @@
 #pragma once
 #include <holpaca/control-plane/ProxyManager.h>
-#include <holpaca/control-plane/algorithms/ControlAlgorithm.h>
 #include <holpaca/control-plane/algorithms/Optimizable.h>
+#include <holpaca/control-plane/algorithms/PipelineStage.h>
+#include <holpaca/control-plane/algorithms/QoSController.h>
 #include <holpaca/control-plane/algorithms/Spline.h>
+#include <holpaca/control-plane/algorithms/UtilityTable.h>
 
 #include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <iostream>
+#include <optional>
 #include <string>
 #include <thread>
 #include <unordered_map>
@@ -21,42 +24,46 @@ namespace holpaca {
  * performance.
  *
  * Uses historical metrics, QoS margins, and a utility curve to compute optimal
- * pool allocations for each cache.
+ * pool allocations for each cache. When a QoSController is configured, pools
+ * below their QoS level are first grown to the size it requires, and only the
+ * remaining memory is optimized.
  */
-class PerformanceMaximization : public ControlAlgorithm {
+class PerformanceMaximization : public StagedAlgorithm {
 
 private:
   /**
    * @brief Configuration for a single memory pool.
    *
-   * Stores bounds, (current) optimal size, and the utility curve for the pool.
+   * Stores the pool bounds. Its current optimal size and utility curve live in
+   * the Context, at the same position as the configuration.
    */
   struct PoolConfig {
-    uint64_t m_optimalSize;    /* Optimal size computed for the pool */
-    uint64_t m_lowerBound{0};  /* Minimum allowed size */
-    uint64_t m_upperBound{0};  /* Maximum allowed size */
-    tk::spline m_utilityCurve; /* Utility curve mapping size -> performance */
-
-    /* Compute performance metric at current optimal size */
-    double getMetric() const { return m_utilityCurve(m_optimalSize); };
+    PoolId m_id;              /* Pool ID */
+    uint64_t m_lowerBound{0}; /* Minimum allowed size */
+    uint64_t m_upperBound{0}; /* Maximum allowed size */
   };
 
   /**
    * @brief Configuration for a single cache, containing multiple pools.
    */
   struct CacheConfig {
-    std::unordered_map<PoolId, PoolConfig>
-        m_poolConfigs{}; /* Pool configurations */
+    std::string m_id;     /* Cache name (agent address) */
+    size_t m_firstPool;   /* Position of the cache's first pool */
+    size_t m_numPools{0}; /* Number of pools of the cache */
   };
 
   /**
    * @brief Optimization context used by the algorithm.
    *
    * Inherits from Optimizable for gradient-like optimization of pool sizes.
+   * Pools are stored contiguously and grouped by cache, so that the energy is
+   * a single batch evaluation of the utility table.
    */
   struct Context : public Optimizable<Context> {
-    std::unordered_map<std::string, CacheConfig>
-        m_cacheConfigs; /* Cache configurations */
+    std::vector<CacheConfig> m_cacheConfigs; /* Cache configurations */
+    std::vector<PoolConfig> m_poolConfigs;   /* Pool configurations */
+    std::vector<uint64_t> m_optimalSizes;    /* Optimal size of each pool */
+    UtilityTable m_utilityTable;             /* Size -> performance curves */
 
     void
     step(double const kStepSize) override final; /* Take an optimization step */
@@ -75,6 +82,9 @@ private:
   /* Margin applied for QoS constraints */
   double const m_kQoSMargin{0.10};
 
+  /* Controller sizing pools below their QoS level (disabled if empty) */
+  std::optional<QoSController> m_qosController;
+
   /* FOR OVERHEAD MEASUREMENTS ONLY:
    * Whether to fake enforcement (simulate resizing without actual effect) */
   bool const m_kFakeEnforce{false};
@@ -106,7 +116,7 @@ private:
   /* Parameter for moving average of metrics */
   const double m_kMovingAverageParam{0.3};
 
-  /* Main algorithm loop executed periodically */
+  /* Main algorithm loop executed periodically (timing each phase) */
   void loop(ProxyManager *const kProxyManager) override final;
 
 public:
@@ -120,11 +130,37 @@ public:
    *    Whether to simulate resizing without enforcement
    * @param kPrintLatenciesOnEntries FOR OVERHEAD MEASUREMENTS ONLY:
    *    Threshold of entries to print latencies
+   * @param kQoSGains Gains of the QoS controller (no controller if empty)
+   */
+  PerformanceMaximization(
+      ProxyManager *const kProxyManager,
+      std::chrono::milliseconds const kPeriodicity, double const kDelta,
+      bool const kFakeEnforce, uint64_t const kPrintLatenciesOnEntries,
+      std::optional<QoSController::Gains> const &kQoSGains = std::nullopt);
+
+  /**
+   * @brief Name of the stage, used when reporting.
+   */
+  std::string name() const override final {
+    return "PerformanceMaximization";
+  }
+
+  /**
+   * @brief Whether a QoS controller was configured.
+   */
+  bool controlsQoS() const override final {
+    return m_qosController.has_value();
+  }
+
+  /**
+   * @brief Computes the optimal pool sizes and proposes them.
+   *
+   * @param kAllCacheStatus Status of all caches, collected for the round
+   * @param allocation Sizes and floors proposed by the previous stages
    */
-  PerformanceMaximization(ProxyManager *const kProxyManager,
-                          std::chrono::milliseconds const kPeriodicity,
-                          double const kDelta, bool const kFakeEnforce,
-                          uint64_t const kPrintLatenciesOnEntries);
+  void apply(std::unordered_map<std::string, ProxyManager::CacheStatus> const
+                 &kAllCacheStatus,
+             Allocation &allocation) override final;
 };
 
 } // namespace holpaca
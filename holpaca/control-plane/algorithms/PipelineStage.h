@@ -0,0 +1,73 @@
+#pragma once
+#include <holpaca/control-plane/ProxyManager.h>
+#include <holpaca/control-plane/algorithms/Allocation.h>
+#include <holpaca/control-plane/algorithms/ControlAlgorithm.h>
+
+#include <string>
+#include <unordered_map>
+
+namespace holpaca {
+
+/**
+ * @brief Step of a control round that refines a proposed allocation.
+ *
+ * Stages never talk to the caches themselves: they read the status
+ * collected for the round and update the shared Allocation, which is
+ * enforced once after the last stage (see ControlPipeline).
+ */
+class PipelineStage {
+public:
+  virtual ~PipelineStage() = default;
+
+  /**
+   * @brief Name of the stage, used when reporting.
+   */
+  virtual std::string name() const = 0;
+
+  /**
+   * @brief Whether the stage runs a QoSController of its own (at most one
+   * stage of a pipeline may, so that pools follow a single controller).
+   */
+  virtual bool controlsQoS() const { return false; }
+
+  /**
+   * @brief Refines the proposed allocation.
+   *
+   * @param kAllCacheStatus Status of all caches, collected for the round
+   * @param allocation Sizes and floors proposed by the previous stages
+   */
+  virtual void
+  apply(std::unordered_map<std::string, ProxyManager::CacheStatus> const
+            &kAllCacheStatus,
+        Allocation &allocation) = 0;
+};
+
+/**
+ * @brief Control algorithm made of a single pipeline stage.
+ *
+ * Runs stand-alone by collecting the status, applying itself to the current
+ * sizes, and enforcing the result when it proposed anything; it can also be
+ * appended to a ControlPipeline, in which case it is never started.
+ */
+class StagedAlgorithm : public ControlAlgorithm, public PipelineStage {
+protected:
+  /**
+   * @brief Collects the status, applies the stage, and enforces its
+   * proposal.
+   *
+   * @param kProxyManager ProxyManager used to interact with caches
+   */
+  void loop(ProxyManager *const kProxyManager) override {
+    auto const kAllCacheStatus = kProxyManager->getStatus();
+    Allocation allocation(kAllCacheStatus);
+    apply(kAllCacheStatus, allocation);
+    if (allocation.proposed()) {
+      kProxyManager->resize(allocation.resizes());
+    }
+  }
+
+public:
+  using ControlAlgorithm::ControlAlgorithm;
+};
+
+} // namespace holpaca
@@ -0,0 +1,125 @@
+#include <holpaca/control-plane/algorithms/MissRatioCurve.h>
+#include <holpaca/control-plane/algorithms/QoSController.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace holpaca {
+
+/**
+ * @brief Constructs a QoS controller.
+ */
+QoSController::QoSController(Gains const &kGains, double const kMargin,
+                             uint32_t const kMRCMinLength)
+    : m_kGains(kGains), m_kMargin(kMargin), m_kMRCMinLength(kMRCMinLength) {}
+
+/**
+ * @brief Memory each pool with a QoS level needs to meet it.
+ *
+ * The required size is the feed-forward estimate plus the PID correction,
+ * clamped to [0, cache capacity].
+ *
+ * @param kAllCacheStatus Status of all caches
+ * @return Required size (bytes) of each controlled pool, per cache
+ */
+QoSController::Sizes QoSController::floors(
+    std::unordered_map<std::string, ProxyManager::CacheStatus> const
+        &kAllCacheStatus) {
+  Sizes floors;
+  auto const kNow = std::chrono::steady_clock::now();
+
+  for (const auto &[cacheId, cacheStatus] : kAllCacheStatus) {
+    for (const auto &[poolId, poolStatus] : cacheStatus.m_pools) {
+      if (poolStatus.m_qosLevel <= 0 ||
+          poolStatus.m_MRC.size() < m_kMRCMinLength) {
+        continue;
+      }
+
+      double const kTarget = poolStatus.m_qosLevel * (1 + m_kMargin);
+      double const kCapacity = cacheStatus.m_maxSize;
+
+      // Feed-forward: miss ratio reaching the target at a constant miss rate
+      uint64_t feedForward = poolStatus.m_maxSize;
+      if (poolStatus.m_throughput > 0 && poolStatus.m_missRatio > 0) {
+        double const kMissRatio = std::min(
+            1.0, poolStatus.m_missRatio * poolStatus.m_throughput / kTarget);
+        feedForward = std::min<uint64_t>(
+            MissRatioCurve(poolStatus.m_MRC).minSizeFor(kMissRatio),
+            cacheStatus.m_maxSize);
+      }
+
+      // Feedback on the relative throughput deficit
+      auto [it, inserted] = m_poolStates[cacheId].try_emplace(poolId);
+      auto &state = it->second;
+      double const kError = (kTarget - poolStatus.m_throughput) / kTarget;
+      double const kElapsed =
+          inserted ? 0.0
+                   : std::chrono::duration<double>(kNow - state.m_lastUpdate)
+                         .count();
+
+      double const kDerivative =
+          kElapsed > 0 ? (kError - state.m_previousError) / kElapsed : 0.0;
+      double const kIntegral = state.m_integral + kError * kElapsed;
+      double const kOutput =
+          feedForward + kCapacity * (m_kGains.m_kp * kError +
+                                     m_kGains.m_ki * kIntegral +
+                                     m_kGains.m_kd * kDerivative);
+
+      // Anti-windup: stop integrating while saturated in the error direction
+      bool const kSaturated = (kOutput >= kCapacity && kError > 0) ||
+                              (kOutput <= 0.0 && kError < 0);
+      if (!kSaturated) {
+        state.m_integral = kIntegral;
+      }
+      state.m_previousError = kError;
+      state.m_lastUpdate = kNow;
+
+      floors[cacheId][poolId] =
+          static_cast<uint64_t>(std::clamp(kOutput, 0.0, kCapacity));
+    }
+  }
+
+  return floors;
+}
+
+/**
+ * @brief Grows the pools below their floor, funded by the pools above it.
+ *
+ * @param sizes Size of each pool, updated in place
+ * @param kFloors Floor of each pool in sizes (missing floors are 0)
+ * @return False if the slack fell short of the deficit
+ */
+bool QoSController::fund(Sizes &sizes, Sizes const &kFloors) {
+  auto floor = [&](std::string const &kCacheId, PoolId const kPoolId) {
+    auto const kCache = kFloors.find(kCacheId);
+    if (kCache == kFloors.end()) {
+      return uint64_t{0};
+    }
+    auto const kPool = kCache->second.find(kPoolId);
+    return kPool == kCache->second.end() ? uint64_t{0} : kPool->second;
+  };
+
+  double deficit = 0.0, slack = 0.0;
+  for (const auto &[cacheId, pools] : sizes) {
+    for (const auto &[poolId, size] : pools) {
+      double const kSize = size;
+      double const kFloor = floor(cacheId, poolId);
+      (kSize < kFloor ? deficit : slack) += std::fabs(kSize - kFloor);
+    }
+  }
+  double const kMoved = std::min(deficit, slack);
+  double const kGrowScale = deficit > 0 ? kMoved / deficit : 0.0;
+  double const kShrinkScale = slack > 0 ? kMoved / slack : 0.0;
+
+  for (auto &[cacheId, pools] : sizes) {
+    for (auto &[poolId, size] : pools) {
+      uint64_t const kFloor = floor(cacheId, poolId);
+      size = static_cast<uint64_t>(
+          size < kFloor ? size + (kFloor - size) * kGrowScale
+                        : size - (size - kFloor) * kShrinkScale);
+    }
+  }
+  return deficit <= slack;
+}
+
+} // namespace holpaca
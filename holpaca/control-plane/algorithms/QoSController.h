@@ -0,0 +1,101 @@
+#pragma once
+#include <holpaca/control-plane/ProxyManager.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace holpaca {
+
+/**
+ * @brief Feedback controller sizing pools to meet their throughput floors.
+ *
+ * For every pool with a QoS level, the relative throughput deficit
+ * (target - throughput) / target is the error signal of a PID law whose
+ * output is expressed as a fraction of the cache capacity. It corrects a
+ * feed-forward estimate taken from the MRC: assuming the backend sustains a
+ * constant miss rate, reaching the target throughput requires the miss ratio
+ * to shrink by the ratio between current and target throughput.
+ *
+ * The integral term only accumulates while the output is not saturated in
+ * the direction of the error (conditional integration), so a pool that
+ * cannot be satisfied does not wind up and overshoot once it can.
+ */
+class QoSController {
+public:
+  /**
+   * @brief Size (bytes) of some pools, per cache.
+   */
+  using Sizes =
+      std::unordered_map<std::string, std::unordered_map<PoolId, uint64_t>>;
+
+  /**
+   * @brief Gains of the PID law.
+   */
+  struct Gains {
+    double m_kp{0.5}; /* Proportional gain */
+    double m_ki{0.1}; /* Integral gain (per second) */
+    double m_kd{0.0}; /* Derivative gain (seconds) */
+  };
+
+private:
+  /**
+   * @brief Controller state of a single pool.
+   */
+  struct PoolState {
+    double m_integral{0.0};      /* Integrated error (seconds) */
+    double m_previousError{0.0}; /* Error of the previous update */
+    std::chrono::steady_clock::time_point m_lastUpdate{}; /* Last update */
+  };
+
+  /* Gains of the PID law */
+  Gains const m_kGains;
+
+  /* Margin applied to the QoS levels */
+  double const m_kMargin;
+
+  /* Minimum MRC length to control a pool */
+  uint32_t const m_kMRCMinLength;
+
+  /* Controller state of each pool, per cache */
+  std::unordered_map<std::string, std::unordered_map<PoolId, PoolState>>
+      m_poolStates;
+
+public:
+  /**
+   * @brief Constructs a QoS controller.
+   *
+   * @param kGains Gains of the PID law
+   * @param kMargin Margin applied to the QoS levels (e.g., 0.1 for 10%)
+   * @param kMRCMinLength Minimum MRC length to control a pool
+   */
+  QoSController(Gains const &kGains, double const kMargin,
+                uint32_t const kMRCMinLength);
+
+  /**
+   * @brief Memory each pool with a QoS level needs to meet it.
+   *
+   * Advances the controller of every such pool by one step.
+   *
+   * @param kAllCacheStatus Status of all caches
+   * @return Required size (bytes) of each controlled pool, per cache
+   */
+  Sizes floors(std::unordered_map<std::string, ProxyManager::CacheStatus> const
+                   &kAllCacheStatus);
+
+  /**
+   * @brief Grows the pools below their floor, funded by the pools above it.
+   *
+   * The memory missing below the floors (deficit) is taken from the memory
+   * above them (slack), proportionally to each pool's share of the slack. If
+   * the slack falls short, every deficit is covered by the same fraction.
+   *
+   * @param sizes Size of each pool, updated in place
+   * @param kFloors Floor of each pool in sizes (missing floors are 0)
+   * @return False if the slack fell short of the deficit
+   */
+  static bool fund(Sizes &sizes, Sizes const &kFloors);
+};
+
+} // namespace holpaca
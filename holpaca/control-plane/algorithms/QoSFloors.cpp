@@ -0,0 +1,56 @@
+#include <holpaca/control-plane/algorithms/QoSFloors.h>
+
+#include <algorithm>
+#include <iostream>
+
+namespace holpaca {
+
+/**
+ * @brief Constructs the QoSFloors algorithm instance.
+ */
+QoSFloors::QoSFloors(ProxyManager *const kProxyManager,
+                     std::chrono::milliseconds const kPeriodicity,
+                     QoSController::Gains const &kGains)
+    : StagedAlgorithm(kProxyManager, kPeriodicity),
+      m_qosController(kGains, m_kQoSMargin, m_kMRCMinLength) {}
+
+/**
+ * @brief Raises the floors to the QoS requirements and grows the pools below
+ * them, funded by the memory above the floors (see QoSController::fund).
+ *
+ * @param kAllCacheStatus Status of all caches, collected for the round
+ * @param allocation Sizes and floors proposed by the previous stages
+ */
+void QoSFloors::apply(
+    std::unordered_map<std::string, ProxyManager::CacheStatus> const
+        &kAllCacheStatus,
+    Allocation &allocation) {
+  auto floors = m_qosController.floors(kAllCacheStatus);
+  QoSController::Sizes sizes;
+  for (const auto &[cacheId, pools] : allocation.pools()) {
+    for (const auto &[poolId, pool] : pools) {
+      sizes[cacheId][poolId] = pool.m_size;
+      auto &floor = floors[cacheId][poolId];
+      floor = std::max(floor, allocation.floor(cacheId, poolId));
+    }
+  }
+  if (!QoSController::fund(sizes, floors)) {
+    std::cerr << "QoSFloors: QoS floors exceed the available memory"
+              << std::endl;
+  }
+
+  // Floors are raised only up to what the pools actually get, so that later
+  // stages do not overcommit the memory when the slack falls short
+  for (const auto &[cacheId, pools] : sizes) {
+    for (const auto &[poolId, size] : pools) {
+      bool const kResized = size != allocation.size(cacheId, poolId);
+      allocation.raiseFloor(cacheId, poolId,
+                            std::min(floors[cacheId][poolId], size));
+      if (kResized) {
+        allocation.propose(cacheId, poolId, size);
+      }
+    }
+  }
+}
+
+} // namespace holpaca
@@ -0,0 +1,67 @@
+#pragma once
+#include <holpaca/control-plane/ProxyManager.h>
+#include <holpaca/control-plane/algorithms/PipelineStage.h>
+#include <holpaca/control-plane/algorithms/QoSController.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace holpaca {
+
+/**
+ * @brief Control algorithm that only keeps pools at their QoS level.
+ *
+ * Every round, a QoSController computes the memory each pool with a QoS
+ * level needs to meet it. That memory becomes the pool's floor, so later
+ * stages of a pipeline never take it back, and pools below their floor are
+ * grown, funded proportionally by the memory the other pools hold above
+ * theirs.
+ */
+class QoSFloors : public StagedAlgorithm {
+
+  /* Minimum MRC length to control a pool */
+  const uint32_t m_kMRCMinLength{3};
+
+  /* Margin applied for QoS constraints */
+  double const m_kQoSMargin{0.10};
+
+  /* Controller sizing pools below their QoS level */
+  QoSController m_qosController;
+
+public:
+  /**
+   * @brief Constructs a QoSFloors algorithm instance.
+   *
+   * @param kProxyManager Pointer to ProxyManager for resizing pools
+   * @param kPeriodicity Time between control iterations
+   * @param kGains Gains of the QoS controller
+   */
+  QoSFloors(ProxyManager *const kProxyManager,
+            std::chrono::milliseconds const kPeriodicity,
+            QoSController::Gains const &kGains);
+
+  /**
+   * @brief Name of the stage, used when reporting.
+   */
+  std::string name() const override final { return "QoSFloors"; }
+
+  /**
+   * @brief Always runs its QoS controller.
+   */
+  bool controlsQoS() const override final { return true; }
+
+  /**
+   * @brief Raises the floors to the QoS requirements and grows the pools
+   * below them.
+   *
+   * @param kAllCacheStatus Status of all caches, collected for the round
+   * @param allocation Sizes and floors proposed by the previous stages
+   */
+  void apply(std::unordered_map<std::string, ProxyManager::CacheStatus> const
+                 &kAllCacheStatus,
+             Allocation &allocation) override final;
+};
+
+} // namespace holpaca
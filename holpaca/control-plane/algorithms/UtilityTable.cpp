@@ -0,0 +1,53 @@
+#include <holpaca/control-plane/algorithms/UtilityTable.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace holpaca {
+
+/**
+ * @brief Sums the utility of every curve at the given sizes.
+ *
+ * The AVX2 kernel processes four curves per iteration: it computes the entry
+ * index of each size, clamps it to the curve length, and gathers the four
+ * values at once. The remaining curves are handled by the scalar path.
+ */
+double UtilityTable::sum(uint64_t const *kSizes) const {
+  size_t const kCurves = size();
+  size_t i = 0;
+  double total = 0.0;
+
+#if defined(__AVX2__)
+  __m256d acc = _mm256_setzero_pd();
+  __m256i const kOne = _mm256_set1_epi64x(1);
+
+  for (; i + 4 <= kCurves; i += 4) {
+    auto load = [i](std::vector<uint64_t> const &v) {
+      return _mm256_loadu_si256(reinterpret_cast<__m256i const *>(&v[i]));
+    };
+    __m256i const kSize =
+        _mm256_loadu_si256(reinterpret_cast<__m256i const *>(kSizes + i));
+    __m256i const kLast = _mm256_sub_epi64(load(m_lengths), kOne);
+
+    __m256i step =
+        _mm256_srli_epi64(_mm256_sub_epi64(kSize, load(m_lowerBounds)),
+                          kStepBits);
+    step = _mm256_blendv_epi8(step, kLast, _mm256_cmpgt_epi64(step, kLast));
+
+    __m256i const kIndex = _mm256_add_epi64(load(m_offsets), step);
+    acc = _mm256_add_pd(acc, _mm256_i64gather_pd(m_values.data(), kIndex, 8));
+  }
+
+  alignas(32) double lanes[4];
+  _mm256_store_pd(lanes, acc);
+  total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+
+  for (; i < kCurves; i++) {
+    total += m_values[index(i, kSizes[i])];
+  }
+  return total;
+}
+
+} // namespace holpaca
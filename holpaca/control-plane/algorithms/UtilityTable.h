@@ -0,0 +1,126 @@
+#pragma once
+
+#include <holpaca/control-plane/ProxyManager.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace holpaca {
+
+/**
+ * @brief Dense, slab-granular materialization of per-pool utility curves.
+ *
+ * Evaluating a spline requires a binary search over its knots plus a cubic
+ * evaluation, which dominates the cost of energy evaluations inside the
+ * optimizer. A UtilityTable samples each curve once per control loop at slab
+ * granularity over the pool's feasible range [lowerBound, upperBound], so that
+ * every subsequent evaluation is a single indexed load.
+ *
+ * All curves share one contiguous buffer, which allows the batch evaluation
+ * (sum) to gather the utility of every pool with SIMD instructions.
+ */
+class UtilityTable {
+  /* Number of bits of the sampling step (one entry per CacheLib slab) */
+  static constexpr unsigned kStepBits =
+      ::facebook::cachelib::Slab::kNumSlabBits;
+
+  /* Sampled utility values of all curves, stored back to back */
+  std::vector<double> m_values;
+
+  /* Offset of the first entry of each curve within m_values */
+  std::vector<uint64_t> m_offsets;
+
+  /* Size at which each curve starts being sampled */
+  std::vector<uint64_t> m_lowerBounds;
+
+  /* Number of entries of each curve */
+  std::vector<uint64_t> m_lengths;
+
+  /**
+   * @brief Maps a size to the position of its entry within m_values.
+   */
+  uint64_t index(size_t const kCurve, uint64_t const kSize) const {
+    uint64_t const kStep =
+        (std::max(kSize, m_lowerBounds[kCurve]) - m_lowerBounds[kCurve]) >>
+        kStepBits;
+    return m_offsets[kCurve] + std::min(kStep, m_lengths[kCurve] - 1);
+  }
+
+public:
+  /* Distance, in bytes, between two consecutive entries of a curve */
+  static constexpr uint64_t kStep = uint64_t{1} << kStepBits;
+
+  /**
+   * @brief Samples a curve over [kLowerBound, kUpperBound] and appends it.
+   *
+   * @tparam Curve Callable mapping a size (double) to a utility (double)
+   * @param kCurve Utility curve to sample (e.g., a tk::spline)
+   * @param kLowerBound Smallest size the curve will be evaluated at
+   * @param kUpperBound Largest size the curve will be evaluated at
+   * @return Index of the new curve
+   */
+  template <typename Curve>
+  size_t add(Curve const &kCurve, uint64_t const kLowerBound,
+             uint64_t const kUpperBound) {
+    uint64_t const kLength =
+        ((std::max(kUpperBound, kLowerBound) - kLowerBound) >> kStepBits) + 1;
+
+    m_offsets.push_back(m_values.size());
+    m_lowerBounds.push_back(kLowerBound);
+    m_lengths.push_back(kLength);
+
+    m_values.reserve(m_values.size() + kLength);
+    for (uint64_t i = 0; i < kLength; i++) {
+      m_values.push_back(
+          kCurve(static_cast<double>(kLowerBound + (i << kStepBits))));
+    }
+    return m_offsets.size() - 1;
+  }
+
+  /**
+   * @brief Utility of a curve at the given size (rounded down to a slab).
+   *
+   * Sizes outside the sampled range are clamped to its limits.
+   */
+  double operator()(size_t const kCurve, uint64_t const kSize) const {
+    return m_values[index(kCurve, kSize)];
+  }
+
+  /**
+   * @brief Change in utility of a curve when moving from one size to another.
+   */
+  double delta(size_t const kCurve, uint64_t const kFrom,
+               uint64_t const kTo) const {
+    return m_values[index(kCurve, kTo)] - m_values[index(kCurve, kFrom)];
+  }
+
+  /**
+   * @brief Sums the utility of every curve at the given sizes.
+   *
+   * Uses AVX2 gathers when available. Every size must lie within the range
+   * its curve was sampled over.
+   *
+   * @param kSizes One size per curve, in insertion order
+   * @return Aggregated utility
+   */
+  double sum(uint64_t const *kSizes) const;
+
+  /**
+   * @brief Number of curves in the table.
+   */
+  size_t size() const { return m_offsets.size(); }
+
+  /**
+   * @brief Removes all curves, keeping the allocated memory for reuse.
+   */
+  void clear() {
+    m_values.clear();
+    m_offsets.clear();
+    m_lowerBounds.clear();
+    m_lengths.clear();
+  }
+};
+
+} // namespace holpaca
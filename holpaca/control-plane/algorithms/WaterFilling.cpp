@@ -0,0 +1,101 @@
+#include <holpaca/control-plane/algorithms/WaterFilling.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace holpaca {
+
+/**
+ * @brief Distributes a budget among entries.
+ *
+ * Sweeps the events in increasing level. Between two events the total is
+ * linear in the level (the fixed amount of entries at a bound plus the level
+ * times the weight of the growing entries), so the level meeting the budget
+ * is found in closed form once the sweep passes it.
+ */
+double WaterFilling::solve(std::vector<double> const &kWeights,
+                           std::vector<double> const &kLows,
+                           std::vector<double> const &kHighs,
+                           double const kBudget, std::vector<double> &sizes) {
+  size_t const kEntries = kWeights.size();
+  sizes.resize(kEntries);
+
+  double const kLow = std::accumulate(kLows.begin(), kLows.end(), 0.0);
+  double const kHigh = std::accumulate(kHighs.begin(), kHighs.end(), 0.0);
+
+  // Not even the lower bounds fit: scale them down
+  if (kLow >= kBudget) {
+    double const kScale = kLow > 0 ? kBudget / kLow : 0.0;
+    for (size_t i = 0; i < kEntries; i++) {
+      sizes[i] = kLows[i] * kScale;
+    }
+    return kLow * kScale;
+  }
+
+  // Everyone can be fully satisfied
+  if (kHigh <= kBudget) {
+    sizes = kHighs;
+    return kHigh;
+  }
+
+  // Refresh the event levels, keeping the previous order when possible
+  auto level = [&](size_t const kEntry, bool const kEnter) {
+    return kWeights[kEntry] > 0
+               ? (kEnter ? kLows[kEntry] : kHighs[kEntry]) / kWeights[kEntry]
+               : std::numeric_limits<double>::infinity();
+  };
+  auto const kBefore = [](Event const &a, Event const &b) {
+    return a.m_level < b.m_level ||
+           (a.m_level == b.m_level && a.m_enter && !b.m_enter);
+  };
+
+  if (m_events.size() != 2 * kEntries) {
+    m_events.clear();
+    for (size_t i = 0; i < kEntries; i++) {
+      m_events.push_back(Event{level(i, true), i, true});
+      m_events.push_back(Event{level(i, false), i, false});
+    }
+    std::sort(m_events.begin(), m_events.end(), kBefore);
+  } else {
+    for (auto &event : m_events) {
+      event.m_level = level(event.m_entry, event.m_enter);
+    }
+    for (size_t i = 1; i < m_events.size(); i++) {
+      Event const kEvent = m_events[i];
+      size_t j = i;
+      for (; j > 0 && kBefore(kEvent, m_events[j - 1]); j--) {
+        m_events[j] = m_events[j - 1];
+      }
+      m_events[j] = kEvent;
+    }
+  }
+
+  // Sweep until the total reaches the budget
+  double fixed = kLow, slope = 0.0;
+  double waterLevel = std::numeric_limits<double>::infinity();
+  for (auto const &event : m_events) {
+    if (fixed + slope * event.m_level >= kBudget) {
+      waterLevel = (kBudget - fixed) / slope;
+      break;
+    }
+    if (event.m_enter) {
+      fixed -= kLows[event.m_entry];
+      slope += kWeights[event.m_entry];
+    } else {
+      fixed += kHighs[event.m_entry];
+      slope -= kWeights[event.m_entry];
+    }
+  }
+
+  double total = 0.0;
+  for (size_t i = 0; i < kEntries; i++) {
+    sizes[i] = kWeights[i] > 0
+                   ? std::clamp(waterLevel * kWeights[i], kLows[i], kHighs[i])
+                   : kLows[i];
+    total += sizes[i];
+  }
+  return total;
+}
+
+} // namespace holpaca
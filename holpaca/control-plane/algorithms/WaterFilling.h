@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace holpaca {
+
+/**
+ * @brief Weighted water-filling with lower and upper bounds.
+ *
+ * Finds the level L such that giving every entry clamp(L * weight, low, high)
+ * adds up to the budget. Entries with no weight keep their lower bound.
+ *
+ * The level at which each entry starts and stops growing is kept sorted
+ * between calls. When the same entries are solved again with slightly
+ * different inputs (the common case in a control loop), the order is only
+ * repaired by insertion sort, so a call is linear in the number of entries.
+ */
+class WaterFilling {
+  /**
+   * @brief Level at which an entry leaves its lower or reaches its upper
+   * bound.
+   */
+  struct Event {
+    double m_level; /* Water level of the event */
+    size_t m_entry; /* Position of the entry */
+    bool m_enter;   /* Whether the entry starts (or stops) growing */
+  };
+
+  /* Events of every entry, sorted by level */
+  std::vector<Event> m_events;
+
+public:
+  /**
+   * @brief Distributes a budget among entries.
+   *
+   * If the lower bounds exceed the budget, they are scaled down
+   * proportionally. If the upper bounds do not reach it, every entry gets its
+   * upper bound and the remainder is left unassigned.
+   *
+   * @param kWeights Weight of each entry (non-negative)
+   * @param kLows Lower bound of each entry
+   * @param kHighs Upper bound of each entry (not below its lower bound)
+   * @param kBudget Amount to distribute
+   * @param sizes Output: amount given to each entry
+   * @return Amount actually assigned
+   */
+  double solve(std::vector<double> const &kWeights,
+               std::vector<double> const &kLows,
+               std::vector<double> const &kHighs, double const kBudget,
+               std::vector<double> &sizes);
+
+  /**
+   * @brief Forgets the previous order (e.g., when entries were renumbered).
+   */
+  void reset() { m_events.clear(); }
+};
+
+} // namespace holpaca
@@ -0,0 +1,191 @@
+#include <holpaca/control-plane/algorithms/WeightedShare.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace holpaca {
+
+/**
+ * @brief Constructs the WeightedShare algorithm instance.
+ */
+WeightedShare::WeightedShare(ProxyManager *const kProxyManager,
+                             std::chrono::milliseconds const kPeriodicity,
+                             double const kUtilizationThreshold)
+    : StagedAlgorithm(kProxyManager, kPeriodicity),
+      m_kUtilizationThreshold(kUtilizationThreshold) {}
+
+void WeightedShare::Level::resize(size_t const kEntries) {
+  m_weights.resize(kEntries);
+  m_lows.resize(kEntries);
+  m_caps.resize(kEntries);
+  m_limits.resize(kEntries);
+  m_sizes.resize(kEntries);
+}
+
+/**
+ * @brief Assigns stable positions to the caches and pools in the status.
+ *
+ * New caches and pools are appended. When some disappeared, the remaining
+ * ones of that level are renumbered and its solver starts over.
+ */
+void WeightedShare::updateSlots(
+    std::unordered_map<std::string, ProxyManager::CacheStatus> const
+        &kAllCacheStatus) {
+  // Caches
+  bool const kCacheRemoved = std::any_of(
+      m_cacheIds.begin(), m_cacheIds.end(), [&](std::string const &kId) {
+        return kAllCacheStatus.find(kId) == kAllCacheStatus.end();
+      });
+  if (kCacheRemoved) {
+    std::vector<std::string> cacheIds;
+    for (auto const &cacheId : m_cacheIds) {
+      if (kAllCacheStatus.find(cacheId) == kAllCacheStatus.end()) {
+        m_caches.erase(cacheId);
+      } else {
+        m_caches[cacheId].m_slot = cacheIds.size();
+        cacheIds.push_back(cacheId);
+      }
+    }
+    m_cacheIds = std::move(cacheIds);
+    m_top.m_solver.reset();
+  }
+
+  for (const auto &[cacheId, cacheStatus] : kAllCacheStatus) {
+    auto [it, inserted] = m_caches.try_emplace(cacheId);
+    auto &state = it->second;
+    if (inserted) {
+      state.m_slot = m_cacheIds.size();
+      m_cacheIds.push_back(cacheId);
+    }
+    state.m_maxSize = cacheStatus.m_maxSize;
+
+    // Pools of the cache
+    bool const kPoolRemoved = std::any_of(
+        state.m_poolIds.begin(), state.m_poolIds.end(),
+        [&](PoolId const kId) {
+          return cacheStatus.m_pools.find(kId) == cacheStatus.m_pools.end();
+        });
+    if (kPoolRemoved) {
+      std::vector<PoolId> poolIds;
+      state.m_poolSlots.clear();
+      for (auto const poolId : state.m_poolIds) {
+        if (cacheStatus.m_pools.find(poolId) != cacheStatus.m_pools.end()) {
+          state.m_poolSlots[poolId] = poolIds.size();
+          poolIds.push_back(poolId);
+        }
+      }
+      state.m_poolIds = std::move(poolIds);
+      state.m_pools.m_solver.reset();
+    }
+
+    for (const auto &[poolId, poolStatus] : cacheStatus.m_pools) {
+      if (state.m_poolSlots.try_emplace(poolId, state.m_poolIds.size())
+              .second) {
+        state.m_poolIds.push_back(poolId);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Splits a budget among caches, then among the pools of each.
+ *
+ * Each cache is bounded by the sum of the bounds of its pools, so memory a
+ * cache cannot use flows to the others, and by its capacity, which the
+ * bounds of several pools may add up to more than.
+ */
+void WeightedShare::share(double const kBudget, bool const kUseCaps) {
+  for (const auto &[cacheId, state] : m_caches) {
+    auto const &kPools = state.m_pools;
+    auto const &kHighs = kUseCaps ? kPools.m_caps : kPools.m_limits;
+    m_top.m_limits[state.m_slot] =
+        std::min(std::accumulate(kHighs.begin(), kHighs.end(), 0.0),
+                 state.m_maxSize);
+    m_top.m_lows[state.m_slot] = std::min(
+        std::accumulate(kPools.m_lows.begin(), kPools.m_lows.end(), 0.0),
+        m_top.m_limits[state.m_slot]);
+  }
+  m_top.m_solver.solve(m_top.m_weights, m_top.m_lows, m_top.m_limits,
+                       kBudget, m_top.m_sizes);
+
+  for (auto &[cacheId, state] : m_caches) {
+    auto &pools = state.m_pools;
+    pools.m_solver.solve(pools.m_weights, pools.m_lows,
+                         kUseCaps ? pools.m_caps : pools.m_limits,
+                         m_top.m_sizes[state.m_slot], pools.m_sizes);
+  }
+}
+
+/**
+ * @brief Shares the memory among the pools that use it first and then among
+ * everyone, proposing the resulting sizes.
+ *
+ * Floors raised by earlier stages act as reservations.
+ *
+ * @param kAllCacheStatus Status of all caches, collected for the round
+ * @param allocation Sizes and floors proposed by the previous stages
+ */
+void WeightedShare::apply(
+    std::unordered_map<std::string, ProxyManager::CacheStatus> const
+        &kAllCacheStatus,
+    Allocation &allocation) {
+  if (kAllCacheStatus.empty()) {
+    return;
+  }
+  updateSlots(kAllCacheStatus);
+
+  // Bounds and weights of every cache and pool
+  double totalSize = 0.0;
+  m_top.resize(m_cacheIds.size());
+  for (const auto &[cacheId, cacheStatus] : kAllCacheStatus) {
+    auto &state = m_caches[cacheId];
+    auto &pools = state.m_pools;
+    double const kCapacity = cacheStatus.m_maxSize;
+    totalSize += kCapacity;
+    m_top.m_weights[state.m_slot] = cacheStatus.m_proportion;
+    pools.resize(state.m_poolIds.size());
+
+    for (const auto &[poolId, poolStatus] : cacheStatus.m_pools) {
+      size_t const kSlot = state.m_poolSlots[poolId];
+      double const kLimit =
+          poolStatus.m_limit > 0
+              ? std::min<double>(poolStatus.m_limit, kCapacity)
+              : kCapacity;
+      double const kLow = std::min<double>(
+          std::max(poolStatus.m_reservation, allocation.floor(cacheId, poolId)),
+          kLimit);
+      bool const kIdle =
+          poolStatus.m_maxSize > 0 &&
+          poolStatus.m_usedSize <
+              m_kUtilizationThreshold * poolStatus.m_maxSize;
+
+      pools.m_weights[kSlot] = poolStatus.m_proportion;
+      pools.m_lows[kSlot] = kLow;
+      pools.m_limits[kSlot] = kLimit;
+      pools.m_caps[kSlot] =
+          kIdle ? std::clamp(poolStatus.m_usedSize / m_kUtilizationThreshold,
+                             kLow, kLimit)
+                : kLimit;
+    }
+  }
+
+  // Serve the pools using their memory first, then hand out the remainder
+  share(totalSize, /*kUseCaps=*/true);
+  double const kAssigned =
+      std::accumulate(m_top.m_sizes.begin(), m_top.m_sizes.end(), 0.0);
+  if (kAssigned < totalSize) {
+    for (auto &[cacheId, state] : m_caches) {
+      state.m_pools.m_lows = state.m_pools.m_sizes;
+    }
+    share(totalSize, /*kUseCaps=*/false);
+  }
+
+  for (const auto &[cacheId, state] : m_caches) {
+    for (size_t i = 0; i < state.m_poolIds.size(); i++) {
+      allocation.propose(cacheId, state.m_poolIds[i],
+                         static_cast<uint64_t>(state.m_pools.m_sizes[i]));
+    }
+  }
+}
+
+} // namespace holpaca
@@ -0,0 +1,118 @@
+#pragma once
+#include <holpaca/control-plane/ProxyManager.h>
+#include <holpaca/control-plane/algorithms/PipelineStage.h>
+#include <holpaca/control-plane/algorithms/WaterFilling.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace holpaca {
+
+/**
+ * @brief Hierarchical weighted-share allocation with reservations and limits.
+ *
+ * Memory is first shared among caches by their weight (the cache proportion)
+ * and then, within each cache, among its pools by their weight (the pool
+ * proportion). Every pool receives at least its reservation and at most its
+ * limit (and never more than its cache capacity).
+ *
+ * The allocation is work-conserving: a pool using clearly less than its
+ * current size (idle) is capped at the size that would bring its utilization
+ * to the threshold, and its unused share flows to the pools that do use
+ * their memory. Only when every pool is satisfied is the remainder handed
+ * out by weight regardless of usage.
+ *
+ * Caches and pools keep stable positions between loops, so that each
+ * water-filling is solved incrementally (see WaterFilling).
+ */
+class WeightedShare : public StagedAlgorithm {
+
+  /**
+   * @brief Inputs and solution of one water-filling problem.
+   */
+  struct Level {
+    std::vector<double> m_weights; /* Weight of each entry */
+    std::vector<double> m_lows;    /* Lower bound of each entry */
+    std::vector<double> m_caps;    /* Upper bound of each (idle) entry */
+    std::vector<double> m_limits;  /* Upper bound of each entry */
+    std::vector<double> m_sizes;   /* Size given to each entry */
+    WaterFilling m_solver;         /* Incremental solver */
+
+    /**
+     * @brief Resizes every vector to the given number of entries.
+     */
+    void resize(size_t const kEntries);
+  };
+
+  /**
+   * @brief Allocation state of a cache.
+   */
+  struct CacheState {
+    size_t m_slot{0};      /* Position of the cache in the top level */
+    double m_maxSize{0.0}; /* Capacity of the cache */
+    std::unordered_map<PoolId, size_t> m_poolSlots; /* Position of pools */
+    std::vector<PoolId> m_poolIds; /* Pool at each position */
+    Level m_pools;                 /* Water-filling among its pools */
+  };
+
+  /* Utilization below which a pool is considered idle */
+  double const m_kUtilizationThreshold{0.9};
+
+  /* Allocation state of each cache */
+  std::unordered_map<std::string, CacheState> m_caches;
+
+  /* Cache at each position of the top level */
+  std::vector<std::string> m_cacheIds;
+
+  /* Water-filling among caches */
+  Level m_top;
+
+  /**
+   * @brief Assigns stable positions to the caches and pools in the status,
+   * renumbering only when some disappeared.
+   */
+  void updateSlots(
+      std::unordered_map<std::string, ProxyManager::CacheStatus> const
+          &kAllCacheStatus);
+
+  /**
+   * @brief Splits a budget among caches, then among the pools of each.
+   *
+   * @param kBudget Memory to distribute
+   * @param kUseCaps Whether idle pools are capped at their demand
+   */
+  void share(double const kBudget, bool const kUseCaps);
+
+public:
+  /**
+   * @brief Constructs a WeightedShare algorithm instance.
+   *
+   * @param kProxyManager Pointer to ProxyManager for resizing pools
+   * @param kPeriodicity Time between allocation iterations
+   * @param kUtilizationThreshold Utilization below which a pool is idle
+   */
+  WeightedShare(ProxyManager *const kProxyManager,
+                std::chrono::milliseconds const kPeriodicity,
+                double const kUtilizationThreshold);
+
+  /**
+   * @brief Name of the stage, used when reporting.
+   */
+  std::string name() const override final { return "WeightedShare"; }
+
+  /**
+   * @brief Shares the memory among the pools that use it first and then
+   * among everyone, proposing the resulting sizes.
+   *
+   * @param kAllCacheStatus Status of all caches, collected for the round
+   * @param allocation Sizes and floors proposed by the previous stages
+   */
+  void apply(std::unordered_map<std::string, ProxyManager::CacheStatus> const
+                 &kAllCacheStatus,
+             Allocation &allocation) override final;
+};
+
+} // namespace holpaca
@@ -2,6 +2,10 @@
 #include <holpaca/data-plane/CacheAllocator.h>
 #include <shards/ShardsConfig.h>
 
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
 namespace holpaca {
 
 /**
@@ -19,13 +23,20 @@ CacheAllocator<CacheTrait>::CacheAllocator(Config &config)
       m_kVirtualSize(config.m_hasVirtualSize ? config.m_virtualSize
                                              : config.size),
       // MOTIVATION ONLY: proportion of instance relative to other instances
-      m_kProportion(config.proportion) {
+      m_kProportion(config.proportion),
+      // Change signal of a pool that notifies the orchestrator
+      m_kChangeThreshold(config.m_changeThreshold) {
 
   // Reserve space to avoid reallocations during runtime.
   // CacheLib only supports up to 64 pools per cache instance.
   m_shards.reserve(64);
   m_metrics.reserve(64);
   m_qosLevels.reserve(64);
+  m_latencySLOs.reserve(64);
+  m_sizeBounds.reserve(64);
+  m_allocFailures.reserve(64);
+  m_latencies.reserve(64);
+  m_changeBaselines.reserve(64);
   m_proportions.reserve(64);
 
   // Start gRPC server and connect to orchestrator if both addresses are set
@@ -51,6 +62,7 @@ CacheAllocator<CacheTrait>::CacheAllocator(Config &config)
     ConnectRequest request;
     ConnectResponse response;
     request.set_cacheaddress(m_kAddress);
+    request.set_domain(config.m_domain);
 
     ::grpc::Status status;
 
@@ -59,6 +71,11 @@ CacheAllocator<CacheTrait>::CacheAllocator(Config &config)
       status = m_orchestrator->Connect(&context, request, &response);
       std::this_thread::sleep_for(std::chrono::milliseconds(1000));
     } while (!status.ok());
+
+    // Send change notifications in the background
+    if (m_kChangeThreshold > 0.0) {
+      m_notifierThread = std::thread([this] { notifyChanges(); });
+    }
   }
 }
 
@@ -108,6 +125,16 @@ grpc::Status CacheAllocator<CacheTrait>::Resize(grpc::ServerContext *context,
  */
 template <typename CacheTrait> CacheAllocator<CacheTrait>::~CacheAllocator() {
 
+  // Stop sending change notifications
+  if (m_notifierThread.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(m_notifyMutex);
+      m_stopNotifier = true;
+    }
+    m_notifyChanged.notify_all();
+    m_notifierThread.join();
+  }
+
   // Notify orchestrator that this cache agent is disconnecting
   if (m_orchestrator) {
     ::grpc::ClientContext context;
@@ -164,6 +191,22 @@ CacheAllocator<CacheTrait>::GetStatus(grpc::ServerContext *context,
       // QoS level assigned to this pool
       poolStatus.set_qos(m_qosLevels[poolId]);
 
+      // Latency SLO and latency histograms since the previous request
+      auto &[hitLatency, missLatency] = m_latencies[poolId];
+      auto const hits = hitLatency->drain();
+      auto const misses = missLatency->drain();
+      *poolStatus.mutable_hitlatency() = {hits.begin(), hits.end()};
+      *poolStatus.mutable_misslatency() = {misses.begin(), misses.end()};
+      poolStatus.set_latencyslo(m_latencySLOs[poolId]);
+
+      // Guaranteed and maximum memory of this pool
+      auto const &[reservation, limit] = m_sizeBounds[poolId];
+      poolStatus.set_reservation(reservation);
+      poolStatus.set_limit(limit);
+
+      // Memory pressure since the previous request
+      poolStatus.set_allocfailures(m_allocFailures[poolId].exchange(0));
+
       // MOTIVATION ONLY: proportion assigned to this pool
       poolStatus.set_proportion(m_proportions[poolId]);
 
@@ -180,13 +223,15 @@ CacheAllocator<CacheTrait>::GetStatus(grpc::ServerContext *context,
 }
 
 /**
- * @brief Adds a new cache pool with optional size, QoS, and proportion.
+ * @brief Adds a new cache pool with optional size, QoS, proportion, and
+ * latency SLO.
  *
  * Also initializes a SHARDS MRC generator for the pool.
  */
 template <typename CacheTrait>
 PoolId CacheAllocator<CacheTrait>::addPool(std::string name, size_t size,
-                                           double qosLevel, double proportion) {
+                                           double qosLevel, double proportion,
+                                           double latencySLO) {
 
   // Create a new CacheLib pool (blocks until enough memory is available if size
   // != 0)
@@ -201,6 +246,12 @@ PoolId CacheAllocator<CacheTrait>::addPool(std::string name, size_t size,
   m_qosLevels[poolId] = qosLevel;
   m_metrics[poolId] = {0, 1.0, 0}; // diskIOPS, missRatio, throughput
   m_proportions[poolId] = proportion;
+  m_latencySLOs[poolId] = latencySLO;
+  m_sizeBounds[poolId] = {0, 0};
+  m_allocFailures[poolId] = 0;
+  m_latencies[poolId] = {std::make_shared<LatencyHistogram>(),
+                         std::make_shared<LatencyHistogram>()};
+  m_changeBaselines[poolId] = {{}, 0};
   m_activePools.insert(poolId);
 
   return poolId;
@@ -229,6 +280,24 @@ CacheAllocator<CacheTrait>::find(typename CacheAllocator<CacheTrait>::Key key) {
   return handle;
 }
 
+/**
+ * @brief Intercepts the allocate operation and counts failed allocations.
+ */
+template <typename CacheTrait>
+typename CacheAllocator<CacheTrait>::WriteHandle
+CacheAllocator<CacheTrait>::allocate(
+    PoolId poolId, typename CacheAllocator<CacheTrait>::Key key,
+    uint32_t size, uint32_t ttlSecs, uint32_t creationTime) {
+  auto handle = Super::allocate(poolId, key, size, ttlSecs, creationTime);
+
+  // The pool could not make room for the object
+  if (!handle) {
+    m_allocFailures[poolId].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  return handle;
+}
+
 /**
  * @brief Intercepts insert operation and updates shard statistics.
  */
@@ -285,6 +354,13 @@ CacheAllocator<CacheTrait>::insertOrReplace(
 
 /**
  * @brief Registers runtime metrics for a given pool.
+ *
+ * The change signal is the largest of the mean absolute difference between
+ * the current MRC and the one at the previous notification (at the points of
+ * the current one) and the relative change of the throughput since then.
+ * Crossing the threshold resets the baseline and queues a notification for
+ * the notifier thread; the orchestrator then reallocates the domain right
+ * away. The status path thus never waits on an RPC.
  */
 template <typename CacheTrait>
 void CacheAllocator<CacheTrait>::registerMetrics(PoolId poolId,
@@ -292,6 +368,108 @@ void CacheAllocator<CacheTrait>::registerMetrics(PoolId poolId,
                                                  double missRatio,
                                                  uint32_t throughput) {
   m_metrics[poolId] = {diskIOPS, missRatio, throughput};
+
+  if (!m_orchestrator || m_kChangeThreshold <= 0.0) {
+    return;
+  }
+
+  // Change since the previous notification
+  auto &[baselineMRC, baselineThroughput] = m_changeBaselines[poolId];
+  auto const &mrc = m_shards[poolId]->byteMRC();
+  double change =
+      std::abs(static_cast<double>(throughput) - baselineThroughput) /
+      std::max<double>(baselineThroughput, 1.0);
+  double drift = 0.0;
+  size_t points = 0;
+  for (const auto &[size, ratio] : mrc) {
+    double baseline = 1.0;
+    if (!baselineMRC.empty()) {
+      auto const kNext = baselineMRC.lower_bound(size);
+      baseline = kNext == baselineMRC.end() ? std::prev(kNext)->second
+                                            : kNext->second;
+    }
+    drift += std::abs(ratio - baseline);
+    points++;
+  }
+  if (points > 0) {
+    change = std::max(change, drift / points);
+  }
+  if (change < m_kChangeThreshold) {
+    return;
+  }
+  baselineMRC = {mrc.begin(), mrc.end()};
+  baselineThroughput = throughput;
+
+  // Leave the RPC to the notifier thread, keeping the largest change
+  {
+    std::lock_guard<std::mutex> lock(m_notifyMutex);
+    auto &pending = m_pendingChanges[poolId];
+    pending = std::max(pending, change);
+  }
+  m_notifyChanged.notify_one();
+}
+
+/**
+ * @brief Loop of the notifier thread.
+ *
+ * Waits for pending changes and sends them in one Notify RPC, without
+ * holding the lock, so the callers of registerMetrics never wait on the
+ * orchestrator. Changes registered meanwhile are sent in the next RPC.
+ */
+template <typename CacheTrait>
+void CacheAllocator<CacheTrait>::notifyChanges() {
+  std::unique_lock<std::mutex> lock(m_notifyMutex);
+  while (!m_stopNotifier) {
+    if (m_pendingChanges.empty()) {
+      m_notifyChanged.wait(lock);
+      continue;
+    }
+    std::unordered_map<PoolId, double> changes;
+    changes.swap(m_pendingChanges);
+    lock.unlock();
+
+    ::grpc::ClientContext context;
+    context.set_deadline(std::chrono::system_clock::now() +
+                         std::chrono::milliseconds(100));
+    NotifyRequest request;
+    NotifyResponse response;
+    request.set_cacheaddress(m_kAddress);
+    for (const auto &[poolId, change] : changes) {
+      (*request.mutable_changes())[poolId] = change;
+    }
+    m_orchestrator->Notify(&context, request, &response);
+
+    lock.lock();
+  }
+}
+
+/**
+ * @brief Records the latency of a read in the pool's hit or miss histogram.
+ */
+template <typename CacheTrait>
+void CacheAllocator<CacheTrait>::recordLatency(
+    PoolId poolId, bool hit, std::chrono::nanoseconds latency) {
+  auto const &[hitLatency, missLatency] = m_latencies[poolId];
+  (hit ? hitLatency : missLatency)->record(latency);
+}
+
+/**
+ * @brief Sets the target p99 read latency of a given pool.
+ */
+template <typename CacheTrait>
+void CacheAllocator<CacheTrait>::setLatencySLO(PoolId poolId,
+                                               double latencySLO) {
+  m_latencySLOs[poolId] = latencySLO;
+}
+
+/**
+ * @brief Sets the guaranteed and maximum memory of a given pool.
+ */
+template <typename CacheTrait>
+void CacheAllocator<CacheTrait>::setSizeBounds(PoolId poolId,
+                                               uint64_t reservation,
+                                               uint64_t limit) {
+  m_sizeBounds[poolId] = {reservation, limit};
 }
 
 /**
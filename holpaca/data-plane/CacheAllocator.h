@@ -11,13 +11,18 @@
 
 // Holpaca-specific configuration and protobuf definitions
 #include <holpaca/data-plane/CacheAllocatorConfig.h>
+#include <holpaca/data-plane/LatencyHistogram.h>
 #include <holpaca/protos/Holpaca.grpc.pb.h>
 #include <holpaca/protos/Holpaca.pb.h>
 
 // MRC generation
 #include <shards/Shards.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <map>
 #include <mutex>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -55,6 +60,27 @@ class CacheAllocator : public ::facebook::cachelib::CacheAllocator<CacheTrait>,
   /* Address this agent listens on */
   std::string const m_kAddress;
 
+  /* Background thread sending the change notifications */
+  std::thread m_notifierThread;
+
+  /* Change signal of each pool waiting to be notified */
+  std::unordered_map<PoolId, double> m_pendingChanges;
+
+  /* Flag to signal the notifier thread to stop */
+  bool m_stopNotifier{false};
+
+  /* Protects the pending changes and the stop flag */
+  std::mutex m_notifyMutex;
+
+  /* Signaled when a change is pending, or on stop */
+  std::condition_variable m_notifyChanged;
+
+  /**
+   * @brief Loop of the notifier thread: sends the pending changes to the
+   * orchestrator, off the path of the metrics registration.
+   */
+  void notifyChanges();
+
   /**
    * @brief Handles GetStatus RPC requests from the orchestrator.
    */
@@ -94,6 +120,24 @@ class CacheAllocator : public ::facebook::cachelib::CacheAllocator<CacheTrait>,
   /* Minimum throughput demand per pool */
   std::unordered_map<PoolId, double> m_qosLevels;
 
+  /* Target p99 read latency (microseconds) per pool */
+  std::unordered_map<PoolId, double> m_latencySLOs;
+
+  /* Guaranteed and maximum memory (bytes, 0 = none) per pool */
+  std::unordered_map<PoolId, std::pair<uint64_t, uint64_t>> m_sizeBounds;
+
+  /* Allocations that failed since the last status request per pool */
+  std::unordered_map<PoolId, std::atomic<uint64_t>> m_allocFailures;
+
+  /* Latency histograms of cache hits and misses per pool */
+  std::unordered_map<PoolId, std::pair<std::shared_ptr<LatencyHistogram>,
+                                       std::shared_ptr<LatencyHistogram>>>
+      m_latencies;
+
+  /* MRC and throughput per pool at its last change notification */
+  std::unordered_map<PoolId, std::pair<std::map<uint64_t, double>, uint32_t>>
+      m_changeBaselines;
+
   /* Motivation algorithm: proportion each pool should get within the cache */
   std::unordered_map<PoolId, double> m_proportions;
 
@@ -103,6 +147,9 @@ class CacheAllocator : public ::facebook::cachelib::CacheAllocator<CacheTrait>,
   /* Motivation-only: proportion of this instance relative to others */
   double const m_kProportion{1.0};
 
+  /* Change signal of a pool that notifies the orchestrator (0 = never) */
+  double const m_kChangeThreshold{0.0};
+
 public:
   /* Type of allocator configuration */
   using Config = CacheAllocatorConfig<CacheAllocator<CacheTrait>>;
@@ -136,10 +183,11 @@ public:
    * @param size Optional size of the pool
    * @param qosLevel Optional minimum throughput requirement
    * @param proportion Optional proportional allocation (for Motivation)
+   * @param latencySLO Optional target p99 read latency (microseconds)
    * @return PoolId Identifier of the created pool
    */
   PoolId addPool(std::string name, size_t size = 0, double qosLevel = 0.0,
-                 double proportion = 1.0);
+                 double proportion = 1.0, double latencySLO = 0.0);
 
   /**
    * @brief Intercepts the find operation of the underlying CacheLib allocator.
@@ -150,6 +198,21 @@ public:
    */
   ReadHandle find(Key key);
 
+  /**
+   * @brief Intercepts the allocate operation of the underlying CacheLib
+   * allocator.
+   *
+   * @param poolId Pool to allocate from
+   * @param key Key of the new object
+   * @param size Size of the object's value
+   * @param ttlSecs Optional time-to-live of the object
+   * @param creationTime Optional creation time of the object
+   * @return WriteHandle Handle to the allocated memory
+   *    or nullptr if the allocation failed
+   */
+  WriteHandle allocate(PoolId poolId, Key key, uint32_t size,
+                       uint32_t ttlSecs = 0, uint32_t creationTime = 0);
+
   /**
    * @brief Intercepts the insert operation of the underlying CacheLib
    * allocator.
@@ -170,6 +233,11 @@ public:
   /**
    * @brief Registers performance metrics for a pool.
    *
+   * When a change threshold is configured, also compares the pool's MRC and
+   * throughput with those at its previous notification and, if they changed
+   * significantly, queues a notification to the orchestrator (sent by a
+   * background thread).
+   *
    * @param poolId Pool identifier
    * @param diskIOPS Disk I/O operations per second
    * @param missRatio Cache miss ratio
@@ -178,6 +246,32 @@ public:
   void registerMetrics(PoolId poolId, uint32_t diskIOPS, double missRatio,
                        uint32_t throughput);
 
+  /**
+   * @brief Records the end-to-end latency of a read served by a pool.
+   *
+   * @param poolId Pool identifier
+   * @param hit Whether the read was served from the cache
+   * @param latency Latency of the read, including the backend access on misses
+   */
+  void recordLatency(PoolId poolId, bool hit, std::chrono::nanoseconds latency);
+
+  /**
+   * @brief Sets the target p99 read latency of a pool.
+   *
+   * @param poolId Pool identifier
+   * @param latencySLO Target p99 read latency (microseconds), 0 to disable
+   */
+  void setLatencySLO(PoolId poolId, double latencySLO);
+
+  /**
+   * @brief Sets the memory guaranteed to and the maximum memory of a pool.
+   *
+   * @param poolId Pool identifier
+   * @param reservation Guaranteed memory in bytes, 0 for none
+   * @param limit Maximum memory in bytes, 0 for unlimited
+   */
+  void setSizeBounds(PoolId poolId, uint64_t reservation, uint64_t limit);
+
   /**
    * @brief Removes a cache pool and cleans up associated state.
    *
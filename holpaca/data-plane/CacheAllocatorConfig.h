@@ -17,6 +17,12 @@ class CacheAllocatorConfig
   // Address of the orchestrator gRPC endpoint
   std::string m_orchestratorAddress;
 
+  // Control domain declared to the orchestrator (empty for the default one)
+  std::string m_domain;
+
+  // Change signal of a pool that triggers a notification (0 = never)
+  double m_changeThreshold{0.0};
+
   // Cache size exposed to the orchestrator
   int64_t m_virtualSize;
 
@@ -39,6 +45,19 @@ public:
     return *this;
   }
 
+  // Sets the control domain declared to the orchestrator
+  CacheAllocatorConfig &setDomain(std::string domain) {
+    m_domain = domain;
+    return *this;
+  }
+
+  // Sets the change signal of a pool (largest of its mean absolute MRC change
+  // and relative throughput change) that notifies the orchestrator
+  CacheAllocatorConfig &setChangeThreshold(double threshold) {
+    m_changeThreshold = threshold;
+    return *this;
+  }
+
   // Sets the virtual size exposed to the orchestrator
   CacheAllocatorConfig &setVirtualSize(uint64_t size) {
     m_hasVirtualSize = true;
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+
+namespace holpaca {
+
+/**
+ * @brief Lock-free latency histogram with log-linear buckets.
+ *
+ * Latencies are recorded in microseconds. Each power of two is split into
+ * kSubBuckets linear buckets, which bounds the relative error of any bucket
+ * to 1 / kSubBuckets (~3%, tight enough for the tail latencies controlled by
+ * LatencySLO). Only non-empty buckets are shipped to the orchestrator.
+ */
+class LatencyHistogram {
+  /* Number of linear buckets per power of two */
+  static constexpr unsigned kSubBucketBits = 5;
+  static constexpr uint64_t kSubBuckets = uint64_t{1} << kSubBucketBits;
+
+  /* Largest power of two covered by the histogram (~12.7 days) */
+  static constexpr unsigned kMaxExponent = 40;
+
+  /* Total number of buckets */
+  static constexpr size_t kBuckets =
+      kSubBuckets + (kMaxExponent - kSubBucketBits) * kSubBuckets;
+
+  /* Number of operations recorded in each bucket */
+  std::array<std::atomic<uint64_t>, kBuckets> m_counts{};
+
+  /**
+   * @brief Bucket holding the given latency (in microseconds).
+   */
+  static size_t bucket(uint64_t const kLatency) {
+    if (kLatency < kSubBuckets) {
+      return kLatency;
+    }
+    unsigned const kExponent = 63 - __builtin_clzll(kLatency);
+    if (kExponent >= kMaxExponent) {
+      return kBuckets - 1;
+    }
+    uint64_t const kSub =
+        (kLatency >> (kExponent - kSubBucketBits)) & (kSubBuckets - 1);
+    return kSubBuckets + (kExponent - kSubBucketBits) * kSubBuckets + kSub;
+  }
+
+  /**
+   * @brief Exclusive upper bound (in microseconds) of a bucket.
+   */
+  static uint64_t upperBound(size_t const kBucket) {
+    if (kBucket < kSubBuckets) {
+      return kBucket + 1;
+    }
+    uint64_t const kExponent =
+        (kBucket - kSubBuckets) / kSubBuckets + kSubBucketBits;
+    uint64_t const kSub = (kBucket - kSubBuckets) % kSubBuckets;
+    return (kSubBuckets + kSub + 1) << (kExponent - kSubBucketBits);
+  }
+
+public:
+  /**
+   * @brief Records one operation with the given latency.
+   */
+  void record(std::chrono::nanoseconds const kLatency) {
+    auto const kMicros =
+        std::chrono::duration_cast<std::chrono::microseconds>(kLatency);
+    m_counts[bucket(kMicros.count() > 0 ? kMicros.count() : 0)].fetch_add(
+        1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Returns the non-empty buckets and resets the histogram.
+   *
+   * @return Map from bucket upper bound (microseconds) to number of operations
+   */
+  std::map<uint64_t, uint64_t> drain() {
+    std::map<uint64_t, uint64_t> counts;
+    for (size_t i = 0; i < kBuckets; i++) {
+      if (uint64_t const kCount =
+              m_counts[i].exchange(0, std::memory_order_relaxed)) {
+        counts.emplace(upperBound(i), kCount);
+      }
+    }
+    return counts;
+  }
+};
+
+} // namespace holpaca